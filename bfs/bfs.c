@@ -6,6 +6,7 @@
 #include <stdbool.h>
 
 #include "include/modelutils.h"
+#include "../path_oracle/path_oracle.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -31,9 +32,9 @@ model_t model =
 #define DEFAULT_START_TIME 0
 #define PERIOD 1000000000
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
 	node_data->overhead)
@@ -48,13 +49,6 @@ model_t model =
 
 typedef enum {HELLO_PACKET, D_PACKET} packet_e;
 
-//visited node data
-typedef struct
-{
-    nodeid_t this;
-    nodeid_t prev;
-}visited_node_t;
-
 //Routing Header
 typedef struct
 {
@@ -75,6 +69,7 @@ typedef struct
 typedef struct
 {
     float scale_postscript;
+    path_oracle *oracle;
 }entity_data_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,8 +82,8 @@ int unsetnode(call_t *call);
 int bootstrap(call_t *call);
 int set_header(call_t *call, packet_t *packet, destination_t *dest);
 void* get_shortest_path(call_t *call, destination_t *dest);
-bool check_in_visited(void *visited, destination_t *to_check);
-visited_node_t* get_node(void *visited, nodeid_t to_get);
+bool in_region(nodeid_t node, void *region);
+void* oracle_nbrs(call_t *call);
 int get_header_size(call_t *call);
 int get_header_real_size(call_t *call);
 int hello_callback(call_t *call, void* args);
@@ -121,6 +116,15 @@ int init(call_t *call, void *params)
     entity_data->scale_postscript = 1700.0 / (topo_pos->x + 20);
 #endif
 
+    if((entity_data->oracle = create_path_oracle(ORACLE_HOPS,
+	oracle_nbrs)) == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate path oracle\nError in routing"
+	    " module\n");
+	free(entity_data);
+	return ERROR;
+    }
+
     set_entity_private_data(call, entity_data);
 
 #ifdef LOG_TOPO_G
@@ -145,6 +149,7 @@ int destroy(call_t *call)
     topo_post_axes(call);
 #endif
 
+    path_oracle_destroy(entity_data->oracle);
     free(entity_data);
     entity_data = NULL;
     return 0;
@@ -256,149 +261,34 @@ int set_header(call_t *call, packet_t *packet, destination_t *dest)
 
 void* get_shortest_path(call_t *call, destination_t *dest)
 {
-    node_data_t *node_data = NODE_DATA(call);
-    call_t call_next = *call;
-    destination_t *tmp = NULL;
-    visited_node_t *tmp1 = NEW(visited_node_t), *tmp2 = NULL,
-	*new = NEW(visited_node_t), *last_found = NEW(visited_node_t);
-    void *visited = das_create(), *to_check = das_create();
-    int num_targets = 0, num_found = 0, i;
-
-    for(i = 0; i < get_node_count(); ++i)
-    {
-	if(i == call->node)
-	    continue;
-	destination_t tmp_dest = {i, *get_node_position(i)};
-
-	if(tmp_dest.position.x >= dest->position.x - 1 &&
-	   tmp_dest.position.x <= dest->position.x + 1 &&
-	   tmp_dest.position.y >= dest->position.y - 1 &&
-	   tmp_dest.position.y <= dest->position.y + 1)
-	    ++num_targets;
-    }
-
-    //add source node to lists as top of tree
-    tmp1->this = call->node;
-    tmp1->prev = NONE;
-    *new = *tmp1;
-    das_insert(to_check, (void*)tmp1);
-    tmp1 = NEW(visited_node_t);
-    *tmp1 = *new;
-    das_insert(visited, (void*)tmp1);
-    new->this = NONE;
-    *last_found = *new;
-
-    //keep looping while containter not empty
-    while(das_getsize(to_check) != 0)
-    {
-	//while there are nodes in to_check
-	das_init_traverse(to_check);
-	while((tmp1 = (visited_node_t*)das_traverse(to_check)) != NULL)
-	{
-	    if(tmp2 != NULL)
-	    {
-		das_delete(to_check, (void*)tmp2);
-		tmp2 = NULL;
-	    }
-	    if(das_getsize(to_check) == 0)
-		break;
-	    call_next.node = tmp1->this;
-	    node_data = NODE_DATA(&call_next);
-
-	    //check each nodes neighbor list
-	    das_init_traverse(node_data->nbrs);
-	    while((tmp = (destination_t*)das_traverse(node_data->nbrs))
-		!= NULL)
-	    {
-		if(!check_in_visited(visited, tmp))
-		{
-		    new->this = tmp->id;
-		    new->prev = tmp1->this;
-		    if(tmp->position.x >= dest->position.x - 1 &&
-	   		tmp->position.x <= dest->position.x + 1 &&
-	   		tmp->position.y >= dest->position.y - 1 &&
-	   		tmp->position.y <= dest->position.y + 1)
-		    {
-			*last_found = *new;
-	   		++num_found;
-		    }
-		    if(num_found == num_targets)
-			break;
-		    tmp2 = new;		
-		    das_insert(visited, (void*)new);
-		    new = NEW(visited_node_t);
-		    *new = *tmp2;
-		    das_insert(to_check, (void*)new);
-		    new = NEW(visited_node_t);
-		    tmp2 = NULL;
-		}
-	    }
-	    if(num_found == num_targets)
-		break;
-	    tmp2 = tmp1;
-	}
-	if(num_found == num_targets)
-	    break;
-    }
+    entity_data_t *entity_data = ENTITY_DATA(call);
+    nodeid_t target = path_oracle_find_last(entity_data->oracle, call,
+	in_region, (void*)dest);
 
-    //create path structure
-    if(last_found->this == NONE)
+    if(target == ORACLE_NO_NODE)
 	return NULL;
-    void* path = das_create();
-    nodeid_t* next = NEW(nodeid_t);
-    *next = last_found->this;
-    das_insert(path, (void*)next);
-    while((last_found = get_node(visited, last_found->prev)) != NULL)
-    {
-	if(last_found->this != call->node)
-	{
-	    next = NEW(int);
-	    *next = last_found->this;
-	    das_insert(path, (void*)next);
-	}
-    }
-
-    //deallocate used memory
-    while((new = (visited_node_t*)das_pop(to_check)) != NULL)
-	free(new);
-    das_destroy(to_check);
-    while((new = (visited_node_t*)das_pop(to_check)) != NULL)
-	free(new);
-    das_destroy(visited);
-    to_check = NULL;
-    visited = NULL;
-
-fprintf(stderr, "[ERR] printing path: ");
-das_init_traverse(path);
-nodeid_t *id = NULL;
-while((id = (nodeid_t*)das_traverse(path)) != NULL)
-fprintf(stderr, "%d, ", *id);
-fprintf(stderr, "\n");
-
-    return path;
+    return path_oracle_get_path(entity_data->oracle, call, target);
 }
 
-bool check_in_visited(void* visited, destination_t *to_check)
+//true if node lies in the geocast region centered on region
+bool in_region(nodeid_t node, void *region)
 {
-    visited_node_t *tmp = NULL;
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-	if(to_check->id == tmp->this)
-	    return true;
-    return false;
+    destination_t *dest = (destination_t*)region;
+    position_t *pos = get_node_position(node);
+
+    return pos->x >= dest->position.x - 1 &&
+	pos->x <= dest->position.x + 1 &&
+	pos->y >= dest->position.y - 1 &&
+	pos->y <= dest->position.y + 1;
 }
 
-visited_node_t* get_node(void* visited, nodeid_t to_get)
+//neighbor list the path oracle grows its trees over
+void* oracle_nbrs(call_t *call)
 {
-    visited_node_t *tmp = NULL;
-
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-    {
-	if(tmp->this == to_get)
-	    return tmp;
-    }
-    return NULL;
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->nbrs;
 }
 
 //exported and used by application layer to gt necessary size for packet
@@ -454,13 +344,14 @@ int hello_callback(call_t *call, void *args)
     header->sender = my_pos;
     header->type = HELLO_PACKET;
 
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
 void add_to_nbr(call_t *call, packet_t *packet)
 {
     node_data_t *node_data = NODE_DATA(call);
+    entity_data_t *entity_data = ENTITY_DATA(call);
     header_t *header = PACKET_HEADER(packet, node_data);
     destination_t *tmp = NULL;
 
@@ -475,6 +366,7 @@ void add_to_nbr(call_t *call, packet_t *packet)
     tmp = NEW(destination_t);
     *tmp = header->sender;
     das_insert(node_data->nbrs, (void*)tmp);
+    path_oracle_invalidate(entity_data->oracle);
     return;
 }
 
@@ -501,7 +393,7 @@ void tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 
 #ifdef LOG_ROUTING
     PRINT_ROUTING("[RTG] sending optimal path packet from %d to %d\n",
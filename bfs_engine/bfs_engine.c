@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include "bfs_engine.h"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+#define BFS_WORDS(cnt) (((cnt) + BFS_WORD_BITS - 1) / BFS_WORD_BITS)
+#define BFS_TEST(bfs, node) (((bfs)->visited[(node) / BFS_WORD_BITS] >> \
+	((node) % BFS_WORD_BITS)) & 1)
+#define BFS_SET(bfs, node) ((bfs)->visited[(node) / BFS_WORD_BITS] |= \
+	(uint64_t)1 << ((node) % BFS_WORD_BITS))
+
+//---------------------------------------------------------------------
+// * Lazy Sizing
+//---------------------------------------------------------------------
+// Node count is only known once the simulation is configured, so the
+// arrays are sized on the first run.
+//---------------------------------------------------------------------
+static bool bfs_engine_reserve(bfs_engine* bfs){
+    if(bfs->visited != NULL) return true;
+
+    int n = get_node_count();
+    bfs->visited = malloc(BFS_WORDS(n) * sizeof(uint64_t));
+    bfs->queue = malloc(n * sizeof(nodeid_t));
+    bfs->prev = malloc(n * sizeof(nodeid_t));
+    bfs->hops = malloc(n * sizeof(int));
+    if(bfs->visited == NULL || bfs->queue == NULL || bfs->prev == NULL ||
+	bfs->hops == NULL){
+	free(bfs->visited);
+	free(bfs->queue);
+	free(bfs->prev);
+	free(bfs->hops);
+	bfs->visited = NULL;
+	bfs->queue = NULL;
+	bfs->prev = NULL;
+	bfs->hops = NULL;
+	return false;
+    }
+    bfs->node_cnt = n;
+
+    return true;
+}
+
+//=====================================================================
+// - Creation/destruction
+
+//---------------------------------------------------------------------
+// * Create BFS Engine
+//---------------------------------------------------------------------
+// Allocates an engine traversing the das returned by get_nbrs (e.g.
+// nbrs or gg_list from the node data).
+//---------------------------------------------------------------------
+bfs_engine* create_bfs_engine(bfs_nbrs_func get_nbrs){
+    bfs_engine* bfs = NEW(bfs_engine);
+    if(bfs == NULL) return NULL;
+
+    bfs->get_nbrs = get_nbrs;
+    bfs->node_cnt = 0;
+    bfs->visited = NULL;
+    bfs->queue = NULL;
+    bfs->prev = NULL;
+    bfs->hops = NULL;
+    bfs->reached = 0;
+
+    return bfs;
+}
+
+//---------------------------------------------------------------------
+// * Destroy BFS Engine
+//---------------------------------------------------------------------
+void bfs_engine_destroy(bfs_engine* bfs){
+    if(bfs == NULL) return;
+
+    free(bfs->visited);
+    free(bfs->queue);
+    free(bfs->prev);
+    free(bfs->hops);
+    free(bfs);
+}
+
+//=====================================================================
+// - Traversal
+
+//---------------------------------------------------------------------
+// * Run
+//---------------------------------------------------------------------
+// Breadth-first search from every live node in 'sources' at once over
+// live nodes. With a NULL 'match' the whole component is explored and
+// the last node discovered is returned. Otherwise the search stops as
+// soon as every live non-source node accepted by 'match' is reached
+// and the last one found is returned (BFS_NO_NODE if none was).
+//---------------------------------------------------------------------
+nodeid_t bfs_run(bfs_engine* bfs, call_t *call, nodeid_t* sources,
+    int num_sources, bfs_match_func match, void *arg){
+    if(bfs == NULL || !bfs_engine_reserve(bfs)) return BFS_NO_NODE;
+
+    int n = bfs->node_cnt, head = 0, num_targets = 0, num_found = 0, i;
+    nodeid_t last = BFS_NO_NODE;
+    call_t call_next = *call;
+    destination_t *nbr = NULL;
+
+    memset(bfs->visited, 0, BFS_WORDS(n) * sizeof(uint64_t));
+    bfs->reached = 0;
+
+    for(i = 0; i < num_sources; i++){
+	nodeid_t s = sources[i];
+	if(s < 0 || s >= n || BFS_TEST(bfs, s) || !is_node_alive(s))
+	    continue;
+	BFS_SET(bfs, s);
+	bfs->prev[s] = BFS_NO_NODE;
+	bfs->hops[s] = 0;
+	bfs->queue[bfs->reached++] = s;
+    }
+
+    if(match != NULL){
+	for(i = 0; i < n; i++)
+	    if(!BFS_TEST(bfs, i) && is_node_alive(i) && match(i, arg))
+		num_targets++;
+	if(num_targets == 0) return BFS_NO_NODE;
+    }
+
+    while(head < bfs->reached){
+	nodeid_t u = bfs->queue[head++];
+
+	call_next.node = u;
+	void *nbrs = bfs->get_nbrs(&call_next);
+	if(nbrs == NULL) continue;
+
+	das_init_traverse(nbrs);
+	while((nbr = (destination_t*)das_traverse(nbrs)) != NULL){
+	    nodeid_t v = nbr->id;
+	    if(v < 0 || v >= n || BFS_TEST(bfs, v) || !is_node_alive(v))
+		continue;
+
+	    BFS_SET(bfs, v);
+	    bfs->prev[v] = u;
+	    bfs->hops[v] = bfs->hops[u] + 1;
+	    bfs->queue[bfs->reached++] = v;
+
+	    if(match == NULL)
+		last = v;
+	    else if(match(v, arg)){
+		last = v;
+		if(++num_found == num_targets) return last;
+	    }
+	}
+    }
+
+    return last;
+}
+
+//=====================================================================
+// - Results of the last run
+
+//---------------------------------------------------------------------
+// * Reached
+//---------------------------------------------------------------------
+// True if the last run discovered 'node' (sources included).
+//---------------------------------------------------------------------
+bool bfs_reached(bfs_engine* bfs, nodeid_t node){
+    if(bfs == NULL || bfs->visited == NULL || node < 0 ||
+	node >= bfs->node_cnt) return false;
+
+    return BFS_TEST(bfs, node);
+}
+
+//---------------------------------------------------------------------
+// * Hop Count
+//---------------------------------------------------------------------
+// Hops from the nearest source or -1 if 'node' was not reached.
+//---------------------------------------------------------------------
+int bfs_hops(bfs_engine* bfs, nodeid_t node){
+    if(!bfs_reached(bfs, node)) return -1;
+
+    return bfs->hops[node];
+}
+
+//---------------------------------------------------------------------
+// * Parent
+//---------------------------------------------------------------------
+// Node 'node' was discovered from, BFS_NO_NODE for sources and nodes
+// not reached.
+//---------------------------------------------------------------------
+nodeid_t bfs_prev(bfs_engine* bfs, nodeid_t node){
+    if(!bfs_reached(bfs, node)) return BFS_NO_NODE;
+
+    return bfs->prev[node];
+}
+
+//---------------------------------------------------------------------
+// * Path
+//---------------------------------------------------------------------
+// Returns a das of nodeid_t* from the hop after the source that
+// reached 'target' up to 'target', so that das_pop yields hops in
+// order, or NULL if 'target' was not reached or is a source.
+//---------------------------------------------------------------------
+void* bfs_get_path(bfs_engine* bfs, nodeid_t target){
+    if(!bfs_reached(bfs, target) || bfs->prev[target] == BFS_NO_NODE)
+	return NULL;
+
+    void* path = das_create();
+    if(path == NULL) return NULL;
+
+    while(bfs->prev[target] != BFS_NO_NODE){
+	nodeid_t* next = NEW(nodeid_t);
+	*next = target;
+	das_insert(path, (void*)next);
+	target = bfs->prev[target];
+    }
+
+    return path;
+}
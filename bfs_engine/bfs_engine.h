@@ -0,0 +1,60 @@
+//=====================================================================
+// ** BFS Engine
+//=====================================================================
+// Reusable breadth-first search over a routing module's neighbor
+// tables. The visited set is a bitset and the frontier is a flat
+// array queue, so a traversal only clears node_cnt / 64 words and
+// never scans a list to test membership. A run may start from several
+// sources at once (every member of a geocast region, for instance)
+// and may stop as soon as every node accepted by a target predicate
+// has been reached, so one traversal serves a whole region.
+//=====================================================================
+#ifndef __bfs_engine__
+#define __bfs_engine__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+#define BFS_NO_NODE -2
+#define BFS_WORD_BITS 64
+
+//---------------------------------------------------------------------
+// * Returns the das of destination_t* neighbors of call->node
+
+typedef void* (*bfs_nbrs_func)(call_t *call);
+
+//---------------------------------------------------------------------
+// * Target predicate
+
+typedef bool (*bfs_match_func)(nodeid_t node, void *arg);
+
+//---------------------------------------------------------------------
+// * BFS engine main data structure
+
+typedef struct{
+    bfs_nbrs_func	get_nbrs;
+    int			node_cnt;
+    uint64_t*		visited;
+    nodeid_t*		queue;
+    nodeid_t*		prev;
+    int*		hops;
+    int			reached;
+} bfs_engine;
+
+//-----------------------------------
+// - BFS Engine Methods
+//-----------------------------------
+bfs_engine*	create_bfs_engine(bfs_nbrs_func get_nbrs);
+void		bfs_engine_destroy(bfs_engine* bfs);
+
+// - Traversal
+nodeid_t	bfs_run(bfs_engine* bfs, call_t *call, nodeid_t* sources,
+		    int num_sources, bfs_match_func match, void *arg);
+
+// - Results of the last run
+bool		bfs_reached(bfs_engine* bfs, nodeid_t node);
+int		bfs_hops(bfs_engine* bfs, nodeid_t node);
+nodeid_t	bfs_prev(bfs_engine* bfs, nodeid_t node);
+void*		bfs_get_path(bfs_engine* bfs, nodeid_t target);
+
+#endif //__bfs_engine__
@@ -6,6 +6,8 @@
 #include <stdbool.h>
 
 #include "include/modelutils.h"
+#include "../cds_engine/cds_engine.c"
+#include "../oracle_discovery/oracle_discovery.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -26,16 +28,22 @@ model_t model=
 #define LOG_TOPO_G
 #define LOG_TOPO
 
+//uncomment to fill neighbor tables from node positions at bootstrap (see
+//oracle_discovery.h) instead of simulating hello beacons
+//#define ORACLE_DISCOVERY
+
 #define ERROR -1
 #define NONE -2
 #define PRECISION 100000
 
 #define DEFAULT_START_TIME 0
 #define PERIOD 1000000000
+//radio range assumed by oracle discovery, must match the propagation model
+#define ORACLE_RANGE 100
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
 	node_data->overhead)
@@ -65,6 +73,7 @@ typedef struct
 typedef struct
 {
     float scale_postscript;
+    cds_engine *cds;
 }entity_data_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,13 +88,13 @@ int set_header(call_t *call, packet_t *packet, destination_t *dest);
 int get_header_size(call_t *call);
 int get_header_real_size(call_t *call);
 int do_cds(call_t *call, destination_t *args);
-void remove_from(void *list, destination_t *to_remove);
-destination_t* has_common_nbr(void *l, void *r);
-void add_first_link(call_t *call, void *l, void *r);
 void planarize_graph(call_t *call, packet_t *packet);
 bool node_present_in(void *das, destination_t *to_find);
 int hello_callback(call_t *call, void *args);
 bool check_in_geocast(destination_t *region, destination_t *to_check);
+bool in_region(nodeid_t node, void *region);
+void* cds_nbrs(call_t *call);
+void* cds_gg(call_t *call);
 void tx(call_t *call, packet_t *packet);
 void rx(call_t *call, packet_t *packet);
 bool compare_positions(position_t *l, position_t *r);
@@ -110,6 +119,13 @@ int init(call_t *call, void *params)
 	    "routing module\n");
 	return ERROR;
     }
+    if((entity_data->cds = create_cds_engine(cds_nbrs, cds_gg, false)) == NULL)
+    {
+	fprintf(stderr, "[ERR] Can't allocate CDS engine\n[ERR] Error in "
+	    "routing module\n");
+	free(entity_data);
+	return ERROR;
+    }
 
 #if defined LOG_TOPO_G || defined LOG_GG
     position_t *topo_pos = get_topology_area();
@@ -146,6 +162,7 @@ int destroy(call_t *call)
     topo_post_axes(call);
 #endif
 
+    cds_engine_destroy(entity_data->cds);
     free(entity_data);
     entity_data = NULL;
     return 0;
@@ -232,9 +249,17 @@ int bootstrap(call_t *call)
 
     node_data->overhead = GET_HEADER_SIZE(&call_down);
 
+#ifdef ORACLE_DISCOVERY
+    //same tables as lossless hello rounds, without the beacons
+    if(oracle_discover_nbrs(call, ORACLE_RANGE, node_data->nbrs) == ERROR ||
+	oracle_discover_gg(call, node_data->nbrs, node_data->gg_list) == ERROR)
+	return ERROR;
+    cds_engine_invalidate(((entity_data_t*)ENTITY_DATA(call))->cds);
+#else
     scheduler_add_callback(DEFAULT_START_TIME, call, hello_callback, NULL);
     scheduler_add_callback(DEFAULT_START_TIME + PERIOD, call, hello_callback,
 	NULL);
+#endif
 
     return 0;
 }
@@ -288,158 +313,9 @@ int get_header_real_size(call_t *call)
 
 int do_cds(call_t *call, destination_t *dest)
 {
-    void *possible = NULL, *dominators = NULL;
-    if((possible = das_create()) == NULL || (dominators = das_create()) == NULL)
-    {
-	fprintf(stderr, "[ERR] Can't allocate lists\n[ERR] Error in cds\n");
-	return ERROR;
-    }
-
-    //get list of nodes in geocast region
-    destination_t *tmp = NEW(destination_t), *tmp2 = NULL;
-    int i;
-    for(i = 0; i < get_node_count(); ++i)
-    {
-	if(tmp == NULL)
-	    tmp = NEW(destination_t);
-	tmp->id = i;
-	tmp->position = *get_node_position(i);
-	if(check_in_geocast(dest, tmp))
-	{
-	    destination_t *to_delete = NULL;
-	    das_insert(possible, (void*)tmp);
-
-	    call_t call_tmp = *call;
-	    call_tmp.node = tmp->id;
-	    node_data_t *tmp_node_data = NODE_DATA(&call_tmp);
-	    while((to_delete = (destination_t*)das_pop(tmp_node_data->gg_list))
-		!= NULL)
-		free(to_delete);
-	    to_delete = NULL;
-
-	    das_init_traverse(tmp_node_data->nbrs);
-	    while((to_delete =
-		(destination_t*)das_traverse(tmp_node_data->nbrs)) != NULL)
-	    {
-		call_t call_delete = *call;
-		call_delete.node = to_delete->id;
-		node_data_t *delete_node_data = NODE_DATA(&call_delete);
-		remove_from(delete_node_data->gg_list, tmp);
-	    }
-	    tmp = NULL;
-	}
-    }
-
-    //generate list of dominators
-    while((tmp = (destination_t*)das_pop(possible)) != NULL)
-    {
-	das_insert(dominators, (void*)tmp);
-
-	call_t call_tmp = *call;
-	call_tmp.node = tmp->id;
-	node_data_t *node_data = NODE_DATA(&call_tmp);
-
-	das_init_traverse(node_data->nbrs);
-	while((tmp2 = (destination_t*)das_traverse(node_data->nbrs)) != NULL)
-	{
-	    destination_t *to_add = NEW(destination_t);
-
-	    *to_add = *tmp2;
-	    remove_from(possible, tmp2);
-	    das_insert(node_data->gg_list, (void*)to_add);
-
-	    call_t call_neighbor = *call;
-	    call_neighbor.node = to_add->id;
-	    node_data_t *neighbor_node_data = NODE_DATA(&call_neighbor);
-	    to_add = NEW(destination_t);
-	    *to_add = *tmp;
-	    das_insert(neighbor_node_data->gg_list, (void*)to_add);
-	}
-    }
-    das_destroy(possible);
-
-    while((tmp = (destination_t*)das_pop(dominators)) != NULL)
-    {
-	call_t call_tmp = *call;
-	call_tmp.node = tmp->id;
-	node_data_t *tmp_node_data = NODE_DATA(&call_tmp);
-	das_init_traverse(dominators);
-	while((tmp2 = (destination_t*)das_traverse(dominators)) != NULL)
-	{
-	    call_t call_tmp2 = *call;
-	    call_tmp2.node = tmp2->id;
-	    node_data_t *tmp2_node_data = NODE_DATA(&call_tmp2);
-	    if(has_common_nbr(tmp_node_data->gg_list,
-		tmp2_node_data->gg_list) == NULL)
-	    {
-		add_first_link(call, tmp_node_data->gg_list,
-		    tmp2_node_data->gg_list);
-	    }
-	}
-	free(tmp);
-    }
-    das_destroy(dominators);
-
-    return 0;
-}
-
-void remove_from(void* list, destination_t* to_remove)
-{
-    destination_t *tmp = NULL;
-
-    das_init_traverse(list);
-    while((tmp = (destination_t*)das_traverse(list)) != NULL)
-    {
-	if(compare_destinations(to_remove, tmp))
-	{
-	    das_delete(list, tmp);
-	    return;
-	}
-    }
-    return;
-}
-
-destination_t* has_common_nbr(void *l, void *r)
-{
-    destination_t *l_tmp = NULL, *r_tmp = NULL;
-    das_init_traverse(l);
-    while((l_tmp = (destination_t*)das_traverse(l)) != NULL)
-    {
-	das_init_traverse(r);
-	while((r_tmp = (destination_t*)das_traverse(r)) != NULL)
-	{
-	    if(compare_destinations(l_tmp, r_tmp))
-		return l_tmp;
-	}
-    }
-    return NULL;
-}
-
-void add_first_link(call_t *call, void *l, void *r)
-{
-    destination_t *l_tmp = NULL, *result = NULL;
+    entity_data_t *entity_data = ENTITY_DATA(call);
 
-    das_init_traverse(l);
-    while((l_tmp = (destination_t*)das_traverse(l)) != NULL)
-    {
-	call_t call_l = *call;
-	call_l.node = l_tmp->id;
-	node_data_t *l_node_data = NODE_DATA(&call_l);
-	if((result = has_common_nbr(l_node_data->nbrs, r)) != NULL)
-	{
-	    call_t call_r = *call;
-	    call_r.node = result->id;
-	    node_data_t *r_node_data = NODE_DATA(&call_r);
-
-	    destination_t *to_add = NEW(destination_t);
-	    *to_add = *result;
-	    das_insert(l_node_data->gg_list, (void*)to_add);
-	    to_add = NEW(destination_t);
-	    *to_add = *l_tmp;
-	    das_insert(r_node_data->gg_list, (void*)to_add);
-	}
-    }
-    return;
+    return cds_run(entity_data->cds, call, in_region, (void*)dest);
 }
 
 void planarize_graph(call_t *call, packet_t *packet)
@@ -461,6 +337,7 @@ void planarize_graph(call_t *call, packet_t *packet)
 	}
 	*tmp = header->sender;
 	das_insert(node_data->nbrs, (void*)tmp);
+	cds_engine_invalidate(((entity_data_t*)ENTITY_DATA(call))->cds);
 	return;
     }
 
@@ -528,7 +405,7 @@ int hello_callback(call_t *call, void* args)
     header->sender = my_pos;
     header->dest = no_dest;
 
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
@@ -546,6 +423,29 @@ bool check_in_geocast(destination_t *region, destination_t *to_check)
     return false;
 }
 
+bool in_region(nodeid_t node, void *region)
+{
+    destination_t tmp = {node, *get_node_position(node)};
+
+    return check_in_geocast((destination_t*)region, &tmp);
+}
+
+void* cds_nbrs(call_t *call)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->nbrs;
+}
+
+void* cds_gg(call_t *call)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->gg_list;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TX
 
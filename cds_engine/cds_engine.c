@@ -0,0 +1,450 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include "cds_engine.h"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+#define CDS_WORDS(cnt) (((cnt) + CDS_WORD_BITS - 1) / CDS_WORD_BITS)
+#define CDS_TEST(set, node) (((set)[(node) / CDS_WORD_BITS] >> \
+	((node) % CDS_WORD_BITS)) & 1)
+#define CDS_SET(set, node) ((set)[(node) / CDS_WORD_BITS] |= \
+	(uint64_t)1 << ((node) % CDS_WORD_BITS))
+#define CDS_CLEAR(set, node) ((set)[(node) / CDS_WORD_BITS] &= \
+	~((uint64_t)1 << ((node) % CDS_WORD_BITS)))
+#define CDS_ROW(cds, node) ((cds)->gg + (size_t)(node) * (cds)->words)
+#define CDS_LIVE(cds, node) ((node) >= 0 && (node) < (cds)->node_cnt && \
+	CDS_TEST((cds)->alive, (node)))
+
+//=====================================================================
+// - Internal helpers
+
+//---------------------------------------------------------------------
+// * Lazy Sizing
+//---------------------------------------------------------------------
+// Node count is only known once the simulation is configured, so the
+// per-node arrays are sized on the first run. The adjacency itself is
+// (re)allocated by cds_engine_build.
+//---------------------------------------------------------------------
+static bool cds_engine_reserve(cds_engine* cds){
+    if(cds->alive != NULL) return true;
+
+    int n = get_node_count(), words = CDS_WORDS(n);
+    cds->adj_start = malloc((n + 1) * sizeof(int));
+    cds->alive = calloc(words, sizeof(uint64_t));
+    cds->region = malloc(words * sizeof(uint64_t));
+    cds->possible = malloc(words * sizeof(uint64_t));
+    cds->touched = calloc(words, sizeof(uint64_t));
+    cds->gg = calloc((size_t)n * words, sizeof(uint64_t));
+    cds->dominators = malloc(n * sizeof(nodeid_t));
+    cds->rows = malloc(n * sizeof(nodeid_t));
+    if(cds->adj_start == NULL || cds->alive == NULL || cds->region == NULL ||
+	cds->possible == NULL || cds->touched == NULL || cds->gg == NULL ||
+	cds->dominators == NULL || cds->rows == NULL){
+	free(cds->adj_start);
+	free(cds->alive);
+	free(cds->region);
+	free(cds->possible);
+	free(cds->touched);
+	free(cds->gg);
+	free(cds->dominators);
+	free(cds->rows);
+	cds->adj_start = NULL;
+	cds->alive = NULL;
+	cds->region = NULL;
+	cds->possible = NULL;
+	cds->touched = NULL;
+	cds->gg = NULL;
+	cds->dominators = NULL;
+	cds->rows = NULL;
+	return false;
+    }
+    cds->node_cnt = n;
+    cds->words = words;
+
+    return true;
+}
+
+static void* cds_list(cds_engine* cds, call_t *call, nodeid_t node,
+    cds_list_func get){
+    call_t call_node = *call;
+
+    call_node.node = node;
+    return get(&call_node);
+}
+
+//---------------------------------------------------------------------
+// * Build Adjacency
+//---------------------------------------------------------------------
+// Copies every live node's neighbor list, in list order, into one flat
+// array; node i's neighbors are adj[adj_start[i]] to
+// adj[adj_start[i + 1] - 1].
+//---------------------------------------------------------------------
+static bool cds_engine_build(cds_engine* cds, call_t *call){
+    int n = cds->node_cnt, total = 0, i;
+    destination_t *nbr = NULL;
+    void *nbrs = NULL;
+
+    memset(cds->alive, 0, cds->words * sizeof(uint64_t));
+    for(i = 0; i < n; i++){
+	cds->adj_start[i] = total;
+	if(!is_node_alive(i)) continue;
+	CDS_SET(cds->alive, i);
+	if((nbrs = cds_list(cds, call, i, cds->get_nbrs)) != NULL)
+	    total += das_getsize(nbrs);
+    }
+    cds->adj_start[n] = total;
+
+    free(cds->adj);
+    if((cds->adj = malloc((total > 0 ? total : 1) *
+	sizeof(destination_t))) == NULL){
+	cds->valid = false;
+	return false;
+    }
+
+    for(i = 0; i < n; i++){
+	int k = cds->adj_start[i];
+	if(!CDS_TEST(cds->alive, i) ||
+	    (nbrs = cds_list(cds, call, i, cds->get_nbrs)) == NULL)
+	    continue;
+	das_init_traverse(nbrs);
+	while(k < cds->adj_start[i + 1] &&
+	    (nbr = (destination_t*)das_traverse(nbrs)) != NULL)
+	    cds->adj[k++] = *nbr;
+    }
+
+    cds->version = get_topology_version();
+    cds->valid = true;
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+// * Sync With Topology
+//---------------------------------------------------------------------
+// Deaths since the last run only clear a liveness bit (dead neighbors
+// are skipped wherever the adjacency is read); a birth rebuilds, as
+// the new node's neighbor list was never copied.
+//---------------------------------------------------------------------
+static bool cds_engine_sync(cds_engine* cds, call_t *call){
+    int i;
+
+    if(!cds->valid) return cds_engine_build(cds, call);
+    if(cds->version == get_topology_version()) return true;
+
+    for(i = 0; i < cds->node_cnt; i++){
+	bool alive = is_node_alive(i);
+	if(alive && !CDS_TEST(cds->alive, i))
+	    return cds_engine_build(cds, call);
+	if(!alive && CDS_TEST(cds->alive, i))
+	    cds_engine_node_died(cds, i);
+    }
+    cds->version = get_topology_version();
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+// * Link
+//---------------------------------------------------------------------
+// Inserts a copy of 'entry' into owner's gg list, reusing an entry
+// from a cleared list when one is available, and mirrors it in the
+// owner's gg bitset.
+//---------------------------------------------------------------------
+static void cds_link(cds_engine* cds, call_t *call, nodeid_t owner,
+    destination_t *entry){
+    void *gg_list = cds_list(cds, call, owner, cds->get_gg);
+    destination_t *to_add = NULL;
+
+    if(gg_list == NULL) return;
+    if((to_add = (destination_t*)das_pop(cds->spare)) == NULL &&
+	(to_add = NEW(destination_t)) == NULL){
+	fprintf(stderr, "[ERR] Can't allocate destination\n[ERR] Error in "
+	    "cds\n");
+	return;
+    }
+    *to_add = *entry;
+    das_insert(gg_list, (void*)to_add);
+
+    if(owner < 0 || owner >= cds->node_cnt || entry->id < 0 ||
+	entry->id >= cds->node_cnt) return;
+    if(!CDS_TEST(cds->touched, owner)){
+	CDS_SET(cds->touched, owner);
+	cds->rows[cds->row_cnt++] = owner;
+    }
+    CDS_SET(CDS_ROW(cds, owner), entry->id);
+}
+
+//---------------------------------------------------------------------
+// * Unlink
+//---------------------------------------------------------------------
+// Removes the first entry for 'node' from a gg list.
+//---------------------------------------------------------------------
+static void cds_unlink(void *gg_list, nodeid_t node){
+    destination_t *tmp = NULL;
+
+    if(gg_list == NULL) return;
+    das_init_traverse(gg_list);
+    while((tmp = (destination_t*)das_traverse(gg_list)) != NULL){
+	if(tmp->id == node){
+	    das_delete(gg_list, tmp);
+	    return;
+	}
+    }
+}
+
+//---------------------------------------------------------------------
+// * Common Neighbor
+//---------------------------------------------------------------------
+// True if the gg lists of dominators a and b share a node.
+//---------------------------------------------------------------------
+static bool cds_common_nbr(cds_engine* cds, nodeid_t a, nodeid_t b){
+    uint64_t *row_a = CDS_ROW(cds, a), *row_b = CDS_ROW(cds, b);
+    int w;
+
+    for(w = 0; w < cds->words; w++)
+	if(row_a[w] & row_b[w]) return true;
+
+    return false;
+}
+
+//---------------------------------------------------------------------
+// * Bridge
+//---------------------------------------------------------------------
+// For every gg neighbor u of a, links u to its first neighbor (in
+// neighbor list order) that is on b's gg list.
+//---------------------------------------------------------------------
+static void cds_bridge(cds_engine* cds, call_t *call, nodeid_t a,
+    nodeid_t b){
+    void *gg_list = cds_list(cds, call, a, cds->get_gg);
+    uint64_t *row_b = CDS_ROW(cds, b);
+    destination_t *l_tmp = NULL;
+    int k;
+
+    if(gg_list == NULL) return;
+    das_init_traverse(gg_list);
+    while((l_tmp = (destination_t*)das_traverse(gg_list)) != NULL){
+	nodeid_t u = l_tmp->id;
+	if(!CDS_LIVE(cds, u)) continue;
+
+	for(k = cds->adj_start[u]; k < cds->adj_start[u + 1]; k++){
+	    destination_t *result = &cds->adj[k];
+	    if(!CDS_LIVE(cds, result->id) || !CDS_TEST(row_b, result->id))
+		continue;
+
+	    cds_link(cds, call, u, result);
+	    cds_link(cds, call, result->id, l_tmp);
+	    break;
+	}
+    }
+}
+
+//---------------------------------------------------------------------
+// * Link Outside
+//---------------------------------------------------------------------
+// If every gg neighbor of a is inside the region, links the first of
+// them that has a live neighbor outside the region to that neighbor.
+//---------------------------------------------------------------------
+static void cds_link_outside(cds_engine* cds, call_t *call, nodeid_t a){
+    void *gg_list = cds_list(cds, call, a, cds->get_gg);
+    destination_t *tmp = NULL;
+    int k;
+
+    if(gg_list == NULL) return;
+    das_init_traverse(gg_list);
+    while((tmp = (destination_t*)das_traverse(gg_list)) != NULL)
+	if(!CDS_LIVE(cds, tmp->id) || !CDS_TEST(cds->region, tmp->id))
+	    return;
+
+    das_init_traverse(gg_list);
+    while((tmp = (destination_t*)das_traverse(gg_list)) != NULL){
+	nodeid_t u = tmp->id;
+
+	for(k = cds->adj_start[u]; k < cds->adj_start[u + 1]; k++){
+	    destination_t *nbr = &cds->adj[k];
+	    if(!CDS_LIVE(cds, nbr->id) || CDS_TEST(cds->region, nbr->id))
+		continue;
+
+	    destination_t entry = *tmp;
+	    cds_link(cds, call, u, nbr);
+	    cds_link(cds, call, nbr->id, &entry);
+	    return;
+	}
+    }
+}
+
+//=====================================================================
+// - Creation/destruction
+
+//---------------------------------------------------------------------
+// * Create CDS Engine
+//---------------------------------------------------------------------
+// get_nbrs returns the physical neighbor das of a node (the adjacency
+// is copied from it), get_gg the gg list das the engine rewires. With
+// link_outside, dominators enclosed by the region are linked outward.
+//---------------------------------------------------------------------
+cds_engine* create_cds_engine(cds_list_func get_nbrs, cds_list_func get_gg,
+    bool link_outside){
+    cds_engine* cds = NEW(cds_engine);
+    if(cds == NULL) return NULL;
+
+    if((cds->spare = das_create()) == NULL){
+	free(cds);
+	return NULL;
+    }
+    cds->get_nbrs = get_nbrs;
+    cds->get_gg = get_gg;
+    cds->link_outside = link_outside;
+    cds->node_cnt = 0;
+    cds->words = 0;
+    cds->version = 0;
+    cds->valid = false;
+    cds->adj_start = NULL;
+    cds->adj = NULL;
+    cds->alive = NULL;
+    cds->region = NULL;
+    cds->possible = NULL;
+    cds->touched = NULL;
+    cds->gg = NULL;
+    cds->dominators = NULL;
+    cds->rows = NULL;
+    cds->row_cnt = 0;
+
+    return cds;
+}
+
+//---------------------------------------------------------------------
+// * Destroy CDS Engine
+//---------------------------------------------------------------------
+void cds_engine_destroy(cds_engine* cds){
+    destination_t *tmp = NULL;
+
+    if(cds == NULL) return;
+
+    while((tmp = (destination_t*)das_pop(cds->spare)) != NULL)
+	free(tmp);
+    das_destroy(cds->spare);
+    free(cds->adj_start);
+    free(cds->adj);
+    free(cds->alive);
+    free(cds->region);
+    free(cds->possible);
+    free(cds->touched);
+    free(cds->gg);
+    free(cds->dominators);
+    free(cds->rows);
+    free(cds);
+}
+
+//---------------------------------------------------------------------
+// * Invalidate
+//---------------------------------------------------------------------
+// Forces the adjacency to be copied again on the next run. Modules call
+// this whenever they edit the lists returned by get_nbrs.
+//---------------------------------------------------------------------
+void cds_engine_invalidate(cds_engine* cds){
+    if(cds != NULL) cds->valid = false;
+}
+
+//---------------------------------------------------------------------
+// * Node Died
+//---------------------------------------------------------------------
+// Drops 'node' from the adjacency without rebuilding it. Runs call this
+// themselves for deaths they notice through the topology version.
+//---------------------------------------------------------------------
+void cds_engine_node_died(cds_engine* cds, nodeid_t node){
+    if(cds == NULL || cds->alive == NULL || node < 0 ||
+	node >= cds->node_cnt) return;
+
+    CDS_CLEAR(cds->alive, node);
+}
+
+//=====================================================================
+// - Run
+
+//---------------------------------------------------------------------
+// * Run
+//---------------------------------------------------------------------
+// Rewires the gg lists for the live nodes accepted by in_region:
+//  1. region nodes' gg lists are emptied and region nodes are removed
+//     from their outside neighbors' gg lists;
+//  2. dominators are picked from the highest id down, each linked both
+//     ways to all its neighbors, which are then no longer candidates;
+//  3. from the lowest id up, each dominator is bridged to every later
+//     dominator it shares no gg neighbor with, and (link_outside) is
+//     linked out of the region if enclosed by it.
+// Returns 0, or -1 if the engine could not be allocated.
+//---------------------------------------------------------------------
+int cds_run(cds_engine* cds, call_t *call, cds_match_func in_region,
+    void *arg){
+    int n, dom_cnt = 0, i, j, k;
+    destination_t *tmp = NULL;
+
+    if(cds == NULL || !cds_engine_reserve(cds) || !cds_engine_sync(cds, call)){
+	fprintf(stderr, "[ERR] Can't allocate lists\n[ERR] Error in cds\n");
+	return -1;
+    }
+    n = cds->node_cnt;
+
+    memset(cds->region, 0, cds->words * sizeof(uint64_t));
+    for(i = 0; i < n; i++)
+	if(CDS_TEST(cds->alive, i) && in_region(i, arg))
+	    CDS_SET(cds->region, i);
+    memcpy(cds->possible, cds->region, cds->words * sizeof(uint64_t));
+
+    //clear region gg lists; region neighbors are emptied anyway
+    for(i = 0; i < n; i++){
+	void *gg_list = NULL;
+	if(!CDS_TEST(cds->region, i)) continue;
+
+	if((gg_list = cds_list(cds, call, i, cds->get_gg)) != NULL)
+	    while((tmp = (destination_t*)das_pop(gg_list)) != NULL)
+		das_insert(cds->spare, (void*)tmp);
+
+	for(k = cds->adj_start[i]; k < cds->adj_start[i + 1]; k++){
+	    nodeid_t v = cds->adj[k].id;
+	    if(!CDS_LIVE(cds, v) || CDS_TEST(cds->region, v)) continue;
+	    cds_unlink(cds_list(cds, call, v, cds->get_gg), i);
+	}
+    }
+
+    //generate dominators
+    for(i = n - 1; i >= 0; i--){
+	destination_t self = {i, *get_node_position(i)};
+	if(!CDS_TEST(cds->possible, i)) continue;
+
+	CDS_CLEAR(cds->possible, i);
+	cds->dominators[dom_cnt++] = i;
+	for(k = cds->adj_start[i]; k < cds->adj_start[i + 1]; k++){
+	    destination_t *nbr = &cds->adj[k];
+	    if(!CDS_LIVE(cds, nbr->id)) continue;
+
+	    CDS_CLEAR(cds->possible, nbr->id);
+	    cds_link(cds, call, i, nbr);
+	    cds_link(cds, call, nbr->id, &self);
+	}
+    }
+
+    //connect dominators, lowest id first
+    for(i = dom_cnt - 1; i >= 0; i--){
+	nodeid_t a = cds->dominators[i];
+
+	for(j = i - 1; j >= 0; j--)
+	    if(!cds_common_nbr(cds, a, cds->dominators[j]))
+		cds_bridge(cds, call, a, cds->dominators[j]);
+	if(cds->link_outside)
+	    cds_link_outside(cds, call, a);
+    }
+
+    //reset the gg bitsets touched by this run
+    for(i = 0; i < cds->row_cnt; i++){
+	memset(CDS_ROW(cds, cds->rows[i]), 0, cds->words * sizeof(uint64_t));
+	CDS_CLEAR(cds->touched, cds->rows[i]);
+    }
+    cds->row_cnt = 0;
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+//=====================================================================
+// ** Connected Dominating Set Engine
+//=====================================================================
+// Greedy connected dominating set over the geocast region, rewiring
+// each node's planar (gg) list the same way the modules' do_cds did:
+// region nodes are cleared, dominators are picked from the highest id
+// down and linked to all their neighbors, every pair of dominators
+// without a common gg neighbor gets bridged, and optionally a
+// dominator enclosed by the region is linked to an outside node.
+//
+// The neighbor tables are snapshotted into a compact adjacency (one
+// flat array of destinations indexed per node) that survives between
+// runs. Node deaths are applied incrementally by clearing a liveness
+// bit; only an explicit invalidation (the module edited a neighbor
+// list) or a node birth triggers a rebuild. The gg lists built during
+// a run are mirrored into per-node bitsets, so the common-neighbor
+// test between two dominators is a word-wise AND and a membership
+// test is a single bit. Entries taken off the cleared gg lists are
+// recycled for the new links instead of being freed and re-malloced.
+//=====================================================================
+#ifndef __cds_engine__
+#define __cds_engine__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+#define CDS_WORD_BITS 64
+
+//---------------------------------------------------------------------
+// * Returns a das of destination_t* (nbrs or gg_list of call->node)
+
+typedef void* (*cds_list_func)(call_t *call);
+
+//---------------------------------------------------------------------
+// * Geocast region membership
+
+typedef bool (*cds_match_func)(nodeid_t node, void *arg);
+
+//---------------------------------------------------------------------
+// * CDS engine main data structure
+
+typedef struct{
+    cds_list_func	get_nbrs;
+    cds_list_func	get_gg;
+    bool		link_outside;
+    int			node_cnt;
+    int			words;
+    uint64_t		version;
+    bool		valid;
+    int*		adj_start;
+    destination_t*	adj;
+    uint64_t*		alive;
+    uint64_t*		region;
+    uint64_t*		possible;
+    uint64_t*		touched;
+    uint64_t*		gg;
+    nodeid_t*		dominators;
+    nodeid_t*		rows;
+    int			row_cnt;
+    void*		spare;
+} cds_engine;
+
+//-----------------------------------
+// - CDS Engine Methods
+//-----------------------------------
+cds_engine*	create_cds_engine(cds_list_func get_nbrs,
+		    cds_list_func get_gg, bool link_outside);
+void		cds_engine_destroy(cds_engine* cds);
+void		cds_engine_invalidate(cds_engine* cds);
+void		cds_engine_node_died(cds_engine* cds, nodeid_t node);
+
+// - Rewire the gg lists for the region accepted by in_region
+int		cds_run(cds_engine* cds, call_t *call,
+		    cds_match_func in_region, void *arg);
+
+#endif //__cds_engine__
@@ -10,6 +10,8 @@
 #include <stdbool.h>
 
 #include <include/modelutils.h>
+#include "../face_table/face_table.c"
+#include "../geo_predicates/geo_predicates.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -52,9 +54,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -92,6 +94,7 @@ typedef struct
 {
     void *nbrs;
     void *gg_list;
+    face_table *face;
     int overhead;
 }node_data_t;
 
@@ -140,6 +143,7 @@ void forward_packet(call_t *call, packet_t *packet, direction_e direction);
 void deliver_packet(call_t *call, packet_t *packet);
 bool combine_packets(call_t *call, destination_t *sender,
     destination_t *next_node, direction_e direction);
+uint64_t buffer_key(call_t *call, packet_t *packet);
 
 //receiving functions
 void rx(call_t *call, packet_t *packet);
@@ -267,6 +271,16 @@ int setnode(call_t *call, void* params)
 	node_data = NULL;
 	return ERROR;
     }
+    if((node_data->face = create_face_table()) == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate face table\nError in "
+	    "routing module\n");
+	das_destroy(node_data->gg_list);
+	das_destroy(node_data->nbrs);
+	free(node_data);
+	node_data = NULL;
+	return ERROR;
+    }
     node_data->overhead = NONE;
 
     /* uncomment if adding parameters later
@@ -315,6 +329,7 @@ int unsetnode(call_t *call)
     while((dest = (destination_t*)das_pop(node_data->gg_list)) != NULL)
 	free(dest);
     das_destroy(node_data->gg_list);
+    face_table_destroy(node_data->face);
 
     free(node_data);
     node_data = NULL;
@@ -333,6 +348,8 @@ int bootstrap(call_t *call)
 
     //get mac header overhead to send to application layer for packet allocation
     node_data->overhead = GET_HEADER_SIZE(&call_down);
+    //let the mac index queued packets for combine_packets
+    SET_BUFFER_KEY(&call_down, call, buffer_key);
     //hello callback needs to be run twice, once for collecting neighbor
     //information, and a second time to planerize the graph, it doesn't need to
     //be run again after that for a static graph
@@ -469,6 +486,7 @@ void planarize_graph(call_t *call, packet_t *packet)
 	}
 	*tmp = header->sender;
 	das_insert(node_data->gg_list, (void*)tmp);
+	face_table_invalidate(node_data->face);
     }
     return;
 }
@@ -526,7 +544,7 @@ int hello_callback(call_t *call, void *args)
     header->direction = NO_DIR;
 
     // send hello
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
@@ -608,62 +626,18 @@ destination_t next_on_face(call_t *call, destination_t *start,
     destination_t *nodeRef, direction_e direction)
 {
     node_data_t *node_data = NODE_DATA(call);
-    destination_t *gg_nbr = NULL;
-    double angle, angle_min = 180.0, angle_max = 0.0, vect, d1, d2;
-    destination_t winner = *start, max = *start, no_dest = NO_DESTINATION;
+    destination_t *winner = NULL, no_dest = NO_DESTINATION;
 
     if(das_getsize(node_data->gg_list) == 0)
 	return no_dest;
 
-    das_init_traverse(node_data->gg_list);
-    while((gg_nbr = (destination_t*)das_traverse(node_data->gg_list)) != NULL)
-    {
-	bool result = false;
-	if(gg_nbr->id != nodeRef->id)
-	{
-	    //calculate angle between start-ref vector and start-next vector
-	    //using dot product
-	    position_t *temp_pos = &gg_nbr->position;
-	    d1 = distance(&start->position, &nodeRef->position);
-	    d2 = distance(&start->position, temp_pos);
-	    angle = acos((double)(((start->position.x - nodeRef->position.x) *
-		(start->position.x - temp_pos->x) + (start->position.y -
-		nodeRef->position.y) * (start->position.y - temp_pos->y))
-		/ (d1 * d2)));
-
-	    //calculate 3-dimensional cross product of start-ref and
-	    //start-next, then use the property of right-hand orthogonality
-	    //to determine if angle is calculated clockwise or
-	    //counter-clockwise
-	    vect = (double)((temp_pos->x - start->position.x) *
-		(nodeRef->position.y - start->position.y)) -
-		(double)((temp_pos->y - start->position.y) *
-		(nodeRef->position.x - start->position.x));
-	    if((direction == TRAVERSE_R && vect >= 0) || (direction ==
-		TRAVERSE_L && vect <= 0))
-		result = true;
-
-	    //find the smallest angle going counter-clockwise
-	    if(result && angle <= angle_min)
-	    {
-		angle_min = angle;
-		winner = *gg_nbr;
-	    }
-	    //find the largest angle going clockwise
-	    else if(!result && angle >= angle_max)
-	    {
-		angle_max = angle;
-		max = *gg_nbr;
-	    }
-	}
-    }
-    //extreme cases
-    if(compare_destinations(&winner, start) == true)
-	winner = max;
-    if(compare_destinations(&winner, start) == true)
-	winner = *nodeRef;
-
-    return winner;
+    //gg neighbors are kept sorted by angle around start, so the right
+    //(clockwise) or left (counter-clockwise) hand successor of nodeRef
+    //is a binary search away
+    if((winner = face_table_next(node_data->face, &start->position,
+	node_data->gg_list, nodeRef, direction == TRAVERSE_R)) == NULL)
+	return *nodeRef;
+    return *winner;
 }
 
 //check to see if edge traversed is juncture and to start routing next face
@@ -677,81 +651,20 @@ intersection_e check_intersect(call_t *call, destination_t *source,
 	next->id == dest->id || call->node == dest->id)
 	return NO_INT;
     position_t *current_pos = get_node_position(call->node);
-    //calculate 3-dimensional cross products of source-current vector and
-    //source-destination vector and the source-prev vector and
-    //source-destination vector
-    double vect1 = ((current_pos->x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((current_pos->y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    double vect2 = ((next->position.x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((next->position.y - source->position.y) *
-	(dest->position.x - source->position.x));
-    //if BOTH vectors have the same sign, they are BOTH on the same side of the
-    //source-destination line, don't change face
-    if((vect1 < 0 && vect2 < 0) || (vect1 > 0 && vect2 >0))
-	return NO_INT;
 
-    //check to see if current-next and source-destination intersect
-    double a1, a2, b1, b2, c1, c2, det, x, y, dist;
-
-    //get formulas for the two lines the line segments are part of in
-    //Ax + By = C form
-    a1 = dest->position.y - source->position.y;
-    b1 = source->position.x - dest->position.x;
-    c1 = a1 * source->position.x + b1 * source->position.y;
-    a2 = next->position.y - current_pos->y;
-    b2 = current_pos->x - next->position.x;
-    c2 = a2 * current_pos->x + b2 * current_pos->y;
-
-    //if determinant of the two formulas is 0, lines are parallel, check for
-    //overlap of the x coordinates unless source-destination is a vertical
-    //line, then check y coordinates
-    if((det = a1 * b2 - a2 * b1) == 0)
+    //exact orientation tests of current-next against source-destination:
+    //a crossing at current is collinear, one at next is left to next
+    switch(geo_segment_cross(&source->position, &dest->position,
+	current_pos, &next->position))
     {
-	//if(source-destination isn't vertical && min(x)(source-destination) <
-	//max(x)(prev-current) && max(x)(source-destination) >
-	//min(x)(prev-current) || source-destination is vertical &&
-	//min(y)(source-destination) < max(y)(prev-current) &&
-	//max(y)(source-destination) > min(y)(prev-current)
-	if((source->position.x - dest->position.x != 0 &&
-	    fmin(source->position.x, dest->position.x) <
-	    fmax(current_pos->x, next->position.x) &&
-	    fmax(source->position.x, dest->position.x) >
-	    fmin(current_pos->x, next->position.x)) ||
-	    (source->position.x - dest->position.x == 0 &&
-	    fmin(source->position.y, dest->position.y) <
-	    fmax(current_pos->y, next->position.y) &&
-	    fmax(source->position.y, dest->position.y) >
-	    fmin(current_pos->y, next->position.y)))
-	{
-	    return COLLINEAR;
-	}
-    }
-    //if lines are not parallel
-    else
-    {
-	//apply Cramer's rule to solve for point of intersection
-	x = (b2 * c1 - b1 * c2)/det;
-	y = (a1 * c2 - a2 * c1)/det;
-
-	//if the length of the vectors formed by the difference of the
-	//destination and point of intersection and the source and point of
-	//intersection equal the length of the source-destination line segment,
-	//then the lines intersect 
-	dist = hypot((dest->position.x - x), (dest->position.y - y)) +
-	    hypot((source->position.x - x), (source->position.y - y));
-	if(((int)(distance(&source->position, &dest->position) * PRECISION)) ==
-	    (int)(dist * PRECISION))
-	{
-	    if(current_pos->x == x && current_pos->y == y)
-		return COLLINEAR;
-	    if(next->position.x == x && next->position.y == y)
-		return NO_INT;
+	case GEO_CROSS:
 	    return INTERSECTION;
-	}
+	case GEO_CROSS_AT_FROM:
+	case GEO_OVERLAP:
+	    return COLLINEAR;
+	default:
+	    return NO_INT;
     }
-    return NO_INT;
 }
 
 //start routing on the first face
@@ -1024,7 +937,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->direction == TRAVERSE_R)
 	PRINT_ROUTING("[RTG] packet at %d, sweep right to %d\n", call->node,
@@ -1039,6 +952,14 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
     return true;
 }
 
+//key of a queued packet in the mac's buffer index (see combine_packets)
+uint64_t buffer_key(call_t *call, packet_t *packet)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    header_t *header = PACKET_HEADER(packet, node_data);
+    return BUFFER_KEY(header->type, header->sender.id, header->next_node.id);
+}
+
 //checks to see if packets can be combined to reduce number of packets
 //returns true if packets are combined, false otherwise
 bool combine_packets(call_t *call, destination_t *sender,
@@ -1047,10 +968,9 @@ bool combine_packets(call_t *call, destination_t *sender,
     node_data_t *node_data = NODE_DATA(call);
 
     call_t call_down = CALL_DOWN(call);
-    void *buffer = GET_BUFFER(&call_down);
+    uint64_t key = BUFFER_KEY(DATA_PACKET, sender->id, next_node->id);
     buffer_entry_t *entry = NULL;
-    das_init_traverse(buffer);
-    while((entry = (buffer_entry_t*)das_traverse(buffer)) != NULL)
+    while((entry = FIND_IN_BUFFER(&call_down, key, entry)) != NULL)
     {
 	header_t *header = PACKET_HEADER(entry->packet, node_data);
 	if(header->type == DATA_PACKET &&
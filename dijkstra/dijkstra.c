@@ -6,6 +6,8 @@
 #include <stdbool.h>
 
 #include "include/modelutils.h"
+#include "../path_oracle/path_oracle.c"
+#include "../oracle_discovery/oracle_discovery.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -25,15 +27,21 @@ model_t model =
 #define LOG_TOPO_G
 #define LOG_TOPO
 
+//uncomment to fill neighbor tables from node positions at bootstrap (see
+//oracle_discovery.h) instead of simulating hello beacons
+//#define ORACLE_DISCOVERY
+
 #define ERROR -1
 #define NONE -2
 
 #define DEFAULT_START_TIME 0
 #define PERIOD 1000000000
+//radio range assumed by oracle discovery, must match the propagation model
+#define ORACLE_RANGE 100
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
 	node_data->overhead)
@@ -48,14 +56,6 @@ model_t model =
 
 typedef enum {HELLO_PACKET, D_PACKET} packet_e;
 
-//visited node data
-typedef struct
-{
-    nodeid_t this;
-    nodeid_t prev;
-    double distance;
-}visited_node_t;
-
 //Routing Header
 typedef struct
 {
@@ -76,6 +76,7 @@ typedef struct
 typedef struct
 {
     float scale_postscript;
+    path_oracle *oracle;
 }entity_data_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,8 +89,7 @@ int unsetnode(call_t *call);
 int bootstrap(call_t *call);
 int set_header(call_t *call, packet_t *packet, destination_t *dest);
 void* get_shortest_path(call_t *call, destination_t *dest);
-bool check_in_visited(void *visited, destination_t *to_check);
-visited_node_t* get_node(void *visited, nodeid_t to_get);
+void* oracle_nbrs(call_t *call);
 int get_header_size(call_t *call);
 int get_header_real_size(call_t *call);
 int hello_callback(call_t *call, void* args);
@@ -122,6 +122,15 @@ int init(call_t *call, void *params)
     entity_data->scale_postscript = 1700.0 / (topo_pos->x + 20);
 #endif
 
+    if((entity_data->oracle = create_path_oracle(ORACLE_EUCLIDEAN,
+	oracle_nbrs)) == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate path oracle\nError in routing"
+	    " module\n");
+	free(entity_data);
+	return ERROR;
+    }
+
     set_entity_private_data(call, entity_data);
 
 #ifdef LOG_TOPO_G
@@ -146,6 +155,7 @@ int destroy(call_t *call)
     topo_post_axes(call);
 #endif
 
+    path_oracle_destroy(entity_data->oracle);
     free(entity_data);
     entity_data = NULL;
     return 0;
@@ -230,7 +240,14 @@ int bootstrap(call_t *call)
 
     node_data->overhead = GET_HEADER_SIZE(&call_down);
 
+#ifdef ORACLE_DISCOVERY
+    //same tables as lossless hello rounds, without the beacons
+    if(oracle_discover_nbrs(call, ORACLE_RANGE, node_data->nbrs) == ERROR)
+	return ERROR;
+    path_oracle_invalidate(((entity_data_t*)ENTITY_DATA(call))->oracle);
+#else
     scheduler_add_callback(DEFAULT_START_TIME, call, hello_callback, NULL);
+#endif
     return 0;
 }
 
@@ -257,152 +274,18 @@ int set_header(call_t *call, packet_t *packet, destination_t *dest)
 
 void* get_shortest_path(call_t *call, destination_t *dest)
 {
-    node_data_t *node_data = NODE_DATA(call);
-    call_t call_next = *call;
-    destination_t *tmp = NULL;
-    visited_node_t *tmp1 = NEW(visited_node_t), *tmp2 = NULL,
-	*new = NEW(visited_node_t);
-    void *visited = das_create(), *to_check = das_create();
-
-    //add source node to lists as top of tree
-    tmp1->this = call->node;
-    tmp1->prev = NONE;
-    tmp1->distance = 0;
-    *new = *tmp1;
-    das_insert(to_check, (void*)tmp1);
-    tmp1 = NEW(visited_node_t);
-    *tmp1 = *new;
-    das_insert(visited, (void*)tmp1);
-    new->this = NONE;
-
-    //while there are nodes to expand
-    while(das_getsize(to_check) != 0)
-    {
-	bool nodes_visited = true;
-
-	//while there are nodes in to_check
-	das_init_traverse(to_check);
-	while((tmp1 = (visited_node_t*)das_traverse(to_check)) != NULL)
-	{
-	    //remove previous node from to_check if no neigbors were checked
-	    if(!nodes_visited)
-	    {
-		das_delete(to_check, (void*)tmp2);
-		tmp2 = NULL;
-	    }
-	    nodes_visited = false;
-
-	    call_next.node = tmp1->this;
-	    node_data = NODE_DATA(&call_next);
-
-	    //check each nodes neighbor list
-	    das_init_traverse(node_data->nbrs);
-	    while((tmp = (destination_t*)das_traverse(node_data->nbrs)) != NULL)
-	    {
-		//if neighbor isn't already visited
-		if(!check_in_visited(visited, tmp))
-		{
-		    double dist = distance(get_node_position(tmp1->this),
-			&tmp->position) + tmp1->distance;
-		    if(new->this == NONE || dist < new->distance)
-		    {
-			new->this = tmp->id;
-			new->prev = tmp1->this;
-			new->distance = dist;
-		    }
-		    nodes_visited = true;
-		}
-	    }
-	    if(nodes_visited == false)
-		tmp2 = tmp1;
-	}
-
-	//duplicate check for visited neighbors for last node in list since loop
-	//will exit before check is performed
-	if(!nodes_visited)
-	{
-	    das_delete(to_check, (void*)tmp2);
-	    tmp2 = NULL;
-	}
-	//if shortest path found
-	if(new->this == dest->id)
-	    break;
-	//add next hop to lists
-	if(new->this != NONE)
-	{
-	    tmp2 = NEW(visited_node_t);
-	    *tmp2 = *new;
-	    das_insert(to_check, (void*)new);
-	    new = NEW(visited_node_t);
-	    *new = *tmp2;
-	    das_insert(visited, (void*)new);
-	    new = NEW(visited_node_t);
-	    new->this = NONE;
-	    new->prev = NONE;
-	    new->distance = 0;
-	    free(tmp2);
-	    tmp2 = NULL;
-	}
-    }
-
-    //create path structure
-    if(new->this == NONE)
-	return NULL;
-    void* path = das_create();
-    nodeid_t* next = NEW(int);
-    *next = new->this;
-    das_insert(path, (void*)next);
-    while((new = get_node(visited, new->prev)) != NULL)
-    {
-	if(new->this != call->node)
-	{
-	    next = NEW(int);
-	    *next = new->this;
-	    das_insert(path, (void*)next);
-	}
-    }
-
-    //deallocate used memory
-    while((new = (visited_node_t*)das_pop(to_check)) != NULL)
-	free(new);
-    das_destroy(to_check);
-    while((new = (visited_node_t*)das_pop(to_check)) != NULL)
-	free(new);
-    das_destroy(visited);
-    to_check = NULL;
-    visited = NULL;
-
-fprintf(stderr, "[ERR] printing path: ");
-das_init_traverse(path);
-nodeid_t *id = NULL;
-while((id = (nodeid_t*)das_traverse(path)) != NULL)
-fprintf(stderr, "%d, ", *id);
-fprintf(stderr, "\n");
-
-    return path;
-}
+    entity_data_t *entity_data = ENTITY_DATA(call);
 
-bool check_in_visited(void* visited, destination_t *to_check)
-{
-    visited_node_t *tmp = NULL;
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-	if(to_check->id == tmp->this)
-	    return true;
-    return false;
+    return path_oracle_get_path(entity_data->oracle, call, dest->id);
 }
 
-visited_node_t* get_node(void* visited, nodeid_t to_get)
+//neighbor list the path oracle grows its trees over
+void* oracle_nbrs(call_t *call)
 {
-    visited_node_t *tmp = NULL;
-
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-    {
-	if(tmp->this == to_get)
-	    return tmp;
-    }
-    return NULL;
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->nbrs;
 }
 
 //exported and used by application layer to gt necessary size for packet
@@ -458,13 +341,14 @@ int hello_callback(call_t *call, void *args)
     header->sender = my_pos;
     header->type = HELLO_PACKET;
 
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
 void add_to_nbr(call_t *call, packet_t *packet)
 {
     node_data_t *node_data = NODE_DATA(call);
+    entity_data_t *entity_data = ENTITY_DATA(call);
     header_t *header = PACKET_HEADER(packet, node_data);
     destination_t *tmp = NULL;
 
@@ -479,6 +363,7 @@ void add_to_nbr(call_t *call, packet_t *packet)
     tmp = NEW(destination_t);
     *tmp = header->sender;
     das_insert(node_data->nbrs, (void*)tmp);
+    path_oracle_invalidate(entity_data->oracle);
     return;
 }
 
@@ -505,7 +390,7 @@ void tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 
 #ifdef LOG_ROUTING
     PRINT_ROUTING("[RTG] sending optimal path packet from %d to %d\n",
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "dup_cache.h"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+//=====================================================================
+// - Internal helpers
+
+static uint64_t dup_hash(dup_key* key){
+    uint64_t h = ((uint64_t)(uint32_t)key->origin << 32) | key->seq;
+
+    h ^= (uint64_t)(uint32_t)key->direction * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static bool dup_equal(dup_key* l, dup_key* r){
+    return l->origin == r->origin && l->seq == r->seq &&
+	l->direction == r->direction;
+}
+
+//---------------------------------------------------------------------
+// * Find Slot
+//---------------------------------------------------------------------
+// Table slot holding key, or the empty slot ending its probe sequence.
+//---------------------------------------------------------------------
+static int dup_find_slot(dup_cache* cache, dup_key* key){
+    int i = (int)(dup_hash(key) & cache->mask);
+
+    while(cache->slots[i] != 0 &&
+	!dup_equal(&cache->ring[cache->slots[i] - 1], key))
+	i = (i + 1) & cache->mask;
+    return i;
+}
+
+//---------------------------------------------------------------------
+// * Free Slot
+//---------------------------------------------------------------------
+// Empties slot i and moves back the entries after it that could no
+// longer be reached by probing from their home slot.
+//---------------------------------------------------------------------
+static void dup_free_slot(dup_cache* cache, int i){
+    int j = i;
+
+    while(true){
+	int home;
+	j = (j + 1) & cache->mask;
+	if(cache->slots[j] == 0) break;
+
+	home = (int)(dup_hash(&cache->ring[cache->slots[j] - 1]) &
+	    cache->mask);
+	//home cyclically in (i, j]: the entry is still reachable
+	if(i <= j ? (home > i && home <= j) : (home > i || home <= j))
+	    continue;
+	cache->slots[i] = cache->slots[j];
+	i = j;
+    }
+    cache->slots[i] = 0;
+}
+
+//=====================================================================
+// - Creation/destruction
+
+dup_cache* create_dup_cache(int capacity){
+    dup_cache* cache = NULL;
+    int size = 2;
+
+    if(capacity <= 0) capacity = DUP_CACHE_DEFAULT_CAPACITY;
+    //keep the table at most half full
+    while(size < 2 * capacity) size <<= 1;
+
+    if((cache = NEW(dup_cache)) == NULL) return NULL;
+    cache->slots = calloc(size, sizeof(int));
+    cache->ring = malloc(capacity * sizeof(dup_key));
+    if(cache->slots == NULL || cache->ring == NULL){
+	free(cache->slots);
+	free(cache->ring);
+	free(cache);
+	return NULL;
+    }
+    cache->capacity = capacity;
+    cache->count = 0;
+    cache->head = 0;
+    cache->mask = size - 1;
+
+    return cache;
+}
+
+void dup_cache_destroy(dup_cache* cache){
+    if(cache == NULL) return;
+
+    free(cache->slots);
+    free(cache->ring);
+    free(cache);
+}
+
+void dup_cache_clear(dup_cache* cache){
+    int i;
+
+    for(i = 0; i <= cache->mask; i++)
+	cache->slots[i] = 0;
+    cache->count = 0;
+    cache->head = 0;
+}
+
+//=====================================================================
+// - Lookup
+
+bool dup_cache_contains(dup_cache* cache, nodeid_t origin, uint32_t seq,
+    int direction){
+    dup_key key = {origin, seq, direction};
+
+    return cache->slots[dup_find_slot(cache, &key)] != 0;
+}
+
+//---------------------------------------------------------------------
+// * Seen
+//---------------------------------------------------------------------
+// Test-and-set: a new key is remembered, evicting the oldest one if
+// the cache is full.
+//---------------------------------------------------------------------
+bool dup_cache_seen(dup_cache* cache, nodeid_t origin, uint32_t seq,
+    int direction){
+    dup_key key = {origin, seq, direction};
+    int slot = dup_find_slot(cache, &key), index;
+
+    if(cache->slots[slot] != 0) return true;
+
+    if(cache->count == cache->capacity){
+	index = cache->head;
+	dup_free_slot(cache, dup_find_slot(cache, &cache->ring[index]));
+	cache->head = (cache->head + 1) % cache->capacity;
+	//the shift may have moved the probe end
+	slot = dup_find_slot(cache, &key);
+    }
+    else
+	index = cache->count++;
+
+    cache->ring[index] = key;
+    cache->slots[slot] = index + 1;
+
+    return false;
+}
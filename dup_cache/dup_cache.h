@@ -0,0 +1,61 @@
+//=====================================================================
+// ** Duplicate Cache
+//=====================================================================
+// Per-node record of the packets a forwarding module has already
+// handled, keyed on (origin, sequence number, direction). Flooding and
+// multicast forwarders ask it whether a copy is new instead of
+// scanning buffers or keeping a single "already sent" flag.
+//
+// Memory is bounded: the cache remembers the last capacity keys in a
+// ring, and an open-addressing (linear probing) table over the ring
+// answers lookups in O(1). When the ring is full the oldest key is
+// forgotten, its table slot being freed by backward shifting so that
+// no tombstones accumulate.
+//=====================================================================
+#ifndef __dup_cache__
+#define __dup_cache__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <include/modelutils.h>
+
+#define DUP_CACHE_DEFAULT_CAPACITY 64
+#define DUP_NO_DIRECTION 0
+
+//---------------------------------------------------------------------
+// * Identity of a packet copy
+
+typedef struct{
+    nodeid_t		origin;
+    uint32_t		seq;
+    int			direction;
+} dup_key;
+
+//---------------------------------------------------------------------
+// * Duplicate cache main data structure
+
+typedef struct{
+    int			capacity;	// keys remembered
+    int			count;
+    int			head;		// oldest key once the ring is full
+    int			mask;		// table size - 1
+    int*		slots;		// ring index + 1, 0 if empty
+    dup_key*		ring;
+} dup_cache;
+
+//-----------------------------------
+// - Duplicate Cache Methods
+//-----------------------------------
+dup_cache*	create_dup_cache(int capacity);
+void		dup_cache_destroy(dup_cache* cache);
+void		dup_cache_clear(dup_cache* cache);
+
+// - True if the key is remembered
+bool		dup_cache_contains(dup_cache* cache, nodeid_t origin,
+		    uint32_t seq, int direction);
+
+// - True if the key was already remembered, otherwise remembers it
+bool		dup_cache_seen(dup_cache* cache, nodeid_t origin,
+		    uint32_t seq, int direction);
+
+#endif //__dup_cache__
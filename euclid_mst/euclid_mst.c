@@ -0,0 +1,365 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <float.h>
+#include "euclid_mst.h"
+
+#define MST_UNQUEUED -1
+#define MST_IN_TREE -2
+
+//---------------------------------------------------------------------
+// * Delaunay triangle (vertex indices and circumcircle)
+
+typedef struct{
+    int		a, b, c;
+    double	cx, cy, r2;
+} mst_triangle;
+
+//=====================================================================
+// - Complete graph
+
+//---------------------------------------------------------------------
+// * Dense Prim
+//---------------------------------------------------------------------
+// Classic O(k^2) Prim keeping the best attachment distance per point
+// in a flat array. Returns 0, or -1 on allocation failure.
+//---------------------------------------------------------------------
+static int mst_prim_complete(position_t* points, int count, int* parent,
+    int* order){
+    double* key = malloc(count * sizeof(double));
+    bool* in_tree = malloc(count * sizeof(bool));
+    int i, j;
+
+    if(key == NULL || in_tree == NULL){
+	free(key);
+	free(in_tree);
+	return -1;
+    }
+
+    for(i = 0; i < count; i++){
+	key[i] = DBL_MAX;
+	in_tree[i] = false;
+	parent[i] = MST_NO_PARENT;
+    }
+    key[0] = 0;
+
+    for(i = 0; i < count; i++){
+	int u = -1;
+	for(j = 0; j < count; j++)
+	    if(!in_tree[j] && (u == -1 || key[j] < key[u])) u = j;
+
+	in_tree[u] = true;
+	order[i] = u;
+
+	for(j = 0; j < count; j++){
+	    if(in_tree[j]) continue;
+	    double dist = distance(&points[u], &points[j]);
+	    if(dist < key[j]){
+		key[j] = dist;
+		parent[j] = u;
+	    }
+	}
+    }
+
+    free(key);
+    free(in_tree);
+    return 0;
+}
+
+//=====================================================================
+// - Delaunay candidates
+
+//---------------------------------------------------------------------
+// * Circumcircle
+//---------------------------------------------------------------------
+// Fills the circumcircle of triangle t over vertices vx/vy. Returns
+// false for degenerate (collinear) triangles.
+//---------------------------------------------------------------------
+static bool mst_circumcircle(mst_triangle* t, double* vx, double* vy){
+    double ax = vx[t->a], ay = vy[t->a];
+    double bx = vx[t->b], by = vy[t->b];
+    double cx = vx[t->c], cy = vy[t->c];
+    double d = 2 * (ax * (by - cy) + bx * (cy - ay) + cx * (ay - by));
+
+    if(d == 0) return false;
+
+    double a2 = ax * ax + ay * ay;
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+
+    t->cx = (a2 * (by - cy) + b2 * (cy - ay) + c2 * (ay - by)) / d;
+    t->cy = (a2 * (cx - bx) + b2 * (ax - cx) + c2 * (bx - ax)) / d;
+    t->r2 = (ax - t->cx) * (ax - t->cx) + (ay - t->cy) * (ay - t->cy);
+    return true;
+}
+
+//---------------------------------------------------------------------
+// * Bowyer-Watson
+//---------------------------------------------------------------------
+// Triangulates the points inside a bounding super triangle and returns
+// the Delaunay edges as a CSR adjacency (adj_start has count + 1
+// entries). Returns 0, or -1 on allocation failure.
+//---------------------------------------------------------------------
+static int mst_delaunay(position_t* points, int count, int** adj_start,
+    int** adj){
+    int total = count + 3, size = 0, capacity = 4 * count + 8, i, j, k;
+    double *vx = malloc(total * sizeof(double));
+    double *vy = malloc(total * sizeof(double));
+    mst_triangle* tris = malloc(capacity * sizeof(mst_triangle));
+    int *edges = malloc(6 * capacity * sizeof(int));
+    bool *bad = malloc(capacity * sizeof(bool));
+    double min_x = DBL_MAX, min_y = DBL_MAX, max_x = -DBL_MAX,
+	max_y = -DBL_MAX;
+
+    *adj_start = NULL;
+    *adj = NULL;
+    if(vx == NULL || vy == NULL || tris == NULL || edges == NULL ||
+	bad == NULL)
+	goto fail;
+
+    for(i = 0; i < count; i++){
+	vx[i] = points[i].x;
+	vy[i] = points[i].y;
+	if(vx[i] < min_x) min_x = vx[i];
+	if(vx[i] > max_x) max_x = vx[i];
+	if(vy[i] < min_y) min_y = vy[i];
+	if(vy[i] > max_y) max_y = vy[i];
+    }
+
+    double span = (max_x - min_x > max_y - min_y ? max_x - min_x :
+	max_y - min_y) + 1;
+    double mid_x = (min_x + max_x) / 2, mid_y = (min_y + max_y) / 2;
+    vx[count] = mid_x - 20 * span;
+    vy[count] = mid_y - span;
+    vx[count + 1] = mid_x;
+    vy[count + 1] = mid_y + 20 * span;
+    vx[count + 2] = mid_x + 20 * span;
+    vy[count + 2] = mid_y - span;
+
+    tris[0].a = count;
+    tris[0].b = count + 1;
+    tris[0].c = count + 2;
+    mst_circumcircle(&tris[0], vx, vy);
+    size = 1;
+
+    for(i = 0; i < count; i++){
+	int num_edges = 0, kept = 0;
+
+	// triangles whose circumcircle holds the point
+	for(j = 0; j < size; j++){
+	    double dx = vx[i] - tris[j].cx, dy = vy[i] - tris[j].cy;
+	    bad[j] = dx * dx + dy * dy <= tris[j].r2;
+	}
+
+	// boundary of the cavity: edges of bad triangles used only once
+	for(j = 0; j < size; j++){
+	    if(!bad[j]) continue;
+	    int e[3][2] = {{tris[j].a, tris[j].b}, {tris[j].b, tris[j].c},
+		{tris[j].c, tris[j].a}};
+	    int m;
+	    for(m = 0; m < 3; m++){
+		bool shared = false;
+		for(k = 0; k < size && !shared; k++){
+		    if(k == j || !bad[k]) continue;
+		    int v[3] = {tris[k].a, tris[k].b, tris[k].c}, n;
+		    for(n = 0; n < 3; n++)
+			if((v[n] == e[m][0] && v[(n + 1) % 3] == e[m][1]) ||
+			    (v[n] == e[m][1] && v[(n + 1) % 3] == e[m][0]))
+			    shared = true;
+		}
+		if(!shared){
+		    edges[2 * num_edges] = e[m][0];
+		    edges[2 * num_edges + 1] = e[m][1];
+		    num_edges++;
+		}
+	    }
+	}
+
+	for(j = 0; j < size; j++)
+	    if(!bad[j]) tris[kept++] = tris[j];
+	size = kept;
+
+	if(size + num_edges > capacity){
+	    capacity = 2 * (size + num_edges);
+	    mst_triangle* grown_tris = realloc(tris,
+		capacity * sizeof(mst_triangle));
+	    int* grown_edges = realloc(edges, 6 * capacity * sizeof(int));
+	    bool* grown_bad = realloc(bad, capacity * sizeof(bool));
+	    if(grown_tris != NULL) tris = grown_tris;
+	    if(grown_edges != NULL) edges = grown_edges;
+	    if(grown_bad != NULL) bad = grown_bad;
+	    if(grown_tris == NULL || grown_edges == NULL || grown_bad == NULL)
+		goto fail;
+	}
+
+	for(j = 0; j < num_edges; j++){
+	    tris[size].a = edges[2 * j];
+	    tris[size].b = edges[2 * j + 1];
+	    tris[size].c = i;
+	    if(mst_circumcircle(&tris[size], vx, vy)) size++;
+	}
+    }
+
+    // CSR adjacency over real vertices only
+    if((*adj_start = calloc(count + 1, sizeof(int))) == NULL) goto fail;
+    for(j = 0; j < size; j++){
+	int v[3] = {tris[j].a, tris[j].b, tris[j].c};
+	for(k = 0; k < 3; k++)
+	    if(v[k] < count && v[(k + 1) % 3] < count){
+		(*adj_start)[v[k] + 1]++;
+		(*adj_start)[v[(k + 1) % 3] + 1]++;
+	    }
+    }
+    for(i = 0; i < count; i++) (*adj_start)[i + 1] += (*adj_start)[i];
+    if((*adj = malloc(((*adj_start)[count] + 1) * sizeof(int))) == NULL)
+	goto fail;
+    int* fill = malloc(count * sizeof(int));
+    if(fill == NULL) goto fail;
+    for(i = 0; i < count; i++) fill[i] = (*adj_start)[i];
+    for(j = 0; j < size; j++){
+	int v[3] = {tris[j].a, tris[j].b, tris[j].c};
+	for(k = 0; k < 3; k++)
+	    if(v[k] < count && v[(k + 1) % 3] < count){
+		(*adj)[fill[v[k]]++] = v[(k + 1) % 3];
+		(*adj)[fill[v[(k + 1) % 3]]++] = v[k];
+	    }
+    }
+    free(fill);
+
+    free(vx);
+    free(vy);
+    free(tris);
+    free(edges);
+    free(bad);
+    return 0;
+
+fail:
+    free(vx);
+    free(vy);
+    free(tris);
+    free(edges);
+    free(bad);
+    free(*adj_start);
+    free(*adj);
+    *adj_start = NULL;
+    *adj = NULL;
+    return -1;
+}
+
+//---------------------------------------------------------------------
+// * Binary heap on key[], indexed by point
+//---------------------------------------------------------------------
+static void mst_heap_up(int* heap, int* pos, double* key, int i){
+    int point = heap[i];
+
+    while(i > 0 && key[heap[(i - 1) / 2]] > key[point]){
+	heap[i] = heap[(i - 1) / 2];
+	pos[heap[i]] = i;
+	i = (i - 1) / 2;
+    }
+    heap[i] = point;
+    pos[point] = i;
+}
+
+static void mst_heap_down(int* heap, int* pos, double* key, int size, int i){
+    int point = heap[i];
+
+    while(2 * i + 1 < size){
+	int child = 2 * i + 1;
+	if(child + 1 < size && key[heap[child + 1]] < key[heap[child]])
+	    child++;
+	if(key[heap[child]] >= key[point]) break;
+	heap[i] = heap[child];
+	pos[heap[i]] = i;
+	i = child;
+    }
+    heap[i] = point;
+    pos[point] = i;
+}
+
+//---------------------------------------------------------------------
+// * Sparse Prim
+//---------------------------------------------------------------------
+// Prim with a decrease-key heap over the Delaunay adjacency. Returns
+// the number of points reached, or -1 on allocation failure.
+//---------------------------------------------------------------------
+static int mst_prim_delaunay(position_t* points, int count, int* parent,
+    int* order){
+    int *adj_start = NULL, *adj = NULL, size = 0, reached = 0, i;
+    double* key = malloc(count * sizeof(double));
+    int* heap = malloc(count * sizeof(int));
+    int* pos = malloc(count * sizeof(int));
+
+    if(key == NULL || heap == NULL || pos == NULL ||
+	mst_delaunay(points, count, &adj_start, &adj) == -1){
+	free(key);
+	free(heap);
+	free(pos);
+	return -1;
+    }
+
+    for(i = 0; i < count; i++){
+	key[i] = DBL_MAX;
+	pos[i] = MST_UNQUEUED;
+	parent[i] = MST_NO_PARENT;
+    }
+    key[0] = 0;
+    heap[size++] = 0;
+    pos[0] = 0;
+
+    while(size > 0){
+	int u = heap[0];
+
+	pos[u] = MST_IN_TREE;
+	order[reached++] = u;
+	if(--size > 0){
+	    heap[0] = heap[size];
+	    mst_heap_down(heap, pos, key, size, 0);
+	}
+
+	for(i = adj_start[u]; i < adj_start[u + 1]; i++){
+	    int v = adj[i];
+	    if(pos[v] == MST_IN_TREE) continue;
+
+	    double dist = distance(&points[u], &points[v]);
+	    if(dist >= key[v]) continue;
+	    key[v] = dist;
+	    parent[v] = u;
+	    if(pos[v] == MST_UNQUEUED){
+		heap[size] = v;
+		mst_heap_up(heap, pos, key, size++);
+	    }
+	    else
+		mst_heap_up(heap, pos, key, pos[v]);
+	}
+    }
+
+    free(adj_start);
+    free(adj);
+    free(key);
+    free(heap);
+    free(pos);
+    return reached;
+}
+
+//=====================================================================
+// - Public entry point
+
+//---------------------------------------------------------------------
+// * Euclidean MST
+//---------------------------------------------------------------------
+// Spans points[0..count) from points[0]. parent[i] receives the index
+// i attaches to (MST_NO_PARENT for the root) and order[] the indices
+// in the order they joined the tree. Returns 0, or -1 on failure.
+//---------------------------------------------------------------------
+int euclid_mst(position_t* points, int count, mst_candidates_e candidates,
+    int* parent, int* order){
+    if(points == NULL || parent == NULL || order == NULL || count <= 0)
+	return -1;
+
+    if(candidates == MST_DELAUNAY && count > 3){
+	int reached = mst_prim_delaunay(points, count, parent, order);
+	if(reached == count) return 0;
+    }
+
+    return mst_prim_complete(points, count, parent, order);
+}
@@ -0,0 +1,36 @@
+//=====================================================================
+// ** Euclidean Minimum Spanning Tree
+//=====================================================================
+// Prim's algorithm over a set of points rooted at points[0]. The
+// result is a parent array plus the order in which points joined the
+// tree, so callers can rebuild their own tree structures (children
+// attached in the same order the old incremental search produced).
+//
+// Two candidate edge sets are offered:
+//   MST_COMPLETE - every pair; array-scan Prim, O(k^2). Exact and the
+//                  fastest choice for the handful of geocast targets
+//                  the multicast modules usually carry.
+//   MST_DELAUNAY - edges of the 2D Delaunay triangulation (x, y only),
+//                  which always contain the Euclidean MST; heap Prim
+//                  over O(k) edges, O(k log k) once triangulated. The
+//                  triangulation is a plain Bowyer-Watson, so large k
+//                  and near-degenerate inputs should be measured; if
+//                  it does not span every point the complete graph is
+//                  used instead.
+//=====================================================================
+#ifndef __euclid_mst__
+#define __euclid_mst__
+
+#include <include/modelutils.h>
+
+#define MST_NO_PARENT -1
+
+typedef enum {MST_COMPLETE, MST_DELAUNAY} mst_candidates_e;
+
+//-----------------------------------
+// - Euclidean MST Methods
+//-----------------------------------
+int		euclid_mst(position_t* points, int count,
+		    mst_candidates_e candidates, int* parent, int* order);
+
+#endif //__euclid_mst__
@@ -0,0 +1,161 @@
+//=====================================================================
+// ** Face Table Microbenchmark
+//=====================================================================
+// Compares face_table_next with the per-hop gg list scan used by
+// next_on_face before it (acos, two distances and a cross product per
+// neighbor), on random neighborhoods of growing degree, and checks
+// that both pick the same neighbor. Standalone; from the repository
+// root:
+//
+//   gcc -O2 -I wsnet face_table/face_bench.c
+//	wsnet/libraries/das/list/das.c wsnet/libraries/mem_fs/malloc/mem_fs.c
+//	-lm -o face_bench && ./face_bench
+//=====================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <include/modelutils.h>
+#include "face_table.c"
+
+#define BENCH_NODES 200
+#define BENCH_QUERIES 200000
+
+double distance(position_t *position0, position_t *position1){
+    return sqrt((position0->x - position1->x) * (position0->x - position1->x) +
+	(position0->y - position1->y) * (position0->y - position1->y) +
+	(position0->z - position1->z) * (position0->z - position1->z));
+}
+
+//---------------------------------------------------------------------
+// * Legacy Scan
+//---------------------------------------------------------------------
+// next_on_face as it was, minus the module plumbing. Returns NULL
+// where it returned the reference node.
+//---------------------------------------------------------------------
+static destination_t* scan_next(void* gg_list, destination_t* start,
+    destination_t* nodeRef, bool right_hand){
+    destination_t *gg_nbr = NULL, *winner = NULL, *max = NULL;
+    double angle, angle_min = 180.0, angle_max = 0.0, vect, d1, d2;
+
+    das_init_traverse(gg_list);
+    while((gg_nbr = (destination_t*)das_traverse(gg_list)) != NULL){
+	bool result = false;
+	if(gg_nbr->id == nodeRef->id) continue;
+
+	position_t *temp_pos = &gg_nbr->position;
+	d1 = distance(&start->position, &nodeRef->position);
+	d2 = distance(&start->position, temp_pos);
+	angle = acos((double)(((start->position.x - nodeRef->position.x) *
+	    (start->position.x - temp_pos->x) + (start->position.y -
+	    nodeRef->position.y) * (start->position.y - temp_pos->y))
+	    / (d1 * d2)));
+	vect = (double)((temp_pos->x - start->position.x) *
+	    (nodeRef->position.y - start->position.y)) -
+	    (double)((temp_pos->y - start->position.y) *
+	    (nodeRef->position.x - start->position.x));
+	if((right_hand && vect >= 0) || (!right_hand && vect <= 0))
+	    result = true;
+
+	if(result && angle <= angle_min){
+	    angle_min = angle;
+	    winner = gg_nbr;
+	}
+	else if(!result && angle >= angle_max){
+	    angle_max = angle;
+	    max = gg_nbr;
+	}
+    }
+    return winner != NULL ? winner : max;
+}
+
+//continuous offsets: the old scan breaks exact angle ties by acos rounding
+static double bench_offset(void){
+    return 100.0 * rand() / RAND_MAX - 50.0;
+}
+
+static double elapsed(struct timespec* from, struct timespec* to){
+    return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+int main(void){
+    int degrees[] = {4, 8, 16, 32, 64}, d, i, k, q;
+    destination_t *starts = malloc(BENCH_NODES * sizeof(destination_t));
+    void **lists = malloc(BENCH_NODES * sizeof(void*));
+    face_table **tables = malloc(BENCH_NODES * sizeof(face_table*));
+    destination_t *tmp = NULL;
+
+    das_init();
+    srand(1);
+    printf("degree\tscan (ns/hop)\ttable (ns/hop)\tspeedup\tmismatches\n");
+    for(d = 0; d < (int)(sizeof(degrees) / sizeof(int)); d++){
+	struct timespec t0, t1, t2;
+	volatile long sink = 0;
+	int mismatches = 0;
+
+	for(i = 0; i < BENCH_NODES; i++){
+	    starts[i].id = i;
+	    starts[i].position.x = rand() % 1000;
+	    starts[i].position.y = rand() % 1000;
+	    starts[i].position.z = 0;
+	    lists[i] = das_create();
+	    tables[i] = create_face_table();
+	    for(k = 0; k < degrees[d]; k++){
+		tmp = malloc(sizeof(destination_t));
+		tmp->id = BENCH_NODES + k;
+		tmp->position.x = starts[i].position.x + bench_offset();
+		tmp->position.y = starts[i].position.y + bench_offset();
+		tmp->position.z = 0;
+		das_insert(lists[i], (void*)tmp);
+	    }
+	    face_table_build(tables[i], &starts[i].position, lists[i]);
+	}
+
+	//references are the node's own neighbors, as on a face walk
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(q = 0; q < BENCH_QUERIES; q++){
+	    i = q % BENCH_NODES;
+	    destination_t *ref = &tables[i]->entries[q % degrees[d]].nbr;
+	    destination_t *next = scan_next(lists[i], &starts[i], ref,
+		(q / BENCH_NODES) & 1);
+	    sink += next != NULL ? next->id : 0;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	for(q = 0; q < BENCH_QUERIES; q++){
+	    i = q % BENCH_NODES;
+	    destination_t *ref = &tables[i]->entries[q % degrees[d]].nbr;
+	    destination_t *next = face_table_next(tables[i],
+		&starts[i].position, lists[i], ref, (q / BENCH_NODES) & 1);
+	    sink += next != NULL ? next->id : 0;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	for(q = 0; q < BENCH_QUERIES; q++){
+	    i = q % BENCH_NODES;
+	    destination_t *ref = &tables[i]->entries[q % degrees[d]].nbr;
+	    destination_t *a = scan_next(lists[i], &starts[i], ref,
+		(q / BENCH_NODES) & 1);
+	    destination_t *b = face_table_next(tables[i],
+		&starts[i].position, lists[i], ref, (q / BENCH_NODES) & 1);
+	    if((a == NULL) != (b == NULL) || (a != NULL && a->id != b->id))
+		mismatches++;
+	}
+
+	printf("%d\t%.1f\t\t%.1f\t\t%.1fx\t%d\n", degrees[d],
+	    elapsed(&t0, &t1) * 1e9 / BENCH_QUERIES,
+	    elapsed(&t1, &t2) * 1e9 / BENCH_QUERIES,
+	    elapsed(&t0, &t1) / elapsed(&t1, &t2), mismatches);
+
+	for(i = 0; i < BENCH_NODES; i++){
+	    while((tmp = (destination_t*)das_pop(lists[i])) != NULL)
+		free(tmp);
+	    das_destroy(lists[i]);
+	    face_table_destroy(tables[i]);
+	}
+    }
+
+    free(starts);
+    free(lists);
+    free(tables);
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include "face_table.h"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+//=====================================================================
+// - Geometry
+
+//---------------------------------------------------------------------
+// * Pseudo-Angle
+//---------------------------------------------------------------------
+// Counter-clockwise angle of origin->to mapped onto [0, 4): 0 along
+// +x, 1 along +y, 2 along -x, 3 along -y. Monotonic in the true angle,
+// so it orders neighbors exactly like atan2 would. Returns -1 if the
+// two positions coincide in the plane.
+//---------------------------------------------------------------------
+double face_pseudo_angle(position_t* origin, position_t* to){
+    double dx = to->x - origin->x, dy = to->y - origin->y;
+    double norm = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy), p;
+
+    if(norm == 0) return -1;
+    p = dy / norm;
+    if(dx < 0) return 2 - p;
+    if(dy < 0) return 4 + p;
+    return p;
+}
+
+//=====================================================================
+// - Internal helpers
+
+static int compare_face_entries(const void* l, const void* r){
+    const face_entry *a = (const face_entry*)l, *b = (const face_entry*)r;
+
+    if(a->angle < b->angle) return -1;
+    if(a->angle > b->angle) return 1;
+    return a->order - b->order;
+}
+
+//---------------------------------------------------------------------
+// * Lower Bound
+//---------------------------------------------------------------------
+// Index of the first entry whose angle is >= (or > if strict) angle,
+// count if there is none.
+//---------------------------------------------------------------------
+static int face_table_bound(face_table* table, double angle, bool strict){
+    int lo = 0, hi = table->count;
+
+    while(lo < hi){
+	int mid = (lo + hi) / 2;
+	double a = table->entries[mid].angle;
+	if(a < angle || (strict && a == angle))
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    return lo;
+}
+
+//=====================================================================
+// - Creation/destruction
+
+face_table* create_face_table(void){
+    face_table* table = NEW(face_table);
+    if(table == NULL) return NULL;
+
+    table->valid = false;
+    table->count = 0;
+    table->capacity = 0;
+    table->entries = NULL;
+
+    return table;
+}
+
+void face_table_destroy(face_table* table){
+    if(table == NULL) return;
+
+    free(table->entries);
+    free(table);
+}
+
+//---------------------------------------------------------------------
+// * Invalidate
+//---------------------------------------------------------------------
+// Modules call this whenever they edit the gg list the table mirrors.
+//---------------------------------------------------------------------
+void face_table_invalidate(face_table* table){
+    if(table != NULL) table->valid = false;
+}
+
+//---------------------------------------------------------------------
+// * Build
+//---------------------------------------------------------------------
+// Sorts the gg list by pseudo-angle around origin. Neighbors sharing
+// the origin's position have no direction and are left out; equal
+// angles keep gg list order.
+//---------------------------------------------------------------------
+bool face_table_build(face_table* table, position_t* origin, void* gg_list){
+    destination_t *gg_nbr = NULL;
+    int size = das_getsize(gg_list), order = 0;
+
+    if(size > table->capacity){
+	face_entry *entries = realloc(table->entries,
+	    size * sizeof(face_entry));
+	if(entries == NULL){
+	    table->valid = false;
+	    return false;
+	}
+	table->entries = entries;
+	table->capacity = size;
+    }
+
+    table->count = 0;
+    das_init_traverse(gg_list);
+    while((gg_nbr = (destination_t*)das_traverse(gg_list)) != NULL){
+	double angle = face_pseudo_angle(origin, &gg_nbr->position);
+	if(angle < 0 || table->count == size) continue;
+
+	table->entries[table->count].nbr = *gg_nbr;
+	table->entries[table->count].angle = angle;
+	table->entries[table->count].order = order++;
+	table->count++;
+    }
+    qsort(table->entries, table->count, sizeof(face_entry),
+	compare_face_entries);
+
+    table->origin = *origin;
+    table->valid = true;
+
+    return true;
+}
+
+//=====================================================================
+// - Lookup
+
+//---------------------------------------------------------------------
+// * Next On Face
+//---------------------------------------------------------------------
+// Same choice as the per-hop scan it replaces: the neighbor (other than
+// ref itself) reached first when turning from the origin->ref
+// direction, clockwise for the right hand rule and counter-clockwise
+// for the left hand rule. A neighbor aligned with ref is taken first
+// either way; among neighbors at the same angle, the one latest in gg
+// list order wins.
+//---------------------------------------------------------------------
+destination_t* face_table_next(face_table* table, position_t* origin,
+    void* gg_list, destination_t* ref, bool right_hand){
+    double angle;
+    int i, n, steps;
+
+    if(!table->valid || table->origin.x != origin->x ||
+	table->origin.y != origin->y || table->origin.z != origin->z){
+	if(!face_table_build(table, origin, gg_list)){
+	    fprintf(stderr, "[ERR] Couldn't allocate face table\n");
+	    return NULL;
+	}
+    }
+    if((n = table->count) == 0 ||
+	(angle = face_pseudo_angle(origin, &ref->position)) < 0)
+	return NULL;
+
+    if(right_hand){
+	//last entry at or before angle, wrapping around, walking down
+	i = face_table_bound(table, angle, true) - 1;
+	if(i < 0) i = n - 1;
+	for(steps = 0; steps < n; steps++, i = (i == 0 ? n - 1 : i - 1))
+	    if(table->entries[i].nbr.id != ref->id)
+		return &table->entries[i].nbr;
+	return NULL;
+    }
+
+    //first entry at or after angle, then the last of its equal-angle run
+    i = face_table_bound(table, angle, false);
+    if(i == n) i = 0;
+    for(steps = 0; steps < n; steps++, i = (i + 1) % n){
+	int last = i, j;
+	if(table->entries[i].nbr.id == ref->id) continue;
+
+	for(j = i + 1; j < n && table->entries[j].angle ==
+	    table->entries[i].angle; j++)
+	    if(table->entries[j].nbr.id != ref->id)
+		last = j;
+	return &table->entries[last].nbr;
+    }
+    return NULL;
+}
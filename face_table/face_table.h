@@ -0,0 +1,58 @@
+//=====================================================================
+// ** Face Table
+//=====================================================================
+// A node's planar (gg) neighbors sorted by polar angle around the
+// node, for the right/left hand rule of face routing. The angle is a
+// pseudo-angle (a monotonic function of the true angle computed with
+// one division and no trigonometry), so the successor of a reference
+// direction is found with a binary search instead of an acos, two
+// distances and a cross product per neighbor per hop.
+//
+// The table is rebuilt lazily on the first lookup after it has been
+// invalidated (the module added to or removed from the gg list) or
+// when the node is no longer where the table was built.
+//=====================================================================
+#ifndef __face_table__
+#define __face_table__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+//---------------------------------------------------------------------
+// * Neighbor with its pseudo-angle around the origin, in [0, 4)
+
+typedef struct{
+    destination_t	nbr;
+    double		angle;
+    int			order;
+} face_entry;
+
+//---------------------------------------------------------------------
+// * Face table main data structure
+
+typedef struct{
+    position_t		origin;
+    bool		valid;
+    int			count;
+    int			capacity;
+    face_entry*		entries;
+} face_table;
+
+//-----------------------------------
+// - Face Table Methods
+//-----------------------------------
+face_table*	create_face_table(void);
+void		face_table_destroy(face_table* table);
+void		face_table_invalidate(face_table* table);
+bool		face_table_build(face_table* table, position_t* origin,
+		    void* gg_list);
+
+// - Next neighbor turning clockwise (right hand) or counter-clockwise
+//   from ref, or NULL if ref is the only candidate
+destination_t*	face_table_next(face_table* table, position_t* origin,
+		    void* gg_list, destination_t* ref, bool right_hand);
+
+// - Geometry
+double		face_pseudo_angle(position_t* origin, position_t* to);
+
+#endif //__face_table__
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 
 #include <include/modelutils.h>
+#include "../geo_predicates/geo_predicates.c"
 //#define LOG_ROUTING
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -61,9 +62,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -1093,27 +1094,16 @@ intersection_e check_intersect(call_t *call, destination_t *source,
 {
     if(check_in_geocast(dest, next))
 	return INTERSECTION;
+    //otherwise an edge reaching the region is a juncture as well
     if(!check_in_geocast(dest, source))
     {
-	destination_t corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
+	position_t low = dest->position, high = dest->position;
+	low.x -= 1;
+	low.y -= 1;
+	high.x += 1;
+	high.y += 1;
+	if(geo_segment_meets_rect(get_node_position(call->node),
+	    &next->position, &low, &high))
 	    return INTERSECTION;
     }
 
@@ -1122,82 +1112,20 @@ intersection_e check_intersect(call_t *call, destination_t *source,
     if(next->id == source->id || call->node == source->id)
 	return NO_INT;
     position_t *current_pos = get_node_position(call->node);
-    //calculate 3-dimensional cross products of source-current vector and
-    //source-destination vector and the source-prev vector and
-    //source-destination vector
-    double vect1 = ((current_pos->x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((current_pos->y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    double vect2 = ((next->position.x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((next->position.y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    //if BOTH vectors have the same sign, they are BOTH on the same side of the
-    //source-destination line, don't change face
-    if((vect1 < 0 && vect2 < 0) || (vect1 > 0 && vect2 >0))
-	return NO_INT;
 
-    //check to see if current-next and source-destination intersect
-    double a1, a2, b1, b2, c1, c2, det, x, y, dist;
-
-    //get formulas for the two lines the line segments are part of in
-    //Ax + By = C form
-    a1 = dest->position.y - source->position.y;
-    b1 = source->position.x - dest->position.x;
-    c1 = a1 * source->position.x + b1 * source->position.y;
-    a2 = next->position.y - current_pos->y;
-    b2 = current_pos->x - next->position.x;
-    c2 = a2 * current_pos->x + b2 * current_pos->y;
-
-    //if determinant of the two formulas is 0, lines are parallel, check for
-    //overlap of the x coordinates unless source-destination is a vertical
-    //line, then check y coordinates
-    if((det = a1 * b2 - a2 * b1) == 0)
-    {
-	//if(source-destination isn't vertical && min(x)(source-destination) <
-	//max(x)(prev-current) && max(x)(source-destination) >
-	//min(x)(prev-current) || source-destination is vertical &&
-	//min(y)(source-destination) < max(y)(prev-current) &&
-	//max(y)(source-destination) > min(y)(prev-current)
-	if((source->position.x - dest->position.x != 0 &&
-	    fmin(source->position.x, dest->position.x) <
-	    fmax(current_pos->x, next->position.x) &&
-	    fmax(source->position.x, dest->position.x) >
-	    fmin(current_pos->x, next->position.x)) ||
-	    (source->position.x - dest->position.x == 0 &&
-	    fmin(source->position.y, dest->position.y) <
-	    fmax(current_pos->y, next->position.y) &&
-	    fmax(source->position.y, dest->position.y) >
-	    fmin(current_pos->y, next->position.y)))
-	{
-	    return COLLINEAR;
-	}
-    }
-    //if lines are not parallel
-    else
+    //exact orientation tests of current-next against source-destination:
+    //a crossing at current is collinear, one at next is left to next
+    switch(geo_segment_cross(&source->position, &dest->position,
+	current_pos, &next->position))
     {
-	//apply Cramer's rule to solve for point of intersection
-	x = (b2 * c1 - b1 * c2)/det;
-	y = (a1 * c2 - a2 * c1)/det;
-
-	//if the length of the vectors formed by the difference of the
-	//destination and point of intersection and the source and point of
-	//intersection equal the length of the source-destination line segment,
-	//then the lines intersect 
-	dist = hypot((dest->position.x - x), (dest->position.y - y)) +
-	    hypot((source->position.x - x), (source->position.y - y));
-	if(((int)(distance(&source->position, &dest->position) * PRECISION)) ==
-	    (int)(dist * PRECISION))
-	{
-	    if(current_pos->x == x && current_pos->y == y)
-		return COLLINEAR;
-	    if(next->position.x == x && next->position.y == y)
-		return NO_INT;
+	case GEO_CROSS:
 	    return INTERSECTION;
-	}
+	case GEO_CROSS_AT_FROM:
+	case GEO_OVERLAP:
+	    return COLLINEAR;
+	default:
+	    return NO_INT;
     }
-    return NO_INT;
 }
 
 bool check_in_geocast(destination_t *region, destination_t *to_check)
@@ -1577,7 +1505,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == D_PACKET)
 	PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
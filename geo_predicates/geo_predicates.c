@@ -0,0 +1,231 @@
+#include <stdlib.h>
+#include <math.h>
+#include <stdbool.h>
+#include "geo_predicates.h"
+
+// (3 + 16 eps) eps with eps = 2^-53, see Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+#define GEO_CCW_ERRBOUND (3.0 + 16.0 * 0x1p-53) * 0x1p-53
+
+#define GEO_SIGN(value) ((value) > 0 ? 1 : ((value) < 0 ? -1 : 0))
+
+//=====================================================================
+// - Exact arithmetic
+
+//---------------------------------------------------------------------
+// * Two Sum / Two Product
+//---------------------------------------------------------------------
+// a + b == *sum + *err and a * b == *prod + *err exactly.
+//---------------------------------------------------------------------
+static void geo_two_sum(double a, double b, double* sum, double* err){
+    double x = a + b, b_virtual = x - a, a_virtual = x - b_virtual;
+
+    *sum = x;
+    *err = (a - a_virtual) + (b - b_virtual);
+}
+
+static void geo_two_product(double a, double b, double* prod, double* err){
+    *prod = a * b;
+    *err = fma(a, b, -*prod);
+}
+
+//---------------------------------------------------------------------
+// * Grow Expansion
+//---------------------------------------------------------------------
+// Adds b to the nonoverlapping expansion e (increasing magnitude) of
+// length e_len in place, dropping zero components. Returns the new
+// length; the sign of the sum is the sign of the last component.
+//---------------------------------------------------------------------
+static int geo_grow_expansion(double* e, int e_len, double b){
+    double q = b, sum, err;
+    int i, h_len = 0;
+
+    for(i = 0; i < e_len; i++){
+	geo_two_sum(q, e[i], &sum, &err);
+	q = sum;
+	if(err != 0) e[h_len++] = err;
+    }
+    if(q != 0 || h_len == 0) e[h_len++] = q;
+
+    return h_len;
+}
+
+//---------------------------------------------------------------------
+// * Exact Orientation
+//---------------------------------------------------------------------
+// (bx - ax)(cy - ay) - (by - ay)(cx - ax), expanded into six products
+// so that no rounded difference is ever formed.
+//---------------------------------------------------------------------
+static int geo_orient2d_exact(position_t* a, position_t* b, position_t* c){
+    double terms[6][2], e[12], prod, err;
+    int i, e_len = 0;
+
+    geo_two_product(b->x, c->y, &terms[0][0], &terms[0][1]);
+    geo_two_product(-b->x, a->y, &terms[1][0], &terms[1][1]);
+    geo_two_product(-a->x, c->y, &terms[2][0], &terms[2][1]);
+    geo_two_product(-b->y, c->x, &terms[3][0], &terms[3][1]);
+    geo_two_product(b->y, a->x, &terms[4][0], &terms[4][1]);
+    geo_two_product(a->y, c->x, &terms[5][0], &terms[5][1]);
+
+    for(i = 0; i < 6; i++){
+	prod = terms[i][0];
+	err = terms[i][1];
+	e_len = geo_grow_expansion(e, e_len, err);
+	e_len = geo_grow_expansion(e, e_len, prod);
+    }
+
+    return GEO_SIGN(e[e_len - 1]);
+}
+
+//=====================================================================
+// - Predicates
+
+//---------------------------------------------------------------------
+// * Orientation
+//---------------------------------------------------------------------
+int geo_orient2d(position_t* a, position_t* b, position_t* c){
+    double det_left = (b->x - a->x) * (c->y - a->y);
+    double det_right = (b->y - a->y) * (c->x - a->x);
+    double det = det_left - det_right, det_sum;
+
+    //opposite signs (or a zero) cannot cancel, the sign is exact
+    if(det_left > 0){
+	if(det_right <= 0) return GEO_SIGN(det);
+	det_sum = det_left + det_right;
+    }
+    else if(det_left < 0){
+	if(det_right >= 0) return GEO_SIGN(det);
+	det_sum = -det_left - det_right;
+    }
+    else
+	return GEO_SIGN(det);
+
+    if(det >= GEO_CCW_ERRBOUND * det_sum || -det >= GEO_CCW_ERRBOUND * det_sum)
+	return GEO_SIGN(det);
+    return geo_orient2d_exact(a, b, c);
+}
+
+//---------------------------------------------------------------------
+// * Segment Cross
+//---------------------------------------------------------------------
+// Classifies edge e against reference segment s. When e touches the
+// line of s with one end only, the crossing is reported at that end
+// (if it lies on s). Collinear segments overlap when their projections
+// on the x axis (y axis if s is vertical) overlap with positive
+// length.
+//---------------------------------------------------------------------
+geo_cross_e geo_segment_cross(position_t* s_from, position_t* s_to,
+    position_t* e_from, position_t* e_to){
+    int o_from = geo_orient2d(s_from, s_to, e_from);
+    int o_to = geo_orient2d(s_from, s_to, e_to);
+
+    //both ends strictly on the same side of s
+    if(o_from * o_to > 0)
+	return GEO_NO_CROSS;
+
+    if(o_from == 0 && o_to == 0){
+	bool vertical = s_from->x == s_to->x;
+	double s_min = vertical ? fmin(s_from->y, s_to->y) :
+	    fmin(s_from->x, s_to->x);
+	double s_max = vertical ? fmax(s_from->y, s_to->y) :
+	    fmax(s_from->x, s_to->x);
+	double e_min = vertical ? fmin(e_from->y, e_to->y) :
+	    fmin(e_from->x, e_to->x);
+	double e_max = vertical ? fmax(e_from->y, e_to->y) :
+	    fmax(e_from->x, e_to->x);
+
+	return s_min < e_max && s_max > e_min ? GEO_OVERLAP : GEO_NO_CROSS;
+    }
+
+    //both ends of s strictly on the same side of e
+    if(geo_orient2d(e_from, e_to, s_from) * geo_orient2d(e_from, e_to, s_to)
+	> 0)
+	return GEO_NO_CROSS;
+
+    if(o_from == 0)
+	return GEO_CROSS_AT_FROM;
+    if(o_to == 0)
+	return GEO_CROSS_AT_TO;
+    return GEO_CROSS;
+}
+
+//---------------------------------------------------------------------
+// * Segment Meets Rectangle
+//---------------------------------------------------------------------
+// True if edge e has a point in the closed axis-aligned rectangle
+// [low, high]: the bounding boxes overlap and the rectangle's corners
+// are not all strictly on one side of e.
+//---------------------------------------------------------------------
+bool geo_segment_meets_rect(position_t* e_from, position_t* e_to,
+    position_t* low, position_t* high){
+    position_t corners[4];
+    int i, side = 0;
+
+    if(fmax(e_from->x, e_to->x) < low->x ||
+	fmin(e_from->x, e_to->x) > high->x ||
+	fmax(e_from->y, e_to->y) < low->y ||
+	fmin(e_from->y, e_to->y) > high->y)
+	return false;
+
+    corners[0] = *low;
+    corners[1] = *low;
+    corners[1].x = high->x;
+    corners[2] = *high;
+    corners[3] = *high;
+    corners[3].x = low->x;
+    for(i = 0; i < 4; i++){
+	int o = geo_orient2d(e_from, e_to, &corners[i]);
+	if(o == 0 || (side != 0 && o != side))
+	    return true;
+	side = o;
+    }
+
+    return false;
+}
+
+//=====================================================================
+// - Batches
+
+//---------------------------------------------------------------------
+// * Segment Cross Batch
+//---------------------------------------------------------------------
+// results[i] = geo_segment_cross(s_from, s_to, &e_from[i], &e_to[i]).
+// Edges whose bounding box misses s's are settled without any
+// orientation test.
+//---------------------------------------------------------------------
+void geo_segment_cross_batch(position_t* s_from, position_t* s_to,
+    position_t* e_from, position_t* e_to, int count, geo_cross_e* results){
+    double x_min = fmin(s_from->x, s_to->x), x_max = fmax(s_from->x, s_to->x);
+    double y_min = fmin(s_from->y, s_to->y), y_max = fmax(s_from->y, s_to->y);
+    int i;
+
+    for(i = 0; i < count; i++){
+	if(fmax(e_from[i].x, e_to[i].x) < x_min ||
+	    fmin(e_from[i].x, e_to[i].x) > x_max ||
+	    fmax(e_from[i].y, e_to[i].y) < y_min ||
+	    fmin(e_from[i].y, e_to[i].y) > y_max)
+	    results[i] = GEO_NO_CROSS;
+	else
+	    results[i] = geo_segment_cross(s_from, s_to, &e_from[i],
+		&e_to[i]);
+    }
+}
+
+//---------------------------------------------------------------------
+// * Segment Meets Rectangle Batch
+//---------------------------------------------------------------------
+// Fills results (if not NULL) and returns how many edges meet the
+// rectangle.
+//---------------------------------------------------------------------
+int geo_segment_meets_rect_batch(position_t* e_from, position_t* e_to,
+    int count, position_t* low, position_t* high, bool* results){
+    int i, met = 0;
+
+    for(i = 0; i < count; i++){
+	bool meets = geo_segment_meets_rect(&e_from[i], &e_to[i], low, high);
+	if(results != NULL) results[i] = meets;
+	if(meets) met++;
+    }
+
+    return met;
+}
@@ -0,0 +1,57 @@
+//=====================================================================
+// ** Geometric Predicates
+//=====================================================================
+// Orientation, segment crossing and segment-vs-rectangle tests for
+// face routing junctures. Every answer is derived from the sign of
+// 2D orientation determinants rather than from an intersection point,
+// so no division, square root or PRECISION rounding is involved.
+//
+// The orientation test is filtered: the plain floating-point
+// determinant is trusted when it exceeds a forward error bound
+// (Shewchuk's ccwerrboundA), which is almost always; otherwise the
+// determinant is re-evaluated exactly as a floating-point expansion
+// (error-free products via fma and error-free sums), so nearly
+// collinear points get the right answer instead of a coin flip.
+//
+// Only x and y are considered. Batch versions test one reference
+// segment or rectangle against an array of edges, e.g. every planar
+// edge out of a node.
+//=====================================================================
+#ifndef __geo_predicates__
+#define __geo_predicates__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+//---------------------------------------------------------------------
+// * How edge e_from-e_to meets reference segment s_from-s_to
+
+typedef enum {
+    GEO_NO_CROSS,	// disjoint, or only touching at an end when collinear
+    GEO_CROSS,		// proper crossing, or crossing at an end of s
+    GEO_CROSS_AT_FROM,	// crossing point is e_from
+    GEO_CROSS_AT_TO,	// crossing point is e_to
+    GEO_OVERLAP		// collinear and overlapping
+} geo_cross_e;
+
+//-----------------------------------
+// - Geometric Predicates Methods
+//-----------------------------------
+// - +1 if c is left of a->b (counter-clockwise), -1 if right, 0 on it
+int		geo_orient2d(position_t* a, position_t* b, position_t* c);
+
+// - Segment tests
+geo_cross_e	geo_segment_cross(position_t* s_from, position_t* s_to,
+		    position_t* e_from, position_t* e_to);
+bool		geo_segment_meets_rect(position_t* e_from, position_t* e_to,
+		    position_t* low, position_t* high);
+
+// - Batches of edges
+void		geo_segment_cross_batch(position_t* s_from,
+		    position_t* s_to, position_t* e_from, position_t* e_to,
+		    int count, geo_cross_e* results);
+int		geo_segment_meets_rect_batch(position_t* e_from,
+		    position_t* e_to, int count, position_t* low,
+		    position_t* high, bool* results);
+
+#endif //__geo_predicates__
@@ -41,7 +41,7 @@ static const int BOUND = 50;
 
 static int ROUND = -1;
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
 
 #define TRUE 1
@@ -350,7 +350,7 @@ int call_back(call_t *call, void *args)
 
     fprintf(stderr, "Node %d, V: %f, alive:%d\n", call->node, context.voltage, is_node_alive(call->node));
 */
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     
     if(ROUND < BOUND){
         scheduler_add_callback(get_time() + DMI, call, call_back, NULL);
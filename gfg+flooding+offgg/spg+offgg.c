@@ -55,9 +55,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -1511,7 +1511,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == D_PACKET)
 	PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
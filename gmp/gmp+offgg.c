@@ -10,6 +10,9 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include "../linked_list/linked_list.c"
+#include "../steiner_tree/steiner_tree.c"
+#include "../geo_predicates/geo_predicates.c"
+#include "../packet_list/packet_list.c"
 
 #include <include/modelutils.h>
 
@@ -67,9 +70,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -106,27 +109,6 @@ typedef struct
     void *path;    
 }path_t;
 
-//Routing tree of multicast targets
-typedef struct tnode
-{
-    destination_t location;
-    struct tnode** children;
-    int child_count;
-    bool isVirtual;
-    bool isActive;
-} tree_node;
-
-//Tuple (root, steiner, left, right) for tree construction
-typedef struct
-{
-    tree_node* s;
-    tree_node* t;
-    tree_node* u;
-    tree_node* v;
-    double reduction_ratio;
-    bool active;
-} steiner_tuple;
-
 typedef struct
 {
     tree_node* pivot;
@@ -144,11 +126,15 @@ typedef struct
     mode_e mode;
     direction_e direction;
     int ttl;
-    void *path;
-    int target_count;
-    destination_t** target_list;
-    int destination_count;
-    destination_t** destination_list;
+    union{
+	struct{
+	    int path;		//inline path (packet_list), path_hop is the next hop
+	    int path_hop;
+	    int targets;	//inline targets left to reach (packet_list array)
+	    int destinations;	//inline bitmap of all targets (packet_list)
+	};
+	char list_wire[PLIST_WIRE_SIZE(2)];
+    };
     tree_node* root;
     bool face_mode;
     destination_t gmp_check_point;
@@ -175,6 +161,7 @@ typedef struct
     uint64_t dijk_latency;
     nodeid_t last_reached;
     void* paths;
+    steiner_cache* steiner;
 }entity_data_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -213,34 +200,8 @@ bool check_in_visited(void *visited, destination_t *to_check);
 visited_node_t* get_node(void *visited, nodeid_t to_get);
 bool check_node_in(void*, nodeid_t);
 
-// steiner tree construction functions
-tree_node* build_steiner_tree(destination_t* source, destination_t** target_list, int target_count);
-tree_node* generate_real_node(destination_t* target);
-tree_node* generate_virtual_node(position_t position);
-void add_child(tree_node* parent, tree_node* child);
-void remove_child(tree_node* parent, int child_index);
-double distance_sum(tree_node* node, position_t origin);
-int sub_target_count(tree_node* node);
-destination_t** sub_target_list(tree_node* node);
-void accumulate_target_list(tree_node* node, destination_t** target_list, int* current);
-steiner_tuple* generate_steiner_tuple(tree_node* root, tree_node* left, tree_node* right);
-int compare_steiner_tuples(const void* tuple1, const void* tuple2);
-void print_tree(tree_node* node, int tab);
-
-//steiner tree geometry functions
-double get_angle_single(position_t a);
-double get_angle_double(position_t a, position_t b);
-double get_angle_triple(position_t a, position_t b, position_t c);
-double get_acute_angle_triple(position_t a, position_t b, position_t c);
-position_t equillateral_third(position_t a, position_t b, position_t c);
-position_t get_intersection_point(position_t a1, position_t a2, position_t b1, position_t b2);	
-tree_node* steiner_point(tree_node* a, tree_node* b, tree_node* c);
-double compute_node_distance(tree_node* a, tree_node* b);
-double compute_distance(position_t a, position_t b);
-
 //routing functions - gmp
 void forward(call_t *call, packet_t *packet);
-bool check_in_target_list(destination_t** target_list, int target_count, destination_t* to_check);
 
 //routing functions - cfr/flood
 destination_t next_on_face(call_t *call, destination_t *start,
@@ -256,6 +217,7 @@ void forward_packet(call_t *call, packet_t *packet, direction_e direction);
 void deliver_packet(call_t *call, packet_t *packet);
 bool combine_packets(call_t *call, destination_t *sender,
     destination_t *next_node, direction_e direction);
+uint64_t buffer_key(call_t *call, packet_t *packet);
 bool flooding_packet(call_t *call, packet_t *packet);
 
 //tx
@@ -306,6 +268,14 @@ int init(call_t *call, void* params)
     entity_data->dijk_latency = 0;
     entity_data->last_reached = NONE;
 
+    if((entity_data->steiner = create_steiner_cache(RADIO_RANGE,
+	STEINER_CACHE_SLOTS)) == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate steiner tree cache\n");
+	free(entity_data);
+	return ERROR;
+    }
+
 #if defined LOG_TOPO_G || defined LOG_GG
     position_t *topo_pos = get_topology_area();
 
@@ -388,6 +358,11 @@ int destroy(call_t *call)
         fprintf(results, "%d\n", entity_data->num_reachable);
     }
 
+#ifdef LOG_ROUTING
+    fprintf(stderr, "[RTG] steiner cache: %d hits, %d misses\n",
+	entity_data->steiner->hits, entity_data->steiner->misses);
+#endif
+    steiner_cache_destroy(entity_data->steiner);
     free(entity_data);
     entity_data = NULL;
     if(results != NULL)
@@ -496,6 +471,8 @@ int bootstrap(call_t *call)
 
     //get mac header overhead to send to application layer for packet allocation
     node_data->overhead = GET_HEADER_SIZE(&call_down);
+    //let the mac index queued packets for combine_packets
+    SET_BUFFER_KEY(&call_down, call, buffer_key);
 
     planarize_graph(call);
 
@@ -509,6 +486,7 @@ int bootstrap(call_t *call)
 //in that module
 int set_header(call_t *call, packet_t *packet, destination_t *dest)
 {
+    entity_data_t *entity_data = ENTITY_DATA(call);
     node_data_t *node_data = NODE_DATA(call);
     header_t *header = PACKET_HEADER(packet, node_data);
     call_t call_down = CALL_DOWN(call);
@@ -522,37 +500,46 @@ int set_header(call_t *call, packet_t *packet, destination_t *dest)
     header->mode = GREEDY;
     header->direction = NO_DIR;
     header->ttl = DEFAULT_TTL;
-    header->path = NULL;
-    header->target_count = dest->id;
-    header->destination_count = dest->id;
-    header->target_list = malloc(sizeof(destination_t*) * header->target_count);
-    header->destination_list = malloc(sizeof(destination_t*) * header->destination_count);
+    header->path = PLIST_NONE;
+    header->path_hop = 0;
     header->face_mode = false;
     header->gmp_check_point = my_pos;
     header->gfg_check_point = my_pos;
 
     // Generate target list
-    int i = 0, di = 0;
-    destination_t* tmp = 0;
+    int i = 0, di = 0, target_count = dest->id;
+    destination_t* targets = malloc(sizeof(destination_t) * target_count);
+    destination_t** target_list = malloc(sizeof(destination_t*) *
+	target_count);
 
-    for(i = 0; i < header->target_count; i++){
+    for(i = 0; i < target_count; i++){
         if(i == my_pos.id){
 	    // Skip one ID if Source would be included as a target
 	    di++;
 	}
 
-	tmp = NEW(destination_t);
-	tmp->id = i + di;
-	tmp->position = *get_node_position(i + di);
-	header->target_list[i] = tmp;
-	header->destination_list[i] = tmp;
+	targets[i].id = i + di;
+	targets[i].position = *get_node_position(i + di);
+	target_list[i] = &targets[i];
     }
 
-    header->root = build_steiner_tree(&header->src, header->target_list, header->target_count);
+    // Targets travel inline with the packet (this moves packet->data)
+    int list = plist_add_targets(packet, target_list, target_count,
+	PLIST_BITMAP);
+    header = PACKET_HEADER(packet, node_data);
+    header->destinations = list;
+    list = plist_add_targets(packet, target_list, target_count,
+	PLIST_ARRAY);
+    header = PACKET_HEADER(packet, node_data);
+    header->targets = list;
+
+    header->root = steiner_cache_build(entity_data->steiner, &header->src, target_list, target_count);
 	
     //do_cds(call, dest);
-    if(start_dijk(call, dest, header->target_list, header->target_count, header->root) == ERROR)
+    if(start_dijk(call, dest, target_list, target_count, header->root) == ERROR)
 	fprintf(stderr, "[ERR] unable to start shortest path\n");
+    free(target_list);
+    free(targets);
 
     //also call set_header in mac layer to initialize mac header for the
     //packet as well
@@ -902,13 +889,15 @@ int start_dijk(call_t *call, destination_t* dest, destination_t** target_list, i
     header->type = DIJK_PACKET;
     header->direction = NO_DIR;
     header->ttl = 0;
-    header->target_list = target_list;
-    header->target_count = target_count;
     header->root = root;
+    header->path = PLIST_NONE;
+    header->path_hop = 0;
+    header->targets = PLIST_NONE;
+    header->destinations = PLIST_NONE;
 
     void* dests = das_create();
     for(i = 0; i < target_count; i++){
-        das_insert(dests, (void*)header->target_list[i]);
+        das_insert(dests, (void*)target_list[i]);
     }
 
     if((entity_data->paths = get_shortest_path(call, dests)) == NULL)
@@ -928,15 +917,18 @@ int start_dijk(call_t *call, destination_t* dest, destination_t** target_list, i
         if(i < das_getsize(entity_data->paths) - 1)
         {
             packet_2 = copy_packet(call, packet, header, DONT_INCREMENT);
+            int path = plist_add_path(packet_2, to_start->path);
             header_2 = PACKET_HEADER(packet_2, node_data);
-            header_2->path = to_start->path;
+            header_2->path = path;
             to_start->start = get_time() + i * PERIOD;
             scheduler_add_callback(get_time() + i * PERIOD, call, dijk_start,
                 (void*)packet_2);
         }
         else
         {
-            header->path = to_start->path;
+            int path = plist_add_path(packet, to_start->path);
+            header = PACKET_HEADER(packet, node_data);
+            header->path = path;
             to_start->start = get_time() + i * PERIOD;
             scheduler_add_callback(get_time() + i * PERIOD, call, dijk_start,
                 (void*)packet);
@@ -1117,7 +1109,7 @@ void tx(call_t *call, packet_t *packet)
 
     if(header->type == DIJK_PACKET)
     {
-        if(das_getsize(header->path) == 0)   
+        if(header->path_hop >= plist_count(packet, header->path))
         {
             entity_data_t *entity_data = ENTITY_DATA(call);
             path_t *tmp = NULL;
@@ -1136,7 +1128,8 @@ void tx(call_t *call, packet_t *packet)
         }
 
         destination_t my_pos = THIS_DESTINATION(call);
-        header->next_node.id = *((nodeid_t*)das_pop(header->path));
+        header->next_node.id = plist_path_hop(packet, header->path,
+            header->path_hop++);
         header->next_node.position = *get_node_position(header->next_node.id);
         header->sender = my_pos;
         if(set_mac_header_tx(call, packet) == ERROR)
@@ -1146,14 +1139,16 @@ void tx(call_t *call, packet_t *packet)
     }
 
 
-    if(header->target_count == 1){
+    if(plist_count(packet, header->targets) == 1){
+	destination_t* target = plist_array(packet, header->targets);
+
 	// If there is only a single target left, will be GFG routed directly to that target
-	if(!compare_destinations(&header->dest, header->target_list[0])){
-	    header->dest = *header->target_list[0];
+	if(!compare_destinations(&header->dest, target)){
+	    header->dest = *target;
 	}
 
 #ifdef LOG_ROUTING
-        fprintf(stderr, "[RTG] GFG routing single target %d at %d, headed for %d\n", header->target_list[0]->id, call->node, header->dest.id);
+        fprintf(stderr, "[RTG] GFG routing single target %d at %d, headed for %d\n", target->id, call->node, header->dest.id);
 #endif
 
 	gfg_forward(call, packet);
@@ -1175,6 +1170,7 @@ void tx(call_t *call, packet_t *packet)
 //basic packet forwarding
 void forward(call_t *call, packet_t *packet)
 {
+    entity_data_t *entity_data = ENTITY_DATA(call);
     node_data_t *node_data = NODE_DATA(call);
     header_t *header = PACKET_HEADER(packet, node_data);
     destination_t my_pos = THIS_DESTINATION(call);
@@ -1183,9 +1179,11 @@ void forward(call_t *call, packet_t *packet)
     int i, c, pivot_index = 0;
 
 #ifdef LOG_ROUTING
-    fprintf(stderr, "[RTG] target list(%d):\n", header->target_count);
-    for(i = 0; i < header->target_count; i++){
-	fprintf(stderr, "[RTG]   %d <%f, %f>\n", header->target_list[i]->id, header->target_list[i]->position.x, header->target_list[i]->position.y);
+    destination_t* targets = plist_array(packet, header->targets);
+
+    fprintf(stderr, "[RTG] target list(%d):\n", plist_count(packet, header->targets));
+    for(i = 0; i < plist_count(packet, header->targets); i++){
+	fprintf(stderr, "[RTG]   %d <%f, %f>\n", targets[i].id, targets[i].position.x, targets[i].position.y);
     }	    
 
     fprintf(stderr, "[RTG] steiner tree:\n");
@@ -1377,7 +1375,7 @@ void forward(call_t *call, packet_t *packet)
 	    double attempted_progress = compute_distance(first_target->position, header->dest.position);
 
 #ifdef LOG_ROUTING
-	    fprintf(stderr, "[RTG] %d/%d targets attempting greedy routing.\n", requested_targets, header->target_count);
+	    fprintf(stderr, "[RTG] %d/%d targets attempting greedy routing.\n", requested_targets, plist_count(packet, header->targets));
 	    fprintf(stderr, "[RTG] First target (%d|%f) attempting progress from previous check point (%d|%f)\n",
 		first_target->id, attempted_progress,
 		header->gmp_check_point.id, check_point);
@@ -1386,7 +1384,7 @@ void forward(call_t *call, packet_t *packet)
 	    // If collective greedy decisions are making any progress, or not all pivots are travelling in the
 	    // same direction, fulfill the requests. Otherwise, it is a continued face routing.
 
-	    bool all_one = requested_targets == header->target_count;
+	    bool all_one = requested_targets == plist_count(packet, header->targets);
 	    bool progress = attempted_progress < check_point;
 
 	    fprintf(stderr, "[RTG] progress:%d, all_one:%d\n", progress, all_one);
@@ -1435,9 +1433,14 @@ void forward(call_t *call, packet_t *packet)
 	    spawn_header->sender = my_pos;
 	    spawn_header->next_node = *(request->target);
 	    spawn_header->face_mode = false;
-	    spawn_header->target_list = vp;
-	    spawn_header->target_count = vp_count;
-	    spawn_header->root = build_steiner_tree(request->target, vp, vp_count);
+
+	    // Targets are the packet's last list, replace them in place
+	    plist_truncate(spawn_packet, spawn_header->targets);
+	    int list = plist_add_targets(spawn_packet, vp, vp_count, PLIST_ARRAY);
+	    spawn_header = PACKET_HEADER(spawn_packet, node_data);
+	    spawn_header->targets = list;
+	    spawn_header->root = steiner_cache_build(entity_data->steiner, request->target, vp, vp_count);
+	    free(vp);
 
 	    if(set_mac_header_tx(call, spawn_packet) == ERROR)
 		fprintf(stderr, "[ERR] Can't route GMP spawn.\n");
@@ -1497,11 +1500,15 @@ void forward(call_t *call, packet_t *packet)
 	    // Forward face-routing GMP packet
 	    header->sender = my_pos;
 	    header->face_mode = true;
-	    header->target_list = vp;
-	    header->target_count = vp_count;
-	    header->root = build_steiner_tree(&header->next_node, vp, vp_count);
 	    header->gmp_check_point = my_pos;
 
+	    plist_truncate(packet, header->targets);
+	    int list = plist_add_targets(packet, vp, vp_count, PLIST_ARRAY);
+	    header = PACKET_HEADER(packet, node_data);
+	    header->targets = list;
+	    header->root = steiner_cache_build(entity_data->steiner, &header->next_node, vp, vp_count);
+	    free(vp);
+
 	    if(set_mac_header_tx(call, packet) == ERROR)
 		fprintf(stderr, "[ERR] Can't route GMP-Face spawn.\n");
 
@@ -1515,7 +1522,9 @@ void forward(call_t *call, packet_t *packet)
 	fprintf(stderr, "[RTG] Appears to be a continued face routing; continuing routing to %d\n", face_next.id);
 #endif
 
-	header->root = build_steiner_tree(&face_next, header->target_list, header->target_count);
+	destination_t** target_view = plist_pointers(packet, header->targets);
+	header->root = steiner_cache_build(entity_data->steiner, &face_next, target_view, plist_count(packet, header->targets));
+	free(target_view);
 	face_forward(call, packet);
     }
 
@@ -1593,665 +1602,6 @@ void gfg_forward(call_t *call, packet_t *packet){
     return;
 }
 
-//
-// return whether a given destination is an intended multicast target
-bool check_in_target_list(destination_t** target_list, int target_count, destination_t* to_check)
-{
-    int i;
-    for(i = 0; i < target_count; i++){
-	if(compare_destinations(target_list[i], to_check)) return true;
-    }
-    return false;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// TREE FUNCTIONS
-
-// Build a Steiner tree out of a given list of real targets
-tree_node* build_steiner_tree(destination_t* source, destination_t** target_list, int target_count)
-{
-    int i, j, k, updated_target_count, updated_pair_count;
-
-    // Build root node
-    tree_node* root = generate_real_node(source);
-
-    // Step 1 - Create an array of steiner nodes for each target
-    tree_node** destinations = malloc(sizeof(tree_node*) * target_count);
-    for(i = 0; i < target_count; i++){
-        destinations[i] = generate_real_node(target_list[i]);
-    }
-
-    // Step 2 - Compute steiner tuples for every unique pair of targets (including pairs with
-    //		self), and the root
-    int pair_count = target_count * (target_count + 1) / 2;
-    steiner_tuple** pairs = malloc(sizeof(steiner_tuple*) * pair_count);
- 
-    for(i = 0, k = 0; i < target_count; i++){
-        for(j = 0; j < target_count; j++){
-	    if(destinations[i]->location.id <= destinations[j]->location.id){
-		pairs[k++] = generate_steiner_tuple(root, destinations[i], destinations[j]);
-	    }
-	}
-    }
-
-    // Step 3 - Sort Steiner Tuples by their reduction ratios in descending order
-    qsort(pairs, pair_count, sizeof(steiner_tuple*), compare_steiner_tuples);
-
-
-    tree_node* s = root;	// Current node being built upon - initially the root
-    tree_node* addition = NULL;	// New (virtual) node to be added to destinations 
-				// during cleanup after A9 is executed
-    bool clean = false;		// Flag signalling that the destinations and pairs
-				// arrays need to be cleaned of inactive nodes/tuples
-				// at the end of the round
-    bool clean_pairs = false;   // Similar to above flag, but for Steiner tuples pairs
-				// ONLY (when a single tuple is removed throught A5,A6-a,A7-a)
-
-    // Step 4 - Iteratively construct the tree
-    while(pair_count > 0){
-
-#ifdef DGB_STEINER
-    fprintf(stderr, "Remaining Sorted Steiner Tuples:\n");
-    for(i = 0; i < pair_count; i++){
-        fprintf(stderr, "    - Ratio %f <\n", pairs[i]->reduction_ratio);
-	fprintf(stderr, "       S:%d(%f, %f)\n", pairs[i]->s->location.id,
-		pairs[i]->s->location.position.x, pairs[i]->s->location.position.y);
-	fprintf(stderr, "       T:%d(%f, %f)\n", pairs[i]->t->location.id,
-		pairs[i]->t->location.position.x, pairs[i]->t->location.position.y);
-	fprintf(stderr, "       U:%d(%f, %f)\n", pairs[i]->u->location.id,
-		pairs[i]->u->location.position.x, pairs[i]->u->location.position.y);
-	fprintf(stderr, "       V:%d(%f, %f)\n", pairs[i]->v->location.id,
-		pairs[i]->v->location.position.x, pairs[i]->v->location.position.y);
-    }
-#endif
-        steiner_tuple* best = pairs[0];
-
-	// Choose conditional (prioritized) build action:
-	// A1 : IF u == v, then s adds u|v as child
-        if(best->u == best->v){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A1\n");
-#endif
-	    add_child(s, best->u);
-            clean = true;
-	}
-        // A2 : IF t is collocated with s, then s adds u and v as children
-        else if(best->t == s){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A2\n");
-#endif
-	    add_child(s, best->u);
-	    add_child(s, best->v);
-            clean = true;
-	}
-   	// A3 : IF t is collocated with u, then u adds v as child
-        else if(best->t == best->u){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A3\n");
-#endif
-	    add_child(best->u, best->v);
-	    clean = true;
-        }
-        // A4 : IF t is collocated with v, then v adds u as child
-        else if(best->t == best->v){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A4\n");
-#endif
-	    add_child(best->v, best->u);
-	    clean = true;
-        }
-	// A5 : IF d(s, u) < R && d(s, v) < R, then remove this tuple
-        else if(compute_node_distance(s, best->u) < RADIO_RANGE && compute_node_distance(s, best->v) < RADIO_RANGE){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A5\n");
-#endif
-	    // Deactivate (remove) the top (best) pair
-            best->active = false;
-	    clean_pairs = true;
-        }
-        // A6 : IF only d(s, u) < R :
-	else if(compute_node_distance(s, best->u) < RADIO_RANGE){
-	    // A6-a : IF R + d(t, u) + d(t, v) > d(s, u) + d(s, v), then remove this tuple
-	    if(RADIO_RANGE + compute_node_distance(best->t, best->u) + compute_node_distance(best->t, best->v) > compute_node_distance(s, best->u) + compute_node_distance(s, best->v)){
-#ifdef DGB_STEINER
-	    	fprintf(stderr, "[STN] A6-a\n");
-#endif
-	        // Deactivate (remove) the top (best) pair
-                best->active = false;
-		clean_pairs = true;
-            }
-	    // A6-b : ELSE u adds v as child
-	    else{
-#ifdef DGB_STEINER
-	    	fprintf(stderr, "[STN] A6-b\n");
-#endif
-		add_child(best->u, best->v);
-		clean = true;
-	   }
-	}
-        // A7 : IF only d(s, v) < R :
-	else if(compute_node_distance(s, best->v) < RADIO_RANGE){
-	    // A7-a : IF R + d(t, u) + d(t, v) > d(s, u) + d(s, v), then remove this tuple
-	    if(RADIO_RANGE + compute_node_distance(best->t, best->u) + compute_node_distance(best->t, best->v) > compute_node_distance(s, best->u) + compute_node_distance(s, best->v)){
-#ifdef DGB_STEINER
-	    	fprintf(stderr, "[STN] A7-a\n");
-#endif
-	        // Deactivate (remove) the top (best) pair
-                best->active = false;
-		clean_pairs = true;
-            }
-	    // A7-b : ELSE v adds u as child
-	    else{
-#ifdef DGB_STEINER
-	    	fprintf(stderr, "[STN] A7-b\n");
-#endif
-		add_child(best->v, best->u);
-		clean = true;
-	   }
-	}
-	// A8 : IF d(s, t) < R && R + d(t, u) + d(t, v) > d(s, u) + d(s, v), then s adds u and v as children
-	else if(compute_node_distance(s, best->t) < RADIO_RANGE
-	    && RADIO_RANGE + compute_node_distance(best->t, best->u) + compute_node_distance(best->t, best->v) > compute_node_distance(s, best->u) + compute_node_distance(s, best->v))
-        {
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] A8\n");
-#endif
-	    add_child(s, best->u);
-	    add_child(s, best->v);
-	    clean = true;
-        }
-        // AD : Final Default Action : s adds t, a virtual Steiner point, as its child, and t adds u and v as children
-	else{
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] AD\n");
-#endif
-	    add_child(best->t, best->u);
-	    add_child(best->t, best->v);
-
-	    addition = best->t;
-	    clean = true;
-	}
-
-	// End of build round
-	// Remove any deactivated nodes and pairs containing deactivated nodes, as well
-	// as add any virtual nodes and their computed steiner tuples
-	if(clean){
-#ifdef DGB_STEINER
-	    fprintf(stderr, "[STN] Cleaning round ...\n");
-	    if(addition != NULL){
- 	        fprintf(stderr, "[STN] Adding virtual node %d<%f, %f>\n", addition->location.id, addition->location.position.x, addition->location.position.y);
-	    }
-#endif
-	    // UPDATE DESTINATIONS ARRAY
-	    // Count the number of still active destinations, +1 if a new virtual node is to be added
-	    for(i = 0, updated_target_count = 0; i < target_count; i++){
-	    	if(destinations[i]->isActive) updated_target_count++;
-	    }
-	    if(addition != NULL) updated_target_count++;
-
-	    tree_node** updated_destinations = malloc(sizeof(tree_node*) * updated_target_count);
-	    // Retain only active destinations
-	    for(i = 0, j = 0; i < target_count; i++){
-	        if(destinations[i]->isActive){
-		    updated_destinations[j++] = destinations[i];
-		}
-	    }
-
-	    // Add new virtual node (if necessary)
-            if(addition != NULL){
-	    	updated_destinations[j] = addition;
-	    }
-
-	    destinations = updated_destinations;
-	    target_count = updated_target_count;
-	}
-
-	if(clean || clean_pairs){
-	    // UPDATE PAIRS ARRAY
-	    // Count the number of pairs with both u|v active, +N if a new virtual node is to be added
-	    for(i = 0, updated_pair_count = 0; i < pair_count; i++){
-	    	if(pairs[i]->active && (pairs[i]->u->isActive && pairs[i]->v->isActive)){
-		    updated_pair_count++;
-		}
-	    }
-	    if(addition != NULL) updated_pair_count += target_count;
-
-	    steiner_tuple** updated_pairs = malloc(sizeof(steiner_tuple*) * updated_pair_count);
-	    // Retain only active pairs
-	    for(i = 0, j = 0; i < pair_count; i++){
-	    	if(pairs[i]->active && (pairs[i]->u->isActive && pairs[i]->v->isActive)){
-		    updated_pairs[j++] = pairs[i];
-		}
-	    }
-
-	    // Add all pairs for virtual node (if necessary)
-            if(addition != NULL){
-		for(i = 0; i < target_count; i++){
-		    updated_pairs[j++] = generate_steiner_tuple(root, addition, destinations[i]);
-		}		
-	    }
-
-	    pairs = updated_pairs;
-	    pair_count = updated_pair_count;
-
-	    // Re-sort tuples for to include newly added pairs
-            if(addition != NULL){		
-    		qsort(pairs, pair_count, sizeof(steiner_tuple*), compare_steiner_tuples);
-            }
-
-	    clean = false;
-	    clean_pairs = false;
-	    addition = NULL;
-	}
-    }
-
-    return root;
-}
-
-// Create a tree tree out of a real target
-tree_node* generate_real_node(destination_t* target)
-{
-    tree_node* node = NEW(tree_node);
-    node->location = *target;
-    node->children = NULL;
-    node->child_count = 0;
-    node->isVirtual = false;
-    node->isActive = true;
-
-    return node;
-}
-
-// Create a tree tree out of a virtual target
-tree_node* generate_virtual_node(position_t position)
-{
-    tree_node* vnode = NEW(tree_node);
-    destination_t* vdest = NEW(destination_t);
-
-    // Generate a virtual destination: has ID == -3
-    vdest->id = -3;
-    vdest->position.x = position.x;
-    vdest->position.y = position.y;
-
-    vnode->location = *vdest;
-    vnode->children = NULL;
-    vnode->child_count = 0;
-    vnode->isVirtual = true;
-    vnode->isActive = true;
-
-    return vnode;
-}
-
-// Add a child node to a parent node's children list (and count)
-void add_child(tree_node* parent, tree_node* child)
-{
-    tree_node** children = parent->children;
-    int i = 0;
-
-    // Allocate a new child array of size + 1
-    parent->child_count++;
-    parent->children = malloc(sizeof(tree_node*) * parent->child_count);
-
-    // Copy over old child array to new larger array
-    if(children != NULL){
-        for(i = 0; i < parent->child_count - 1; i++){
-            parent->children[i] = children[i];
-        }
-    }
-
-    // Add the newest child at the end
-    parent->children[i] = child;
-
-    // Deactivate child from tree ownership consideration
-    child->isActive = false;
-}
-
-// Remove a child at a given index from a parent's child array
-void remove_child(tree_node* parent, int child_index)
-{
-    tree_node** children = parent->children;
-    int i, j;
-
-    // Allocate a new child array of size - 1
-    parent->child_count--;
-    parent->children = malloc(sizeof(tree_node*) * parent->child_count);
-
-    // Copy over each child from the original array, EXCEPT the designated orphan
-    for(i = 0, j = 0; i < parent->child_count; j++){
-        parent->children[i] = children[j];
-
-        // Continue for all but designated orphan
-        if(i != child_index) i++;
-    }
-}
-
-// Calculate the sum of the distance this node and all its non-virtual descendants and some origin
-double distance_sum(tree_node* node, position_t origin)
-{
-    double d = (node->isVirtual ? 0 : compute_distance(node->location.position, origin));
-
-    int i;
-    for(i = 0; i < node->child_count; i++){
-        d += distance_sum(node->children[i], origin);
-    }
-
-    return d;
-}
-
-// Calculate the number of non-virtual descendants (+ 1) of a given node
-int sub_target_count(tree_node* node)
-{
-    int total = 0, i;
-
-    if(!node->isVirtual) total++;
-
-    for(i = 0; i < node->child_count; i++){
-        total += sub_target_count(node->children[i]);
-    }
-
-    return total;
-}
-
-// Gather a cumulative list in target_list of all non-virtual descendants of node
-destination_t** sub_target_list(tree_node* node)
-{    
-    destination_t** target_list = malloc(sizeof(destination_t*) * sub_target_count(node));
-    int current = 0;
-
-    accumulate_target_list(node, target_list, &current);
-
-    return target_list;
-}
-
-// Recursively accumulate non-virtual descendants of node
-void accumulate_target_list(tree_node* node, destination_t** target_list, int* current)
-{
-    if(!node->isVirtual){
-        target_list[(*current)++] = &node->location;
-    }
-
-    int i;
-    for(i = 0; i < node->child_count; i++){
-        accumulate_target_list(node->children[i], target_list, current);
-    }
-}
-
-// Generate a tuple: (s, t, u, v), where s is the root of the steiner triple, u and v are
-// the "left" and "right" points, and t is the computed steiner point using s,u,v
-steiner_tuple* generate_steiner_tuple(tree_node* root, tree_node* left, tree_node* right)
-{
-    steiner_tuple* tuple = NEW(steiner_tuple);
-    tuple->s = root;
-    tuple->t = steiner_point(root, left, right);
-    tuple->u = left;
-    tuple->v = right;
-    tuple->active = true;
-
-    // compute reduction ratio for this tuple
-
-    double st = compute_node_distance(tuple->s, tuple->t);
-    double su = compute_node_distance(tuple->s, tuple->u);
-    double sv = compute_node_distance(tuple->s, tuple->v);
-    double tu = compute_node_distance(tuple->t, tuple->u);
-    double tv = compute_node_distance(tuple->t, tuple->v);
-
-#ifdef DGB_STEINER
-    fprintf(stderr, "[STN] calculating ratio ... \n");
-    fprintf(stderr, "[STN]    s<%f, %f> t<%f, %f> = %f\n",
-        tuple->s->location.position.x, tuple->s->location.position.y,
-	tuple->t->location.position.x, tuple->t->location.position.y,
-	st
-    );
-    fprintf(stderr, "[STN]    s<%f, %f> u<%f, %f> = %f\n",
-        tuple->s->location.position.x, tuple->s->location.position.y,
-	tuple->u->location.position.x, tuple->u->location.position.y,
-	su
-    );
-    fprintf(stderr, "[STN]    s<%f, %f> v<%f, %f> = %f\n",
-        tuple->s->location.position.x, tuple->s->location.position.y,
-	tuple->v->location.position.x, tuple->v->location.position.y,
-	sv
-    );
-    fprintf(stderr, "[STN]    t<%f, %f> u<%f, %f> = %f\n",
-	tuple->t->location.position.x, tuple->t->location.position.y,
-        tuple->u->location.position.x, tuple->u->location.position.y,
-	tu
-    );
-    fprintf(stderr, "[STN]    t<%f, %f> v<%f, %f> = %f\n",
-	tuple->t->location.position.x, tuple->t->location.position.y,
-        tuple->v->location.position.x, tuple->v->location.position.y,
-	tv
-    );
-#endif
-
-    tuple->reduction_ratio = 1.0 - (st + tu + tv) / (su + sv);
-
-#ifdef DGB_STEINER
-    fprintf(stderr, "[STN]      Ratio = %f\n", tuple->reduction_ratio);
-#endif
-
-    return tuple;
-}
-
-// Comparison function for sorting steiner tuples by their reduction ratios
-int compare_steiner_tuples(const void* tuple1, const void* tuple2)
-{
-    double ratio1 = (*((steiner_tuple**)tuple1))->reduction_ratio;
-    double ratio2 = (*((steiner_tuple**)tuple2))->reduction_ratio;
-
-    if(ratio1 > ratio2) return -1;
-    if(ratio1 < ratio2) return  1;
-    return 0;
-}
-
-// Print function for debugging trees
-void print_tree(tree_node* node, int tab)
-{
-    int i, t;
-
-    for(t = 0; t < tab * 3; t++) fprintf(stderr, " ");
-
-    fprintf(stderr, "<id: %d (%f, %f), active: %s, virtual: %s>\n",
-	node->location.id, node->location.position.x, node->location.position.y,
-        (node->isActive ? "YES" : "NO"),
-        (node->isVirtual ? "YES" : "NO")
-    );
-    for(i = 0; i < node->child_count; i++)
-	print_tree(node->children[i], tab + 1);
-
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Steiner Geometry Helper Functions
-
-// Get the counter-clockwise angle between a east-pointing vector to single point
-double get_angle_single(position_t a)
-{
-    return atan2(a.y, a.x);
-}
-
-// Get the counter-clockwise angle between two points
-double get_angle_double(position_t a, position_t b)
-{
-    return atan2(a.y - b.y, a.x - b.x);
-}
-
-// Get the counter-clockwise angle <ABC
-double get_angle_triple(position_t a, position_t b, position_t c)
-{
-    return atan2(c.y - b.y, c.x - b.x) - atan2(a.y - b.y, a.x - b.x);
-}
-
-// Get the acute angle <ABC
-double get_acute_angle_triple(position_t a, position_t b, position_t c)
-{
-    double angle = absolute_value(get_angle_triple(a, b, c));
-
-    // Choose acute side
-    if(angle > PI) angle = 2 * PI - angle;
-
-    return angle;
-}
-
-// Get the third point of an equillateral triangle formed by two points a and b,
-// angled so that the base formed by a and b is facing c.
-position_t get_equillateral_third(position_t a, position_t b, position_t c)
-{
-    // distance from A to B
-    double dAB = compute_distance(a, b);
-
-    // Clockwise angle from A to B
-    double AB = PI - get_angle_double(a, b);
-
-    // <BAC in radians
-    double BAC = get_angle_triple(b, a, c);
-
-    // rotate AB by 1/3 PI to get the angle of the third point on the equillateral
-    // triangle.
-    double shift = PI / 3;
-
-    // flip rotation if BAC is outside [0, 180] degree range, but not lower than -180
-    if(BAC < 0) shift *= -1;
-    if(absolute_value(BAC) > PI) shift *= -1;
-
-    AB += shift;
-
-    // Generate virtual node at the computed equillateral third
-    position_t equillateral_third;
-    equillateral_third.x = a.x + dAB * cos(AB);
-    equillateral_third.y = a.y - dAB * sin(AB);
-    equillateral_third.z = 0;
-
-    return equillateral_third;
-}
-
-// Calculate the steiner point of three tree nodes - the point which yields a 60-degree angle
-// between each adjacent pair of node locations and itself.
-tree_node* steiner_point(tree_node* a, tree_node* b, tree_node* c)
-{
-    double bac = get_acute_angle_triple(b->location.position, a->location.position, c->location.position);
-    double abc = get_acute_angle_triple(a->location.position, b->location.position, c->location.position);
-    double acb = get_acute_angle_triple(a->location.position, c->location.position, b->location.position);
-
-#ifdef DBG_STEINER
-    fprintf(stderr, "[STN] a : (%f, %f)\n", a->location.position.x, a->location.position.y);
-    fprintf(stderr, "[STN] b : (%f, %f)\n", b->location.position.x, b->location.position.y);
-    fprintf(stderr, "[STN] c : (%f, %f)\n", c->location.position.x, c->location.position.y);
-
-    fprintf(stderr, "[STN] bac : %f\n", bac);
-    fprintf(stderr, "[STN] abc : %f\n", abc);
-    fprintf(stderr, "[STN] acb : %f\n", acb);
-#endif
-
-    // 1) If two points are collocated (same position), steiner is the remaining third point
-    if(compare_positions(&a->location.position, &b->location.position)){
-        return c;
-    }
-    else if(compare_positions(&a->location.position, &c->location.position)){
-        return b;
-    }
-    else if(compare_positions(&b->location.position, &c->location.position)){
-        return a;
-    }
-    // 2) if the acute angle of any <XYZ is > 120 degrees, steiner is Y
-    else if(bac > 2 * PI / 3){
-        return a;
-    }
-    else if(abc > 2 * PI / 3){
-        return b;
-    }
-    else if(acb > 2 * PI / 3){
-        return c;
-    }
-    // 3) Compute the proper steiner point when all special cases checkout
-    else{
-        // Get third points on equillateral triangles formed by two pairs (third pair is uneccessary)
-        position_t ab = get_equillateral_third(a->location.position, b->location.position, c->location.position);
-        position_t ac = get_equillateral_third(a->location.position, c->location.position, b->location.position);
-        
-#ifdef DBG_STEINER
-	fprintf(stderr, "[STN] ab : (%f, %f)\n", ab.x, ab.y);
-	fprintf(stderr, "[STN] ac : (%f, %f)\n", ac.x, ac.y);
-#endif
-
-	// Compute intersection of the lines formed by each equillateral third and the remaining point
-        position_t steiner = get_intersection_point(ab, c->location.position, ac, b->location.position);
-
-#ifdef DBG_STEINER
-        fprintf(stderr, "[STN] st : (%f, %f)\n", steiner.x, steiner.y);
-#endif
-        return generate_virtual_node(steiner);
-    }
-}
-
-// Compute the distance between two steiner tree node locations
-double compute_node_distance(tree_node* a, tree_node* b){
-    return compute_distance(a->location.position, b->location.position);
-}
-
-// Compute the distance between two locations
-double compute_distance(position_t a, position_t b){
-    double dx = a.x - b.x;
-    double dy = a.y - b.y;
-
-    return sqrt(dx * dx + dy * dy);
-}
-
-// Get the point of intersection between the lines containing points a1+a2 and b1+b2
-position_t get_intersection_point(position_t a1, position_t a2, position_t b1, position_t b2)
-{
-#ifdef DBG_STEINER
-    fprintf(stderr, "[STN] Calculating intersection between L1<(%f, %f) - (%f, %f)>\n[STN]   and L2<(%f, %f) - (%f, %f)> ... \n",
-	a1.x, a1.y, a2.x, a2.y, b1.x, b1.y, b2.x, b2.y);
-#endif
-
-    position_t intersection;
-    intersection.z = 0;
-
-    // line slopes
-    double m1 = 0, m2 = 0;
-
-    // Calculate slope (if possible: non-vertical line)
-    if(a2.x != a1.x){
-        m1 = (a2.y - a1.y) / (a2.x - a1.x);
-    }
-
-    if(b2.x != b1.x){
-        m2 = (b2.y - b1.y) / (b2.x - b1.x);
-    }
-
-#ifdef DBG_STEINER
-    fprintf(stderr, "   M1: %f\n   M2: %f\n", m1, m2);
-#endif
-
-    // Check for vertical lines
-    if(a2.x == a1.x && b2.x == b1.x){
-        // if both lines are vertical, the lines are parallel and no point of intersection exists
-        intersection.x = 0;
-        intersection.y = 0;
-
-        fprintf(stderr, "[ERR] Tried to calculate the intersection of two parallel lines.");
-    }
-    else if(a2.x == a1.x){
-        intersection.x = a1.x;
-        intersection.y = m2 * (a1.x - b1.x) + b1.y;
-    }
-    else if(b2.x == b1.x){
-        intersection.x = b1.x;
-        intersection.y = m1 * (b1.x - a1.x) + a1.y;
-    }
-    else{
-        intersection.x = (a1.y - m1 * a1.x - b1.y + m2 * b1.x) / (m2 - m1);
-        intersection.y = (m1 * m2 * (b1.x - a1.x) - m1 * b1.y + m2 * a1.y) / (m2 - m1);
-    }
-
-#ifdef DBG_STEINER
-    fprintf(stderr, "[STN] intersection is: (%f, %f)\n", intersection.x, intersection.y);
-#endif
-
-    return intersection;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 // Routing Functions - Face traversal
 
@@ -2324,27 +1674,16 @@ intersection_e check_intersect(call_t *call, destination_t *source,
 {
     if(check_in_geocast(dest, next))
 	return INTERSECTION;
+    //otherwise an edge reaching the region is a juncture as well
     if(!check_in_geocast(dest, source))
     {
-	destination_t corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
+	position_t low = dest->position, high = dest->position;
+	low.x -= 1;
+	low.y -= 1;
+	high.x += 1;
+	high.y += 1;
+	if(geo_segment_meets_rect(get_node_position(call->node),
+	    &next->position, &low, &high))
 	    return INTERSECTION;
     }
 
@@ -2353,82 +1692,20 @@ intersection_e check_intersect(call_t *call, destination_t *source,
     if(next->id == source->id || call->node == source->id)
 	return NO_INT;
     position_t *current_pos = get_node_position(call->node);
-    //calculate 3-dimensional cross products of source-current vector and
-    //source-destination vector and the source-prev vector and
-    //source-destination vector
-    double vect1 = ((current_pos->x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((current_pos->y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    double vect2 = ((next->position.x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((next->position.y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    //if BOTH vectors have the same sign, they are BOTH on the same side of the
-    //source-destination line, don't change face
-    if((vect1 < 0 && vect2 < 0) || (vect1 > 0 && vect2 >0))
-	return NO_INT;
 
-    //check to see if current-next and source-destination intersect
-    double a1, a2, b1, b2, c1, c2, det, x, y, dist;
-
-    //get formulas for the two lines the line segments are part of in
-    //Ax + By = C form
-    a1 = dest->position.y - source->position.y;
-    b1 = source->position.x - dest->position.x;
-    c1 = a1 * source->position.x + b1 * source->position.y;
-    a2 = next->position.y - current_pos->y;
-    b2 = current_pos->x - next->position.x;
-    c2 = a2 * current_pos->x + b2 * current_pos->y;
-
-    //if determinant of the two formulas is 0, lines are parallel, check for
-    //overlap of the x coordinates unless source-destination is a vertical
-    //line, then check y coordinates
-    if((det = a1 * b2 - a2 * b1) == 0)
-    {
-	//if(source-destination isn't vertical && min(x)(source-destination) <
-	//max(x)(prev-current) && max(x)(source-destination) >
-	//min(x)(prev-current) || source-destination is vertical &&
-	//min(y)(source-destination) < max(y)(prev-current) &&
-	//max(y)(source-destination) > min(y)(prev-current)
-	if((source->position.x - dest->position.x != 0 &&
-	    fmin(source->position.x, dest->position.x) <
-	    fmax(current_pos->x, next->position.x) &&
-	    fmax(source->position.x, dest->position.x) >
-	    fmin(current_pos->x, next->position.x)) ||
-	    (source->position.x - dest->position.x == 0 &&
-	    fmin(source->position.y, dest->position.y) <
-	    fmax(current_pos->y, next->position.y) &&
-	    fmax(source->position.y, dest->position.y) >
-	    fmin(current_pos->y, next->position.y)))
-	{
-	    return COLLINEAR;
-	}
-    }
-    //if lines are not parallel
-    else
+    //exact orientation tests of current-next against source-destination:
+    //a crossing at current is collinear, one at next is left to next
+    switch(geo_segment_cross(&source->position, &dest->position,
+	current_pos, &next->position))
     {
-	//apply Cramer's rule to solve for point of intersection
-	x = (b2 * c1 - b1 * c2)/det;
-	y = (a1 * c2 - a2 * c1)/det;
-
-	//if the length of the vectors formed by the difference of the
-	//destination and point of intersection and the source and point of
-	//intersection equal the length of the source-destination line segment,
-	//then the lines intersect 
-	dist = hypot((dest->position.x - x), (dest->position.y - y)) +
-	    hypot((source->position.x - x), (source->position.y - y));
-	if(((int)(compute_distance(source->position, dest->position) * PRECISION)) ==
-	    (int)(dist * PRECISION))
-	{
-	    if(current_pos->x == x && current_pos->y == y)
-		return COLLINEAR;
-	    if(next->position.x == x && next->position.y == y)
-		return NO_INT;
+	case GEO_CROSS:
 	    return INTERSECTION;
-	}
+	case GEO_CROSS_AT_FROM:
+	case GEO_OVERLAP:
+	    return COLLINEAR;
+	default:
+	    return NO_INT;
     }
-    return NO_INT;
 }
 
 bool check_in_geocast(destination_t *region, destination_t *to_check)
@@ -2864,7 +2141,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == DIJK_PACKET)
 	PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
@@ -2882,6 +2159,14 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
     return true;
 }
 
+//key of a queued packet in the mac's buffer index (see combine_packets)
+uint64_t buffer_key(call_t *call, packet_t *packet)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    header_t *header = PACKET_HEADER(packet, node_data);
+    return BUFFER_KEY(header->type, header->sender.id, header->next_node.id);
+}
+
 //checks to see if packets can be combined to reduce number of packets
 //returns true if packets are combined, false otherwise
 bool combine_packets(call_t *call, destination_t *sender,
@@ -2891,11 +2176,10 @@ bool combine_packets(call_t *call, destination_t *sender,
 
     bool combined = false;
     call_t call_down = CALL_DOWN(call);
-    void *buffer = GET_BUFFER(&call_down);
-    void* new_buffer = das_create();
+    uint64_t key = BUFFER_KEY(DATA_PACKET, sender->id, next_node->id);
     buffer_entry_t *entry = NULL;
 
-    while((entry = (buffer_entry_t*)das_pop_FIFO(buffer)) != NULL)
+    while((entry = FIND_IN_BUFFER(&call_down, key, entry)) != NULL)
     {
 	header_t *header = PACKET_HEADER(entry->packet, node_data);
 	if(header->type == DATA_PACKET &&
@@ -2911,9 +2195,7 @@ bool combine_packets(call_t *call, destination_t *sender,
 #endif
 	    combined = true;
 	}
-	das_insert(new_buffer, (void*)entry);
     }
-    SET_BUFFER(&call_down, new_buffer);
     return combined;
 }
 
@@ -2939,7 +2221,8 @@ packet_t* copy_packet(call_t *call, packet_t *packet, header_t* header,
     copy_header->type = header->type;
     copy_header->direction = header->direction;
     copy_header->ttl = header->ttl;
-    copy_header->path = NULL;
+    copy_header->path = PLIST_NONE;
+    copy_header->path_hop = 0;
 
     if(operation != DONT_INCREMENT)
 	entity_data->num_packets++;
@@ -2967,13 +2250,22 @@ void rx(call_t *call, packet_t *packet)
 
     entity_data->total_num_hops++;
     header->ttl--;
+    // forwarding may resize (and move) or free the packet, so delivery is
+    // decided, and the delivered packet copied, before tx
+    bool deliver = plist_contains(packet, header->destinations, &me);
+    packet_t *received = NULL;
     if(header->ttl != 0)
     {
+	if(deliver)
+	    received = copy_packet(call, packet, header, DONT_INCREMENT);
+
 	// forward
 	tx(call, packet);
 
-	if(!check_in_target_list(header->destination_list, header->destination_count, &me))
+	if(!deliver)
 	    return;
+	packet = received;
+	header = PACKET_HEADER(packet, node_data);
     }
     else
     {
@@ -2981,7 +2273,7 @@ void rx(call_t *call, packet_t *packet)
 	fprintf(stderr, "[RTG] packet from %d to %d hit ttl\n",
 	    header->sender.id, call->node);
 #endif
-	if(!check_in_target_list(header->destination_list, header->destination_count, &me))
+	if(!deliver)
 	{
 	    packet_dealloc(packet);
 	    packet = NULL;
@@ -3005,6 +2297,8 @@ void rx(call_t *call, packet_t *packet)
 	packet_t *packet_up = copy_packet(call, packet, header, DONT_INCREMENT);
 	RX(&call_up, packet_up);
     }
+    if(received != NULL)
+	packet_dealloc(received);
     return;
 }
 
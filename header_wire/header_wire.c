@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "header_wire.h"
+
+//=====================================================================
+// - Internal helpers
+
+static void put_u16(uint8_t* buf, uint16_t value){
+    buf[0] = value & 0xff;
+    buf[1] = value >> 8;
+}
+
+static void put_u32(uint8_t* buf, uint32_t value){
+    put_u16(buf, value & 0xffff);
+    put_u16(buf + 2, value >> 16);
+}
+
+static uint16_t get_u16(const uint8_t* buf){
+    return (uint16_t)(buf[0] | (buf[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* buf){
+    return get_u16(buf) | ((uint32_t)get_u16(buf + 2) << 16);
+}
+
+//---------------------------------------------------------------------
+// * Fixed Point
+//---------------------------------------------------------------------
+// True (and *fixed set) if value is exactly fixed/HEADER_WIRE_PRECISION
+// for some 32-bit fixed.
+//---------------------------------------------------------------------
+static bool to_fixed(double value, int32_t* fixed){
+    double scaled = value * HEADER_WIRE_PRECISION;
+
+    if(!(scaled >= INT32_MIN && scaled <= INT32_MAX)) return false;
+    *fixed = (int32_t)lround(scaled);
+    return (double)*fixed / HEADER_WIRE_PRECISION == value;
+}
+
+//---------------------------------------------------------------------
+// * Tag
+//---------------------------------------------------------------------
+static uint8_t destination_tag(destination_t* dest){
+    uint8_t tag = 0;
+    int32_t fixed;
+
+    if(dest->id < INT16_MIN || dest->id > INT16_MAX)
+	tag |= HEADER_WIRE_WIDE_ID;
+
+    if(dest->id < 0 || dest->id >= get_node_count() ||
+	memcmp(&dest->position, get_node_position(dest->id),
+	sizeof(position_t)) != 0){
+	tag |= HEADER_WIRE_POSITION;
+	if(!to_fixed(dest->position.x, &fixed) ||
+	    !to_fixed(dest->position.y, &fixed) ||
+	    !to_fixed(dest->position.z, &fixed))
+	    tag |= HEADER_WIRE_RAW;
+    }
+
+    return tag;
+}
+
+//=====================================================================
+// - Destinations
+
+int header_wire_destination_size(destination_t* dest){
+    uint8_t tag = destination_tag(dest);
+    int size = 1 + (tag & HEADER_WIRE_WIDE_ID ? 4 : 2);
+
+    if(tag & HEADER_WIRE_POSITION)
+	size += 3 * (tag & HEADER_WIRE_RAW ? sizeof(double) : 4);
+    return size;
+}
+
+int header_wire_put_destination(uint8_t* buf, destination_t* dest){
+    uint8_t tag = destination_tag(dest);
+    double coords[3] = {dest->position.x, dest->position.y,
+	dest->position.z};
+    int len = 1, i;
+    int32_t fixed;
+
+    buf[0] = tag;
+    if(tag & HEADER_WIRE_WIDE_ID){
+	put_u32(buf + len, (uint32_t)dest->id);
+	len += 4;
+    }
+    else{
+	put_u16(buf + len, (uint16_t)dest->id);
+	len += 2;
+    }
+
+    if(!(tag & HEADER_WIRE_POSITION))
+	return len;
+
+    for(i = 0; i < 3; i++){
+	if(tag & HEADER_WIRE_RAW){
+	    memcpy(buf + len, &coords[i], sizeof(double));
+	    len += sizeof(double);
+	}
+	else{
+	    to_fixed(coords[i], &fixed);
+	    put_u32(buf + len, (uint32_t)fixed);
+	    len += 4;
+	}
+    }
+    return len;
+}
+
+int header_wire_get_destination(const uint8_t* buf, destination_t* dest){
+    uint8_t tag = buf[0];
+    double coords[3];
+    int len = 1, i;
+
+    if(tag & HEADER_WIRE_WIDE_ID){
+	dest->id = (int32_t)get_u32(buf + len);
+	len += 4;
+    }
+    else{
+	dest->id = (int16_t)get_u16(buf + len);
+	len += 2;
+    }
+
+    if(!(tag & HEADER_WIRE_POSITION)){
+	dest->position = *get_node_position(dest->id);
+	return len;
+    }
+
+    for(i = 0; i < 3; i++){
+	if(tag & HEADER_WIRE_RAW){
+	    memcpy(&coords[i], buf + len, sizeof(double));
+	    len += sizeof(double);
+	}
+	else{
+	    coords[i] = (double)(int32_t)get_u32(buf + len) /
+		HEADER_WIRE_PRECISION;
+	    len += 4;
+	}
+    }
+    dest->position.x = coords[0];
+    dest->position.y = coords[1];
+    dest->position.z = coords[2];
+    return len;
+}
+
+//=====================================================================
+// - Headers
+
+int header_wire_encode(uint8_t* buf, destination_t* dests, int count,
+    int type, int direction){
+    int len = 0, i;
+
+    for(i = 0; i < count; i++)
+	len += header_wire_put_destination(buf + len, &dests[i]);
+    buf[len++] = (uint8_t)type;
+    buf[len++] = (uint8_t)direction;
+    return len;
+}
+
+int header_wire_decode(const uint8_t* buf, destination_t* dests, int count,
+    int* type, int* direction){
+    int len = 0, i;
+
+    for(i = 0; i < count; i++)
+	len += header_wire_get_destination(buf + len, &dests[i]);
+    *type = buf[len++];
+    *direction = buf[len++];
+    return len;
+}
+
+int header_wire_size(destination_t* dests, int count){
+    int size = 2, i;
+
+    for(i = 0; i < count; i++)
+	size += header_wire_destination_size(&dests[i]);
+    return size;
+}
+
+//---------------------------------------------------------------------
+// * Charge
+//---------------------------------------------------------------------
+// Recomputed from packet->size every time, so charging a clone again
+// on the next hop doesn't accumulate.
+//---------------------------------------------------------------------
+void header_wire_charge(packet_t* packet, int header_size,
+    destination_t* dests, int count){
+    packet->real_size = 8 * (packet->size - header_size +
+	header_wire_size(dests, count));
+}
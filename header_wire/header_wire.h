@@ -0,0 +1,64 @@
+//=====================================================================
+// ** Header Wire Format
+//=====================================================================
+// Compact, lossless wire form of the destinations a routing header
+// carries. Every destination starts with a tag byte saying how it is
+// encoded:
+//
+//  - its id, 16 bits if it fits (node ids, NONE, BROADCAST_ADDR),
+//    32 bits otherwise
+//  - its position only if it can't be looked up, i.e. the id isn't a
+//    node or the position isn't that node's current one (geocast
+//    regions, EMPTY_POSITION, a sender set to the region). Coordinates
+//    are 32-bit fixed point in units of 1/HEADER_WIRE_PRECISION when
+//    that reproduces the double exactly, raw doubles otherwise.
+//
+// Decoding an encoded header gives back the exact same destinations,
+// so compare_destinations keeps working on decoded headers. A header
+// with four destinations, one of them a region, takes 26 bytes
+// instead of the 136 of its in-memory header_t.
+//
+// header_wire_charge sets a packet's real (over the air) size as if
+// its routing header had been sent in this form, which is how modules
+// built with COMPACT_HEADER account for it.
+//=====================================================================
+#ifndef __header_wire__
+#define __header_wire__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+// same scale as the routing modules' PRECISION
+#define HEADER_WIRE_PRECISION 100000
+
+// tag byte
+#define HEADER_WIRE_WIDE_ID	0x01	// 32-bit id
+#define HEADER_WIRE_POSITION	0x02	// position follows
+#define HEADER_WIRE_RAW		0x04	// position as three doubles
+
+// largest encoding of count destinations plus type and direction
+#define HEADER_WIRE_MAX_SIZE(count) (2 + (count) * (1 + 4 + 3 * 8))
+
+//-----------------------------------
+// - Header Wire Methods
+//-----------------------------------
+// - One destination, returning the bytes written/read
+int	header_wire_put_destination(uint8_t* buf, destination_t* dest);
+int	header_wire_get_destination(const uint8_t* buf, destination_t* dest);
+int	header_wire_destination_size(destination_t* dest);
+
+// - The count consecutive destinations starting at dests (e.g.
+//   &header->dest), then the packet type and direction
+int	header_wire_encode(uint8_t* buf, destination_t* dests, int count,
+	    int type, int direction);
+int	header_wire_decode(const uint8_t* buf, destination_t* dests,
+	    int count, int* type, int* direction);
+int	header_wire_size(destination_t* dests, int count);
+
+// - Real size of packet with its header_size byte routing header
+//   charged at its wire size
+void	header_wire_charge(packet_t* packet, int header_size,
+	    destination_t* dests, int count);
+
+#endif //__header_wire__
@@ -4,6 +4,95 @@
 #include "linked_list.h"
 
 #define NEW(type) malloc(sizeof(type))
+#define LIST_INDEX_MIN 16
+#define LIST_INDEX_AT(list, i) \
+    ((list)->index[((list)->index_first + (i)) & ((list)->index_capacity - 1)])
+
+//=====================================================================
+// - Position index
+
+//---------------------------------------------------------------------
+// * Reserve Index
+//---------------------------------------------------------------------
+// Makes room in the index for 'size' nodes, keeping their order.
+// Marks the index stale if memory runs out.
+//---------------------------------------------------------------------
+static void list_index_reserve(linked_list* list, int size){
+    list_node** index;
+    int capacity = list->index_capacity, i;
+
+    if(size <= capacity) return;
+    if(capacity == 0) capacity = LIST_INDEX_MIN;
+    while(capacity < size) capacity *= 2;
+
+    if((index = malloc(capacity * sizeof(list_node*))) == NULL){
+	list->index_valid = 0;
+	return;
+    }
+    if(list->index_valid){
+	for(i = 0; i < list->size; i++) index[i] = LIST_INDEX_AT(list, i);
+    }
+
+    free(list->index);
+    list->index = index;
+    list->index_capacity = capacity;
+    list->index_first = 0;
+}
+
+//---------------------------------------------------------------------
+// * Build Index
+//---------------------------------------------------------------------
+// Rebuilds a stale index from the nodes.
+//---------------------------------------------------------------------
+static void list_index_build(linked_list* list){
+    list_node* node;
+    int i = 0;
+
+    list->index_valid = 0;
+    list_index_reserve(list, list->size);
+    if(list->index_capacity < list->size) return;
+
+    list->index_first = 0;
+    for(node = list->front; node != NULL; node = node->next)
+	list->index[i++] = node;
+    list->index_valid = 1;
+}
+
+//---------------------------------------------------------------------
+// * Erase From Index
+//---------------------------------------------------------------------
+// Removes the node at 'position' from the index, shifting the shorter
+// side. Called before the list size is decremented.
+//---------------------------------------------------------------------
+static void list_index_erase(linked_list* list, int position){
+    int i;
+
+    if(position < list->size / 2){
+	for(i = position; i > 0; i--)
+	    LIST_INDEX_AT(list, i) = LIST_INDEX_AT(list, i - 1);
+	list->index_first = (list->index_first + 1) & (list->index_capacity - 1);
+    }
+    else{
+	for(i = position; i < list->size - 1; i++)
+	    LIST_INDEX_AT(list, i) = LIST_INDEX_AT(list, i + 1);
+    }
+}
+
+//---------------------------------------------------------------------
+// * Unlink Node
+//---------------------------------------------------------------------
+// Removes the given node from its list, leaving the index alone
+//---------------------------------------------------------------------
+static void list_unlink_node(linked_list* list, list_node* node){
+    if(node->prev != NULL) node->prev->next = node->next;
+    if(node->next != NULL) node->next->prev = node->prev;
+
+    if(list->front == node) list->front = node->next;
+    if(list->back == node) list->back = node->prev;
+    list->size--;
+
+    free(node);
+}
 
 //---------------------------------------------------------------------
 // * Create List
@@ -17,6 +106,10 @@ linked_list* create_linked_list(){
     list->size = 0;
     list->traverser = NULL;
     list->node_traverser = NULL;
+    list->index = NULL;
+    list->index_capacity = 0;
+    list->index_first = 0;
+    list->index_valid = 0;
 
     return list;
 }
@@ -55,34 +148,36 @@ void* list_at(linked_list* list, int position){
 //---------------------------------------------------------------------
 list_node* list_node_at(linked_list* list, int position){
     if(list == NULL) return NULL;
+    if(position < 0 || position >= list->size) return NULL;
 
-    list_node* node = NULL;
-    int i;
-
-    if(list == NULL) return node;
+    if(!list->index_valid) list_index_build(list);
+    if(list->index_valid) return LIST_INDEX_AT(list, position);
 
-    if(position <= list->size / 2){
-        // Search front to back
-        i = 0;
-	node = list->front;
+    // No memory for the index, walk
+    list_node* node = list->front;
+    while(position-- > 0) node = node->next;
 
-        while(node != NULL && i != position){
-	    node = node->next;
-	    i++;
-	}
-    }
-    else{
-        // Search back to front
-        i = list->size - 1;
-	node = list->back;
+    return node;
+}
 
-        while(node != NULL && i != position){
-	    node = node->prev;
-	    i--;
-	}
-    }
+//---------------------------------------------------------------------
+// * Reset Emptied List
+//---------------------------------------------------------------------
+// Resets a list whose nodes were all freed and releases its index, so
+// that the list may be freed or reused
+//---------------------------------------------------------------------
+static void list_clear_index(linked_list* list){
+    free(list->index);
+    list->index = NULL;
+    list->index_capacity = 0;
+    list->index_first = 0;
+    list->index_valid = 0;
 
-    return node;
+    list->front = NULL;
+    list->back = NULL;
+    list->size = 0;
+    list->traverser = NULL;
+    list->node_traverser = NULL;
 }
 
 //=====================================================================
@@ -104,6 +199,11 @@ void list_push_back(linked_list* list, void* item){
     if(list->back != NULL) list->back->next = new_node;
     list->back = new_node;
     if(list->front == NULL) list->front = new_node;
+
+    if(list->index_valid){
+	list_index_reserve(list, list->size + 1);
+	if(list->index_valid) LIST_INDEX_AT(list, list->size) = new_node;
+    }
     list->size++;
 }
 
@@ -123,6 +223,14 @@ void list_push_front(linked_list* list, void* item){
     if(list->front != NULL) list->front->prev = new_node;
     list->front = new_node;
     if(list->back == NULL) list->back = new_node;
+
+    if(list->index_valid){
+	list_index_reserve(list, list->size + 1);
+	if(list->index_valid){
+	    list->index_first = (list->index_first - 1) & (list->index_capacity - 1);
+	    list->index[list->index_first] = new_node;
+	}
+    }
     list->size++;
 }
 
@@ -142,6 +250,17 @@ void list_add_before(linked_list* list, list_node* node, void* item){
     node->prev = new_node;
 
     if(list->front == node) list->front = new_node;
+
+    if(list->index_valid){
+	if(list->front == new_node){
+	    list_index_reserve(list, list->size + 1);
+	    if(list->index_valid){
+		list->index_first = (list->index_first - 1) & (list->index_capacity - 1);
+		list->index[list->index_first] = new_node;
+	    }
+	}
+	else list->index_valid = 0;
+    }
     list->size++;
 }
 
@@ -161,6 +280,14 @@ void list_add_after(linked_list* list, list_node* node, void* item){
     node->next = new_node;
 
     if(list->back == node) list->back = new_node;
+
+    if(list->index_valid){
+	if(list->back == new_node){
+	    list_index_reserve(list, list->size + 1);
+	    if(list->index_valid) LIST_INDEX_AT(list, list->size) = new_node;
+	}
+	else list->index_valid = 0;
+    }
     list->size++;
 }
 
@@ -263,6 +390,8 @@ void list_clean(linked_list* list){
 
 	free(to_remove);
     }
+
+    list_clear_index(list);
 }
 
 //=====================================================================
@@ -310,7 +439,11 @@ void* list_pop_at(linked_list* list, int position){
     if(node == NULL) return NULL;
 
     void* item = node->data;
-    list_remove_node(list, node);
+    if(list->index_valid){
+	list_index_erase(list, position);
+	list_unlink_node(list, node);
+    }
+    else list_remove_node(list, node);
 
     return item;
 }
@@ -324,6 +457,20 @@ void list_remove(linked_list* list, void* item){
     if(list == NULL) return;
 
     list_node* node;
+    int i;
+
+    if(list->index_valid){
+	for(i = 0; i < list->size; i++){
+	    node = LIST_INDEX_AT(list, i);
+	    if(node->data == item){
+		list_index_erase(list, i);
+		list_unlink_node(list, node);
+		return;
+	    }
+	}
+	return;
+    }
+
     list_start_node_traversal(list);
     while((node = list_node_traverse(list)) != NULL){
         if(node->data == item) break;
@@ -341,14 +488,14 @@ void list_remove_node(linked_list* list, list_node* node){
     if(list == NULL) return;
 
     if(node != NULL){
-	if(node->prev != NULL) node->prev->next = node->next;
-	if(node->next != NULL) node->next->prev = node->prev;
-
-	if(list->front == node) list->front = node->next;
-	if(list->back == node) list->back = node->prev;
-	list->size--;
+	if(list->index_valid){
+	    if(list->front == node)
+		list->index_first = (list->index_first + 1) & (list->index_capacity - 1);
+	    else if(list->back != node)
+		list->index_valid = 0;
+	}
 
-        free(node);
+	list_unlink_node(list, node);
     }
 }
 
@@ -368,4 +515,6 @@ void list_clear(linked_list* list){
 
 	free(to_remove);
     }
+
+    list_clear_index(list);
 }
@@ -5,6 +5,13 @@
 // memory-proactive and passive removal. Specifically: "Active" removal
 // and clearing methods free the item(s) being removed. "Passive"
 // removes the items from the list only, with no memory frees.
+//
+// Positions are served by an index: a ring of node pointers in list
+// order, built by the first list_at and kept up to date by pushes and
+// pops at either end and by removals of items. Other insertions and
+// removals in the middle only mark it stale, and the next list_at
+// rebuilds it. list_at is therefore O(1) in loops that index the list
+// while pushing, popping or removing items.
 //=====================================================================
 
 //---------------------------------------------------------------------
@@ -25,6 +32,10 @@ typedef struct{
     int			size;
     list_node*		traverser;
     list_node*		node_traverser;
+    list_node**		index;		// ring of the nodes, NULL if none
+    int			index_capacity;	// power of 2
+    int			index_first;	// ring position of the front
+    int			index_valid;	// 0 if stale
 
 } linked_list;
 
@@ -6,6 +6,7 @@
 #include <stdbool.h>
 
 #include "include/modelutils.h"
+#include "../face_table/face_table.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -37,9 +38,9 @@ model_t model =
 #define DEFAULT_TTL 55
 #define PRECISION 1000000
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
         call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
         node_data->overhead)
@@ -111,6 +112,7 @@ typedef struct
 {
     void *nbrs;
     void *gg_list;
+    face_table *face;
     int overhead;
     bool received_packet;
 }node_data_t;
@@ -370,6 +372,15 @@ int setnode(call_t *call, void *params)
         node_data = NULL;
         return ERROR;
     }
+    if((node_data->face = create_face_table()) == NULL)
+    {
+        fprintf(stderr, "[ERR] Can't allocate face table in routing module\n");
+        das_destroy(node_data->nbrs);
+        das_destroy(node_data->gg_list);
+        free(node_data);
+        node_data = NULL;
+        return ERROR;
+    }
 
     node_data->received_packet = false;
     node_data->overhead = NONE;
@@ -405,6 +416,7 @@ int unsetnode(call_t *call)
     while((dest = (destination_t*)das_traverse(node_data->nbrs)) != NULL)
         free(dest);
     das_destroy(node_data->gg_list);
+    face_table_destroy(node_data->face);
 
     free(node_data);
     node_data = NULL;
@@ -1261,6 +1273,7 @@ void planarize_graph(call_t *call)
             tmp2 = NEW(destination_t);
             *tmp2 = *tmp;
             das_insert(node_data->gg_list, (void*)tmp2);
+            face_table_invalidate(node_data->face);
             tmp2 = NULL;
         }
     }
@@ -1355,53 +1368,18 @@ destination_t next_on_face(call_t *call, destination_t *start, destination_t
     *nodeRef, direction_e direction)
 {
     node_data_t *node_data = NODE_DATA(call);
-    destination_t *gg_nbr = NULL, winner = *start, max = *start,
-        none = NO_DESTINATION;
-    double angle, angle_min = 180.0, angle_max = 0.0, vect, d1, d2;
+    destination_t *winner = NULL, none = NO_DESTINATION;
 
     if(das_getsize(node_data->gg_list) == 0)
         return none;
 
-    das_init_traverse(node_data->gg_list);
-    while((gg_nbr = (destination_t*)das_traverse(node_data->gg_list)) != NULL)
-    {
-        bool result = false;
-        if(gg_nbr->id != nodeRef->id)
-        {
-            position_t *temp_pos = &gg_nbr->position;
-            d1 = distance(&start->position, &nodeRef->position);
-            d2 = distance(&start->position, temp_pos);
-            angle = acos((double)(((start->position.x - nodeRef->position.x) *
-                (start->position.x - temp_pos->x) + (start->position.y -
-                nodeRef->position.y) * (start->position.y - temp_pos->y))
-                / (d1 * d2)));
-
-            vect = (double)((temp_pos->x - start->position.x) *
-                (nodeRef->position.y - start->position.y)) -
-                (double)((temp_pos->y - start->position.y) *
-                (nodeRef->position.x - start->position.x));
-            if((direction == TRAVERSE_R && vect >= 0) || (direction ==
-                TRAVERSE_L && vect <= 0))
-                result = true;
-
-            if(result && angle <= angle_min)
-            {
-                angle_min = angle;
-                winner = *gg_nbr;
-            }
-            else if(!result && angle >= angle_max)
-            {
-                angle_max = angle;
-                max = *gg_nbr;
-            }
-        }
-    }
-    if(compare_destinations(&winner, start))
-        winner = max;
-    if(compare_destinations(&winner, start))
-        winner = *nodeRef;
-
-    return winner;
+    //gg neighbors are kept sorted by angle around start, so the right
+    //(clockwise) or left (counter-clockwise) hand successor of nodeRef
+    //is a binary search away
+    if((winner = face_table_next(node_data->face, &start->position,
+        node_data->gg_list, nodeRef, direction == TRAVERSE_R)) == NULL)
+        return *nodeRef;
+    return *winner;
 }
 
 intersection_e check_intersect(call_t *call, destination_t *next,
@@ -1671,7 +1649,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
         packet = NULL;
         return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == DIJK_PACKET)
         PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
@@ -10,6 +10,8 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include "../linked_list/linked_list.c"
+#include "../packet_list/packet_list.c"
+#include "../dup_cache/dup_cache.c"
 
 #include <include/modelutils.h>
 
@@ -66,9 +68,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -114,9 +116,15 @@ typedef struct
     destination_t next_node;
     packet_e type;
     int ttl;
-    void *path;
-    int target_count;
-    destination_t** target_list;
+    union{
+	struct{
+	    int path;		//inline path (packet_list), path_hop is the next hop
+	    int path_hop;
+	    int targets;	//inline target bitmap (packet_list)
+	};
+	char list_wire[PLIST_WIRE_SIZE(1)];
+    };
+    uint32_t seq;	//source sequence number, with src identifies the flood
 }header_t;
 
 //Global node data, used for tracking information known to node
@@ -126,7 +134,8 @@ typedef struct
     void *gg_list;
     int overhead;
     bool received_packet;
-    bool received_broadcast;
+    dup_cache *flooded;	//floods already forwarded by this node
+    uint32_t seq;
 }node_data_t;
 
 //Global entity data, used for tracking statistics
@@ -173,7 +182,6 @@ bool check_node_in(void*, nodeid_t);
 
 //routing functions - gmp
 void forward(call_t *call, packet_t *packet);
-bool check_in_target_list(destination_t** target_list, int target_count, destination_t* to_check);
 
 //tx
 void tx(call_t *call, packet_t *packet);
@@ -324,7 +332,7 @@ int setnode(call_t *call, void* params)
 	return ERROR;
     }
     node_data->received_packet = false;
-    node_data->received_broadcast = false;
+    node_data->seq = 0;
     //uncomment later if adding parameters to config file
     /*param_t *param;*/
 
@@ -345,6 +353,17 @@ int setnode(call_t *call, void* params)
 	node_data = NULL;
 	return ERROR;
     }
+    if((node_data->flooded = create_dup_cache(DUP_CACHE_DEFAULT_CAPACITY))
+	== NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate duplicate cache\nError in "
+	    "routing module\n");
+	das_destroy(node_data->gg_list);
+	das_destroy(node_data->nbrs);
+	free(node_data);
+	node_data = NULL;
+	return ERROR;
+    }
     node_data->overhead = NONE;
 
     /* uncomment if adding parameters later
@@ -394,6 +413,8 @@ int unsetnode(call_t *call)
 	free(dest);
     das_destroy(node_data->gg_list);
 
+    dup_cache_destroy(node_data->flooded);
+
     free(node_data);
     node_data = NULL;
     return 0;
@@ -435,30 +456,39 @@ int set_header(call_t *call, packet_t *packet, destination_t *dest)
     header->next_node = no_dest;
     header->type = DATA_PACKET;
     header->ttl = DEFAULT_TTL;
-    header->path = NULL;
-    header->target_count = dest->id;
-    header->target_list = malloc(sizeof(destination_t*) * header->target_count);
+    header->path = PLIST_NONE;
+    header->path_hop = 0;
+    header->seq = node_data->seq++;
 
     // Generate target list
-    int i = 0, di = 0;
-    destination_t* tmp = 0;
+    int i = 0, di = 0, target_count = dest->id;
+    destination_t* targets = malloc(sizeof(destination_t) * target_count);
+    destination_t** target_list = malloc(sizeof(destination_t*) *
+	target_count);
 
-    for(i = 0; i < header->target_count; i++){
+    for(i = 0; i < target_count; i++){
         if(i == my_pos.id){
 	    // Skip one ID if Source would be included as a target
 	    di++;
 	}
 
-	tmp = NEW(destination_t);
-	tmp->id = i + di;
-	tmp->position = *get_node_position(i + di);
-	header->target_list[i] = tmp;
+	targets[i].id = i + di;
+	targets[i].position = *get_node_position(i + di);
+	target_list[i] = &targets[i];
     }
 
+    // Targets travel inline with the packet (this moves packet->data)
+    int list = plist_add_targets(packet, target_list, target_count,
+	PLIST_BITMAP);
+    header = PACKET_HEADER(packet, node_data);
+    header->targets = list;
+
 	
     //do_cds(call, dest);
-    if(start_dijk(call, dest, header->target_list, header->target_count) == ERROR)
+    if(start_dijk(call, dest, target_list, target_count) == ERROR)
 	fprintf(stderr, "[ERR] unable to start shortest path\n");
+    free(target_list);
+    free(targets);
 
     //also call set_header in mac layer to initialize mac header for the
     //packet as well
@@ -600,12 +630,13 @@ int start_dijk(call_t *call, destination_t* dest, destination_t** target_list, i
     header->next_node = no_dest;
     header->type = DIJK_PACKET;
     header->ttl = 0;
-    header->target_list = target_list;
-    header->target_count = target_count;
+    header->path = PLIST_NONE;
+    header->path_hop = 0;
+    header->targets = PLIST_NONE;
 
     void* dests = das_create();
     for(i = 0; i < target_count; i++){
-        das_insert(dests, (void*)header->target_list[i]);
+        das_insert(dests, (void*)target_list[i]);
     }
 
     if((entity_data->paths = get_shortest_path(call, dests)) == NULL)
@@ -625,15 +656,18 @@ int start_dijk(call_t *call, destination_t* dest, destination_t** target_list, i
         if(i < das_getsize(entity_data->paths) - 1)
         {
             packet_2 = copy_packet(call, packet, header, DONT_INCREMENT);
+            int path = plist_add_path(packet_2, to_start->path);
             header_2 = PACKET_HEADER(packet_2, node_data);
-            header_2->path = to_start->path;
+            header_2->path = path;
             to_start->start = get_time() + i * PERIOD;
             scheduler_add_callback(get_time() + i * PERIOD, call, dijk_start,
                 (void*)packet_2);
         }
         else
         {
-            header->path = to_start->path;
+            int path = plist_add_path(packet, to_start->path);
+            header = PACKET_HEADER(packet, node_data);
+            header->path = path;
             to_start->start = get_time() + i * PERIOD;
             scheduler_add_callback(get_time() + i * PERIOD, call, dijk_start,
                 (void*)packet);
@@ -814,7 +848,7 @@ void tx(call_t *call, packet_t *packet)
 
     if(header->type == DIJK_PACKET)
     {
-        if(das_getsize(header->path) == 0)   
+        if(header->path_hop >= plist_count(packet, header->path))
         {
             entity_data_t *entity_data = ENTITY_DATA(call);
             path_t *tmp = NULL;
@@ -833,7 +867,8 @@ void tx(call_t *call, packet_t *packet)
         }
 
         destination_t my_pos = THIS_DESTINATION(call);
-        header->next_node.id = *((nodeid_t*)das_pop(header->path));
+        header->next_node.id = plist_path_hop(packet, header->path,
+            header->path_hop++);
         header->next_node.position = *get_node_position(header->next_node.id);
         header->sender = my_pos;
         if(set_mac_header_tx(call, packet) == ERROR)
@@ -842,13 +877,13 @@ void tx(call_t *call, packet_t *packet)
         return;
     }
 
-    if(!node_data->received_broadcast){
+    if(!dup_cache_seen(node_data->flooded, header->src.id, header->seq,
+	DUP_NO_DIRECTION)){
 #ifdef LOG_ROUTING
         fprintf(stderr, "[RTG]  Flooding at at %d\n", call->node);
 #endif
 
         forward(call, packet);
-	node_data->received_broadcast = true;
     }
 
 //getchar();
@@ -894,17 +929,6 @@ void forward(call_t *call, packet_t *packet)
     return;
 }
 
-//
-// return whether a given destination is an intended multicast target
-bool check_in_target_list(destination_t** target_list, int target_count, destination_t* to_check)
-{
-    int i;
-    for(i = 0; i < target_count; i++){
-	if(compare_destinations(target_list[i], to_check)) return true;
-    }
-    return false;
-}
-
 //attempts to set mac header, if successful, sends packet to mac module for
 //transmission
 //returns true (1) on success
@@ -938,7 +962,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == DIJK_PACKET)
 	PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
@@ -1000,7 +1024,8 @@ packet_t* copy_packet(call_t *call, packet_t *packet, header_t* header,
     copy_header->next_node = header->next_node;
     copy_header->type = header->type;
     copy_header->ttl = header->ttl;
-    copy_header->path = NULL;
+    copy_header->path = PLIST_NONE;
+    copy_header->path_hop = 0;
 
     if(operation != DONT_INCREMENT)
 	entity_data->num_packets++;
@@ -1033,7 +1058,7 @@ void rx(call_t *call, packet_t *packet)
 	// forward
 	tx(call, packet);
 
-	if(!check_in_target_list(header->target_list, header->target_count, &me))
+	if(!plist_contains(packet, header->targets, &me))
 	    return;
     }
     else
@@ -1042,7 +1067,7 @@ void rx(call_t *call, packet_t *packet)
 	fprintf(stderr, "[RTG] packet from %d to %d hit ttl\n",
 	    header->sender.id, call->node);
 #endif
-	if(!check_in_target_list(header->target_list, header->target_count, &me))
+	if(!plist_contains(packet, header->targets, &me))
 	{
 	    packet_dealloc(packet);
 	    packet = NULL;
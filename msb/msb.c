@@ -30,9 +30,9 @@ model_t model =
 #define NONE -2
 #define EMPTY_DESTINATION {NONE, {-1, -1, -1}}
 
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
 #define NEW(type) malloc(sizeof(type))
 
@@ -234,8 +234,7 @@ int call_back(call_t *call, void *args)
 
 int tx_start(call_t *call, void *args)
 {
-    call_t call_down = CALL_DOWN(call);
-    TX(&call_down, (packet_t*)args);
+    TX_DOWN(call, (packet_t*)args);
     return 0;
 }
 
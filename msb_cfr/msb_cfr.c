@@ -38,9 +38,9 @@ model_t model =
 #define NO_DESTINATION {NONE, EMPTY_POSITION}
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
         call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
         node_data->overhead)
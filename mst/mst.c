@@ -6,6 +6,7 @@
 #include <stdbool.h>
 
 #include "include/modelutils.h"
+#include "../euclid_mst/euclid_mst.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -30,11 +31,15 @@ model_t model =
 #define ERROR -1
 #define NONE -2
 
+//candidate edges for the target MST, MST_DELAUNAY pays off for large
+//target sets
+#define MST_CANDIDATES MST_COMPLETE
+
 #define GG_RANGE 1
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data +\
 	node_data->overhead)
@@ -55,13 +60,6 @@ typedef struct
     void *children;
 }tree_node_t;
 
-typedef struct
-{
-    destination_t *parent;
-    destination_t *to_add;
-    double distance;
-}winner_t;
-
 typedef struct
 {
     destination_t *sender;
@@ -94,8 +92,6 @@ int set_header(call_t*, packet_t*, destination_t*);
 void get_dests(call_t*, void*, int);
 bool check_node_in(void*, nodeid_t);
 tree_node_t* get_mst(call_t*, void*);
-winner_t get_shortest_dist(tree_node_t*, destination_t*);
-tree_node_t* get_branch(tree_node_t*, destination_t*);
 int get_header_size(call_t*);
 int get_header_real_size(call_t*);
 void planarize_graph(call_t*);
@@ -321,84 +317,61 @@ bool check_node_in(void* das, nodeid_t to_check)
 
 tree_node_t* get_mst(call_t *call, void* dests)
 {
-    destination_t my_pos = THIS_DESTINATION(call), none = NO_DESTINATION; 
-    void *added = das_create();
+    destination_t my_pos = THIS_DESTINATION(call), none = NO_DESTINATION,
+	*to_add = NULL;
+    int count = das_getsize(dests) + 1, i = 1;
+    destination_t *members = malloc(count * sizeof(destination_t));
+    position_t *points = malloc(count * sizeof(position_t));
+    tree_node_t **nodes = malloc(count * sizeof(tree_node_t*)),
+	*root = NULL;
+    int *parent = malloc(count * sizeof(int)),
+	*order = malloc(count * sizeof(int));
+
+    if(members == NULL || points == NULL || nodes == NULL || parent == NULL
+	|| order == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate MST scratch space\n");
+	goto done;
+    }
+
+    //source is point 0 and becomes the tree root
+    members[0] = my_pos;
+    das_init_traverse(dests);
+    while((to_add = (destination_t*)das_traverse(dests)) != NULL)
+	members[i++] = *to_add;
+    for(i = 0; i < count; ++i)
+	points[i] = members[i].position;
 
-    //init tree root to source node
-    tree_node_t *root = NEW(tree_node_t);
-    root->this = my_pos;
-    root->parent = none;
-    root->children = das_create();
+    if(euclid_mst(points, count, MST_CANDIDATES, parent, order) == ERROR)
+	goto done;
 
-    //find next closest not already added target and add to tree
-    while(das_getsize(added) < das_getsize(dests))
+    //attach targets in the order Prim added them, parents come first
+    for(i = 0; i < count; ++i)
     {
-	winner_t tmp, shortest;
-	shortest.distance = 0;
-	destination_t *to_add = NULL;
+	int idx = order[i];
 
-	das_init_traverse(dests);
-	while((to_add = (destination_t*)das_traverse(dests)) != NULL)
+	nodes[idx] = NEW(tree_node_t);
+	nodes[idx]->this = members[idx];
+	nodes[idx]->children = das_create();
+	if(parent[idx] == MST_NO_PARENT)
 	{
-	    if(!check_node_in(added, to_add->id))
-	    {
-		tmp = get_shortest_dist(root, to_add);
-		if(shortest.distance == 0 || tmp.distance < shortest.distance)
-		    shortest = tmp;
-	    }
+	    nodes[idx]->parent = none;
+	    root = nodes[idx];
 	}
-	tree_node_t *branch;
-	if((branch = get_branch(root, shortest.parent)) == NULL)
+	else
 	{
-	    fprintf(stderr, "[ERR] Parent not found in tree\n");
-	    delete_tree(root);
-	    return NULL;
+	    nodes[idx]->parent = members[parent[idx]];
+	    das_insert(nodes[parent[idx]]->children, (void*)nodes[idx]);
 	}
-	tree_node_t *new_child = NEW(tree_node_t);
-	new_child->this = *shortest.to_add;
-	new_child->parent = branch->this;
-	new_child->children = das_create();
-	das_insert(branch->children, (void*)new_child);
-	new_child = NULL;
-	das_insert(added, (void*)shortest.to_add);
     }
-    return root;
-}
 
-winner_t get_shortest_dist(tree_node_t *root, destination_t *to_add)
-{
-    winner_t to_return, tmp;
-    to_return.parent = &root->this;
-    to_return.to_add = to_add;
-    to_return.distance = distance(&root->this.position, &to_add->position);
-
-    if(das_getsize(root->children) != 0)
-    {
-	tree_node_t *child = NULL;
-	das_init_traverse(root->children);
-	while((child = (tree_node_t*)das_traverse(root->children)) != NULL)
-	{
-	    tmp = get_shortest_dist(child, to_add);
-	    if(tmp.distance < to_return.distance)
-		to_return = tmp;
-	}
-    }
-    return to_return;
-}
-
-tree_node_t* get_branch(tree_node_t *root, destination_t *to_get)
-{
-    if(compare_destinations(&root->this, to_get))
-	return root;
-    tree_node_t *child = NULL, *tmp = NULL;
-    das_init_traverse(root->children);
-    while((child = (tree_node_t*)das_traverse(root->children)) != NULL)
-    {
-	tmp = get_branch(child, to_get);
-	if(tmp != NULL && compare_destinations(&tmp->this, to_get))
-	    return tmp;
-    }
-    return NULL;
+done:
+    free(members);
+    free(points);
+    free(nodes);
+    free(parent);
+    free(order);
+    return root;
 }
 
 int get_header_size(call_t *call)
@@ -33,7 +33,7 @@ model_t model =
 #define ERROR -1
 #define EMPTY_DESTINATION {-2, {-1, -1, -1}}
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
 #define NEW(type) malloc(sizeof(type))
 
@@ -233,8 +233,7 @@ int call_back(call_t *call, void *args)
 
 int tx_start(call_t *call, void *args)
 {
-    call_t call_down = CALL_DOWN(call);
-    TX(&call_down, (packet_t*)args);
+    TX_DOWN(call, (packet_t*)args);
     return 0;
 }
 
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "oracle_discovery.h"
+
+//=====================================================================
+// - Internal helpers
+
+static bool oracle_listed(void* das, nodeid_t id){
+    destination_t *tmp = NULL;
+
+    das_init_traverse(das);
+    while((tmp = (destination_t*)das_traverse(das)) != NULL)
+	if(tmp->id == id)
+	    return true;
+    return false;
+}
+
+//---------------------------------------------------------------------
+// * Witness
+//---------------------------------------------------------------------
+// True if a neighbor other than nbr lies in the circle of diameter
+// me-nbr, as tested by planarize_graph on the second hello.
+//---------------------------------------------------------------------
+static bool oracle_witness(position_t* me, destination_t* nbr, void* nbrs){
+    destination_t *tmp = NULL;
+    position_t center;
+    double radius;
+
+    center.x = (nbr->position.x + me->x) / 2;
+    center.y = (nbr->position.y + me->y) / 2;
+    center.z = (nbr->position.z + me->z) / 2;
+    radius = distance(&center, me);
+
+    das_init_traverse(nbrs);
+    while((tmp = (destination_t*)das_traverse(nbrs)) != NULL)
+	if(tmp->id != nbr->id && distance(&tmp->position, &center) <= radius)
+	    return true;
+    return false;
+}
+
+//=====================================================================
+// - Hello rounds
+
+int oracle_discover_nbrs(call_t* call, double range, void* nbrs){
+    position_t *me = get_node_position(call->node);
+    destination_t *tmp = NULL;
+    int i, added = 0;
+
+    for(i = 0; i < get_node_count(); i++){
+	if(i == call->node || !is_node_alive(i) ||
+	    distance(me, get_node_position(i)) > range ||
+	    oracle_listed(nbrs, i))
+	    continue;
+
+	if((tmp = malloc(sizeof(destination_t))) == NULL){
+	    fprintf(stderr, "[ERR] Couldn't allocate destination\nError in "
+		"oracle discovery\n");
+	    return -1;
+	}
+	tmp->id = i;
+	tmp->position = *get_node_position(i);
+	das_insert(nbrs, (void*)tmp);
+	added++;
+    }
+
+    return added;
+}
+
+//---------------------------------------------------------------------
+// * Gabriel Graph Round
+//---------------------------------------------------------------------
+// Neighbors are taken in ascending id order, like the second round of
+// hellos would deliver them.
+//---------------------------------------------------------------------
+int oracle_discover_gg(call_t* call, void* nbrs, void* gg_list){
+    position_t *me = get_node_position(call->node);
+    destination_t *tmp = NULL, *nbr = NULL;
+    int i, added = 0;
+
+    for(i = 0; i < get_node_count(); i++){
+	das_init_traverse(nbrs);
+	while((nbr = (destination_t*)das_traverse(nbrs)) != NULL)
+	    if(nbr->id == i)
+		break;
+	if(nbr == NULL || oracle_witness(me, nbr, nbrs))
+	    continue;
+
+	if((tmp = malloc(sizeof(destination_t))) == NULL){
+	    fprintf(stderr, "[ERR] Couldn't allocate destination\nError in "
+		"oracle discovery\n");
+	    return -1;
+	}
+	*tmp = *nbr;
+	das_insert(gg_list, (void*)tmp);
+	added++;
+    }
+
+    return added;
+}
@@ -0,0 +1,34 @@
+//=====================================================================
+// ** Oracle Discovery
+//=====================================================================
+// Fills a node's neighbor list and Gabriel graph list straight from
+// node positions, for runs that only study the data plane and do not
+// want to simulate hello beacons.
+//
+// The result is what two lossless hello rounds would have produced:
+// the first round adds every node within range to nbrs, the second
+// adds to gg_list every neighbor whose diametral circle with this node
+// holds no other neighbor (boundary included). Hellos are assumed to
+// be heard in ascending node id order, and lists are filled with
+// das_insert just as the rx handlers do.
+//
+// The range must match the propagation model of the scenario (the
+// range of propagation_range, a node hearing another up to and
+// including that distance).
+//=====================================================================
+#ifndef __oracle_discovery__
+#define __oracle_discovery__
+
+#include <include/modelutils.h>
+
+//-----------------------------------
+// - Oracle Discovery Methods
+//-----------------------------------
+// - First hello round, returns the number of neighbors added or -1
+int		oracle_discover_nbrs(call_t* call, double range, void* nbrs);
+
+// - Second hello round over the nbrs of the first one, returns the
+//   number of gg neighbors added or -1
+int		oracle_discover_gg(call_t* call, void* nbrs, void* gg_list);
+
+#endif //__oracle_discovery__
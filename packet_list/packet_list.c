@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "packet_list.h"
+
+#define PLIST_ALIGN(size) (((size) + 7) & ~7)
+//entries start 8-byte aligned past the prefix
+#define PLIST_ENTRIES(block) \
+    ((void*)((char*)(block) + PLIST_ALIGN(sizeof(plist_t))))
+
+//=====================================================================
+// - Internal helpers
+
+static plist_t* plist_at(packet_t* packet, int list){
+    if(list == PLIST_NONE || list < 0 || list >= packet->size) return NULL;
+    return (plist_t*)(packet->data + list);
+}
+
+static bool at_own_position(destination_t* dest){
+    return dest->id >= 0 && dest->id < get_node_count() &&
+	memcmp(&dest->position, get_node_position(dest->id),
+	sizeof(position_t)) == 0;
+}
+
+//---------------------------------------------------------------------
+// * Reserve
+//---------------------------------------------------------------------
+// Grows packet->data by an aligned block of payload bytes past the
+// prefix and returns its offset, PLIST_NONE on failure.
+//---------------------------------------------------------------------
+static int plist_reserve(packet_t* packet, int kind, int count,
+    int payload){
+    int list = PLIST_ALIGN(packet->size);
+    int size = PLIST_ALIGN(sizeof(plist_t)) + PLIST_ALIGN(payload);
+    int old_size = packet->size;
+    plist_t* block;
+
+    if(packet_resize(packet, list + size) != 0){
+	fprintf(stderr, "[ERR] Couldn't grow packet for inline list\n");
+	return PLIST_NONE;
+    }
+    memset(packet->data + old_size, 0, list + size - old_size);
+
+    block = (plist_t*)(packet->data + list);
+    block->kind = kind;
+    block->count = count;
+    block->size = size;
+    return list;
+}
+
+//=====================================================================
+// - Appending
+
+int plist_add_targets(packet_t* packet, destination_t** targets, int count,
+    plist_kind_e kind){
+    int i, list, max_id = -1;
+    plist_t* block;
+
+    if(kind == PLIST_BITMAP){
+	for(i = 0; i < count && kind == PLIST_BITMAP; i++){
+	    if(!at_own_position(targets[i])) kind = PLIST_ARRAY;
+	    else if(targets[i]->id > max_id) max_id = targets[i]->id;
+	}
+    }
+
+    if(kind == PLIST_BITMAP){
+	uint64_t* bits;
+
+	if((list = plist_reserve(packet, PLIST_BITMAP, count,
+	    (max_id / 64 + 1) * sizeof(uint64_t))) == PLIST_NONE)
+	    return PLIST_NONE;
+	block = plist_at(packet, list);
+	bits = (uint64_t*)PLIST_ENTRIES(block);
+	for(i = 0; i < count; i++)
+	    bits[targets[i]->id / 64] |= (uint64_t)1 << (targets[i]->id % 64);
+	//count distinct ids, the list might have repeats
+	for(block->count = 0, i = 0; i <= max_id / 64; i++)
+	    block->count += __builtin_popcountll(bits[i]);
+	return list;
+    }
+
+    if((list = plist_reserve(packet, PLIST_ARRAY, count,
+	count * sizeof(destination_t))) == PLIST_NONE)
+	return PLIST_NONE;
+    block = plist_at(packet, list);
+    for(i = 0; i < count; i++)
+	((destination_t*)PLIST_ENTRIES(block))[i] = *targets[i];
+    return list;
+}
+
+int plist_add_path(packet_t* packet, void* path){
+    int list, i = 0;
+    nodeid_t *hop = NULL, *hops;
+
+    if((list = plist_reserve(packet, PLIST_PATH, das_getsize(path),
+	das_getsize(path) * sizeof(nodeid_t))) == PLIST_NONE)
+	return PLIST_NONE;
+    hops = (nodeid_t*)PLIST_ENTRIES(plist_at(packet, list));
+    das_init_traverse(path);
+    while((hop = (nodeid_t*)das_traverse(path)) != NULL)
+	hops[i++] = *hop;
+    return list;
+}
+
+//---------------------------------------------------------------------
+// * Truncate
+//---------------------------------------------------------------------
+// Drops list and everything appended after it, e.g. before replacing
+// the last list of a cloned packet. The buffer isn't shrunk.
+//---------------------------------------------------------------------
+void plist_truncate(packet_t* packet, int list){
+    if(plist_at(packet, list) == NULL) return;
+
+    packet->size = list;
+}
+
+//=====================================================================
+// - Reading
+
+int plist_count(packet_t* packet, int list){
+    plist_t* block = plist_at(packet, list);
+    return block != NULL ? block->count : 0;
+}
+
+bool plist_contains(packet_t* packet, int list, destination_t* to_check){
+    plist_t* block = plist_at(packet, list);
+    destination_t* targets;
+    int i;
+
+    if(block == NULL) return false;
+
+    if(block->kind == PLIST_BITMAP){
+	uint64_t* bits = (uint64_t*)PLIST_ENTRIES(block);
+	int words = (block->size - PLIST_ALIGN(sizeof(plist_t))) / sizeof(uint64_t);
+
+	return at_own_position(to_check) && to_check->id / 64 < words &&
+	    (bits[to_check->id / 64] >> (to_check->id % 64)) & 1;
+    }
+    if(block->kind != PLIST_ARRAY) return false;
+
+    targets = (destination_t*)PLIST_ENTRIES(block);
+    for(i = 0; i < block->count; i++){
+	if(targets[i].id == to_check->id &&
+	    memcmp(&targets[i].position, &to_check->position,
+	    sizeof(position_t)) == 0)
+	    return true;
+    }
+    return false;
+}
+
+destination_t* plist_array(packet_t* packet, int list){
+    plist_t* block = plist_at(packet, list);
+    if(block == NULL || block->kind != PLIST_ARRAY) return NULL;
+    return (destination_t*)PLIST_ENTRIES(block);
+}
+
+//---------------------------------------------------------------------
+// * Pointers
+//---------------------------------------------------------------------
+// A destination_t* view of an ARRAY list, for code taking target
+// lists as pointer arrays. The caller frees the view (not what it
+// points to); it is invalidated when the packet grows or goes away.
+//---------------------------------------------------------------------
+destination_t** plist_pointers(packet_t* packet, int list){
+    destination_t *targets = plist_array(packet, list), **view;
+    int i, count = plist_count(packet, list);
+
+    if(targets == NULL ||
+	(view = malloc((count > 0 ? count : 1) * sizeof(destination_t*)))
+	== NULL)
+	return NULL;
+    for(i = 0; i < count; i++)
+	view[i] = &targets[i];
+    return view;
+}
+
+nodeid_t plist_path_hop(packet_t* packet, int list, int hop){
+    plist_t* block = plist_at(packet, list);
+    if(block == NULL || block->kind != PLIST_PATH || hop < 0 ||
+	hop >= block->count)
+	return -1;
+    return ((nodeid_t*)PLIST_ENTRIES(block))[hop];
+}
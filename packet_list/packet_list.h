@@ -0,0 +1,70 @@
+//=====================================================================
+// ** Packet Lists
+//=====================================================================
+// Target lists and paths stored inline at the tail of packet->data
+// instead of behind pointers in the routing header. A header keeps the
+// offset of each list (PLIST_NONE if it has none), so packet_clone
+// copies lists along with the rest of the packet, packet_dealloc frees
+// them, and forwarders never share or deep-copy them by hand.
+//
+// Each list is a length-prefixed block (plist_t, then its entries),
+// 8-byte aligned, in one of three forms:
+//
+//  - ARRAY: destination_t entries, for targets that aren't plain nodes
+//    or that the module reads as an array
+//  - BITMAP: one bit per node id, for dense sets of nodes at their own
+//    positions; membership is O(1)
+//  - PATH: nodeid_t hops, read with a cursor kept in the header
+//
+// Adding a list grows the packet buffer with packet_resize, which may
+// move packet->data (out of its inline slab, or to a bigger block), so
+// header pointers into packet->data must be fetched again afterwards.
+//
+// Lists aren't charged to packet->real_size: headers keep their list
+// offsets in a union of PLIST_WIRE_SIZE bytes, the size of the pointers
+// and counts they replaced, so airtime is the same as when the lists
+// were carried by pointer.
+//=====================================================================
+#ifndef __packet_list__
+#define __packet_list__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+#define PLIST_NONE -1
+
+// header bytes of a das path pointer, then a count and a pointer per
+// target list (64-bit layout)
+#define PLIST_WIRE_SIZE(lists) (8 + 16 * (lists))
+
+typedef enum {PLIST_ARRAY, PLIST_BITMAP, PLIST_PATH} plist_kind_e;
+
+//---------------------------------------------------------------------
+// * Block prefix, followed by the entries
+
+typedef struct{
+    int		kind;
+    int		count;	// targets or hops
+    int		size;	// bytes of the whole block, prefix and padding included
+} plist_t;
+
+//-----------------------------------
+// - Packet List Methods
+//-----------------------------------
+// - Appending lists, returning their offset or PLIST_NONE if the
+//   buffer couldn't grow. A BITMAP request falls back to an ARRAY
+//   when a target isn't a node at its own position.
+int		plist_add_targets(packet_t* packet, destination_t** targets,
+		    int count, plist_kind_e kind);
+int		plist_add_path(packet_t* packet, void* path);
+void		plist_truncate(packet_t* packet, int list);
+
+// - Reading
+int		plist_count(packet_t* packet, int list);
+bool		plist_contains(packet_t* packet, int list,
+		    destination_t* to_check);
+destination_t*	plist_array(packet_t* packet, int list);
+destination_t**	plist_pointers(packet_t* packet, int list);
+nodeid_t	plist_path_hop(packet_t* packet, int list, int hop);
+
+#endif //__packet_list__
@@ -0,0 +1,322 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include "path_oracle.h"
+#include "../bfs_engine/bfs_engine.c"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+#define ORACLE_UNQUEUED -1
+#define ORACLE_SETTLED -2
+
+//=====================================================================
+// - Internal helpers
+
+//---------------------------------------------------------------------
+// * Free Tree
+//---------------------------------------------------------------------
+static void path_tree_free(path_tree* tree){
+    if(tree == NULL) return;
+
+    free(tree->prev);
+    free(tree->dist);
+    free(tree->order);
+    free(tree);
+}
+
+//---------------------------------------------------------------------
+// * Lazy Sizing
+//---------------------------------------------------------------------
+// Node count is only known once the simulation is configured, so the
+// per-source table and the heap scratch space are sized on first use.
+//---------------------------------------------------------------------
+static bool path_oracle_reserve(path_oracle* oracle){
+    if(oracle->trees != NULL) return true;
+
+    int i;
+    oracle->node_cnt = get_node_count();
+    oracle->trees = malloc(oracle->node_cnt * sizeof(path_tree*));
+    oracle->heap = malloc(oracle->node_cnt * sizeof(int));
+    oracle->heap_pos = malloc(oracle->node_cnt * sizeof(int));
+    if(oracle->trees == NULL || oracle->heap == NULL ||
+	oracle->heap_pos == NULL){
+	free(oracle->trees);
+	free(oracle->heap);
+	free(oracle->heap_pos);
+	oracle->trees = NULL;
+	oracle->heap = NULL;
+	oracle->heap_pos = NULL;
+	return false;
+    }
+    for(i = 0; i < oracle->node_cnt; i++) oracle->trees[i] = NULL;
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+// * Binary heap keyed on tree->dist, indexed by node id
+//---------------------------------------------------------------------
+static void oracle_heap_up(path_oracle* oracle, double* dist, int i){
+    int *heap = oracle->heap, *pos = oracle->heap_pos;
+    int node = heap[i];
+
+    while(i > 0 && dist[heap[(i - 1) / 2]] > dist[node]){
+	heap[i] = heap[(i - 1) / 2];
+	pos[heap[i]] = i;
+	i = (i - 1) / 2;
+    }
+    heap[i] = node;
+    pos[node] = i;
+}
+
+static void oracle_heap_down(path_oracle* oracle, double* dist, int size,
+    int i){
+    int *heap = oracle->heap, *pos = oracle->heap_pos;
+    int node = heap[i];
+
+    while(2 * i + 1 < size){
+	int child = 2 * i + 1;
+	if(child + 1 < size && dist[heap[child + 1]] < dist[heap[child]])
+	    child++;
+	if(dist[heap[child]] >= dist[node]) break;
+	heap[i] = heap[child];
+	pos[heap[i]] = i;
+	i = child;
+    }
+    heap[i] = node;
+    pos[node] = i;
+}
+
+//---------------------------------------------------------------------
+// * Build Tree
+//---------------------------------------------------------------------
+// Grows the full shortest-path tree from call->node over live nodes.
+// Hop metric runs the shared BFS engine and copies its result out;
+// Euclidean metric is Dijkstra with a decrease-key binary heap.
+//---------------------------------------------------------------------
+static path_tree* path_oracle_build(path_oracle* oracle, call_t *call){
+    int n = oracle->node_cnt, heap_size = 0, i;
+    call_t call_next = *call;
+    destination_t *nbr = NULL;
+    path_tree* tree = NEW(path_tree);
+
+    if(tree == NULL) return NULL;
+    tree->prev = malloc(n * sizeof(nodeid_t));
+    tree->dist = malloc(n * sizeof(double));
+    tree->order = malloc(n * sizeof(nodeid_t));
+    tree->reached = 0;
+    if(tree->prev == NULL || tree->dist == NULL || tree->order == NULL){
+	path_tree_free(tree);
+	return NULL;
+    }
+
+    for(i = 0; i < n; i++){
+	tree->prev[i] = ORACLE_NO_NODE;
+	tree->dist[i] = -1;
+	oracle->heap_pos[i] = ORACLE_UNQUEUED;
+    }
+
+    if(oracle->metric == ORACLE_HOPS){
+	nodeid_t source = call->node;
+	bfs_engine* bfs = oracle->bfs;
+
+	bfs_run(bfs, call, &source, 1, NULL, NULL);
+	for(i = 0; i < bfs->reached; i++){
+	    nodeid_t v = bfs->queue[i];
+	    tree->order[i] = v;
+	    tree->dist[v] = bfs->hops[v];
+	    if(bfs->prev[v] != BFS_NO_NODE) tree->prev[v] = bfs->prev[v];
+	}
+	tree->reached = bfs->reached;
+	return tree;
+    }
+
+    tree->dist[call->node] = 0;
+    oracle->heap[heap_size++] = call->node;
+    oracle->heap_pos[call->node] = 0;
+
+    while(heap_size > 0){
+	nodeid_t u = oracle->heap[0];
+
+	oracle->heap_pos[u] = ORACLE_SETTLED;
+	if(--heap_size > 0){
+	    oracle->heap[0] = oracle->heap[heap_size];
+	    oracle_heap_down(oracle, tree->dist, heap_size, 0);
+	}
+	tree->order[tree->reached++] = u;
+
+	call_next.node = u;
+	void *nbrs = oracle->get_nbrs(&call_next);
+	if(nbrs == NULL) continue;
+
+	das_init_traverse(nbrs);
+	while((nbr = (destination_t*)das_traverse(nbrs)) != NULL){
+	    nodeid_t v = nbr->id;
+	    if(v < 0 || v >= n || !is_node_alive(v) ||
+		oracle->heap_pos[v] == ORACLE_SETTLED) continue;
+
+	    double dist = tree->dist[u] +
+		distance(get_node_position(u), &nbr->position);
+	    if(oracle->heap_pos[v] == ORACLE_UNQUEUED){
+		tree->dist[v] = dist;
+		tree->prev[v] = u;
+		oracle->heap[heap_size] = v;
+		oracle_heap_up(oracle, tree->dist, heap_size++);
+	    }
+	    else if(dist < tree->dist[v]){
+		tree->dist[v] = dist;
+		tree->prev[v] = u;
+		oracle_heap_up(oracle, tree->dist, oracle->heap_pos[v]);
+	    }
+	}
+    }
+
+    return tree;
+}
+
+//=====================================================================
+// - Creation/destruction
+
+//---------------------------------------------------------------------
+// * Create Path Oracle
+//---------------------------------------------------------------------
+// Allocates an empty oracle. get_nbrs returns the neighbor das the
+// trees are grown over (e.g. nbrs or gg_list from the node data).
+//---------------------------------------------------------------------
+path_oracle* create_path_oracle(oracle_metric_e metric,
+    oracle_nbrs_func get_nbrs){
+    path_oracle* oracle = NEW(path_oracle);
+    if(oracle == NULL) return NULL;
+
+    oracle->metric = metric;
+    oracle->get_nbrs = get_nbrs;
+    oracle->node_cnt = 0;
+    oracle->version = get_topology_version();
+    oracle->trees = NULL;
+    oracle->heap = NULL;
+    oracle->heap_pos = NULL;
+    if((oracle->bfs = create_bfs_engine(get_nbrs)) == NULL){
+	free(oracle);
+	return NULL;
+    }
+
+    return oracle;
+}
+
+//---------------------------------------------------------------------
+// * Destroy Path Oracle
+//---------------------------------------------------------------------
+void path_oracle_destroy(path_oracle* oracle){
+    if(oracle == NULL) return;
+
+    path_oracle_invalidate(oracle);
+    free(oracle->trees);
+    free(oracle->heap);
+    free(oracle->heap_pos);
+    bfs_engine_destroy(oracle->bfs);
+    free(oracle);
+}
+
+//---------------------------------------------------------------------
+// * Invalidate
+//---------------------------------------------------------------------
+// Drops every cached tree. Modules call this whenever they change the
+// neighbor lists handed out by get_nbrs.
+//---------------------------------------------------------------------
+void path_oracle_invalidate(path_oracle* oracle){
+    if(oracle == NULL || oracle->trees == NULL) return;
+
+    int i;
+    for(i = 0; i < oracle->node_cnt; i++){
+	path_tree_free(oracle->trees[i]);
+	oracle->trees[i] = NULL;
+    }
+}
+
+//=====================================================================
+// - Queries
+
+//---------------------------------------------------------------------
+// * Get Tree
+//---------------------------------------------------------------------
+// Returns the memoized tree rooted at call->node, building it if the
+// source has none yet or the topology changed since it was built.
+//---------------------------------------------------------------------
+path_tree* path_oracle_tree(path_oracle* oracle, call_t *call){
+    if(oracle == NULL || !path_oracle_reserve(oracle)) return NULL;
+    if(call->node < 0 || call->node >= oracle->node_cnt) return NULL;
+
+    if(oracle->version != get_topology_version()){
+	path_oracle_invalidate(oracle);
+	oracle->version = get_topology_version();
+    }
+    if(oracle->trees[call->node] == NULL)
+	oracle->trees[call->node] = path_oracle_build(oracle, call);
+
+    return oracle->trees[call->node];
+}
+
+//---------------------------------------------------------------------
+// * Next Hop
+//---------------------------------------------------------------------
+// Returns the first node after call->node on the path to dest or
+// ORACLE_NO_NODE if dest is unreachable.
+//---------------------------------------------------------------------
+nodeid_t path_oracle_next_hop(path_oracle* oracle, call_t *call,
+    nodeid_t dest){
+    path_tree* tree = path_oracle_tree(oracle, call);
+    if(tree == NULL || dest < 0 || dest >= oracle->node_cnt ||
+	dest == call->node || tree->dist[dest] < 0)
+	return ORACLE_NO_NODE;
+
+    while(tree->prev[dest] != call->node) dest = tree->prev[dest];
+
+    return dest;
+}
+
+//---------------------------------------------------------------------
+// * Full Path
+//---------------------------------------------------------------------
+// Returns a das of nodeid_t* from the first hop to dest (source
+// excluded) so that das_pop yields hops in order, or NULL if dest is
+// unreachable. The caller owns the das and its entries.
+//---------------------------------------------------------------------
+void* path_oracle_get_path(path_oracle* oracle, call_t *call,
+    nodeid_t dest){
+    path_tree* tree = path_oracle_tree(oracle, call);
+    if(tree == NULL || dest < 0 || dest >= oracle->node_cnt ||
+	dest == call->node || tree->dist[dest] < 0)
+	return NULL;
+
+    void* path = das_create();
+    if(path == NULL) return NULL;
+
+    while(dest != call->node){
+	nodeid_t* next = NEW(nodeid_t);
+	*next = dest;
+	das_insert(path, (void*)next);
+	dest = tree->prev[dest];
+    }
+
+    return path;
+}
+
+//---------------------------------------------------------------------
+// * Find Last Match
+//---------------------------------------------------------------------
+// Returns the reachable node matching 'match' that the tree settled
+// last (the farthest member of a geocast region) or ORACLE_NO_NODE.
+//---------------------------------------------------------------------
+nodeid_t path_oracle_find_last(path_oracle* oracle, call_t *call,
+    oracle_match_func match, void *arg){
+    path_tree* tree = path_oracle_tree(oracle, call);
+    if(tree == NULL) return ORACLE_NO_NODE;
+
+    int i = tree->reached;
+    while(--i > 0)
+	if(match(tree->order[i], arg)) return tree->order[i];
+
+    return ORACLE_NO_NODE;
+}
@@ -0,0 +1,77 @@
+//=====================================================================
+// ** Path Oracle
+//=====================================================================
+// Per-simulation cache of shortest-path trees built over a routing
+// module's neighbor tables. The tree rooted at a source is computed
+// lazily the first time that source asks for a route and is reused
+// for every later packet, so next-hop and full-path queries only walk
+// the path itself. Every cached tree is dropped when the topology
+// version changes (node birth, death or movement) or when the module
+// calls path_oracle_invalidate() after editing its neighbor lists.
+//=====================================================================
+#ifndef __path_oracle__
+#define __path_oracle__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+#include "../bfs_engine/bfs_engine.h"
+
+#define ORACLE_NO_NODE -2
+
+//---------------------------------------------------------------------
+// * Edge metric used to weigh the tree
+
+typedef enum {ORACLE_HOPS, ORACLE_EUCLIDEAN} oracle_metric_e;
+
+//---------------------------------------------------------------------
+// * Returns the das of destination_t* neighbors of call->node
+
+typedef void* (*oracle_nbrs_func)(call_t *call);
+
+//---------------------------------------------------------------------
+// * Node selection predicate used by path_oracle_find_last
+
+typedef bool (*oracle_match_func)(nodeid_t node, void *arg);
+
+//---------------------------------------------------------------------
+// * Shortest-path tree rooted at a single source
+
+typedef struct{
+    nodeid_t*		prev;
+    double*		dist;
+    nodeid_t*		order;
+    int			reached;
+} path_tree;
+
+//---------------------------------------------------------------------
+// * Path oracle main data structure
+
+typedef struct{
+    oracle_metric_e	metric;
+    oracle_nbrs_func	get_nbrs;
+    int			node_cnt;
+    uint64_t		version;
+    path_tree**		trees;
+    int*		heap;
+    int*		heap_pos;
+    bfs_engine*		bfs;
+} path_oracle;
+
+//-----------------------------------
+// - Path Oracle Methods
+//-----------------------------------
+path_oracle*	create_path_oracle(oracle_metric_e metric,
+		    oracle_nbrs_func get_nbrs);
+void		path_oracle_destroy(path_oracle* oracle);
+void		path_oracle_invalidate(path_oracle* oracle);
+
+// - Queries (source is call->node)
+path_tree*	path_oracle_tree(path_oracle* oracle, call_t *call);
+nodeid_t	path_oracle_next_hop(path_oracle* oracle, call_t *call,
+		    nodeid_t dest);
+void*		path_oracle_get_path(path_oracle* oracle, call_t *call,
+		    nodeid_t dest);
+nodeid_t	path_oracle_find_last(path_oracle* oracle, call_t *call,
+		    oracle_match_func match, void *arg);
+
+#endif //__path_oracle__
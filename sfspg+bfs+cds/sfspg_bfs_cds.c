@@ -11,6 +11,9 @@
 #include <stdbool.h>
 
 #include <include/modelutils.h>
+#include "../bfs_engine/bfs_engine.c"
+#include "../cds_engine/cds_engine.c"
+#include "../geo_predicates/geo_predicates.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Model Info
@@ -54,9 +57,9 @@ model_t model =
 #define THIS_DESTINATION(call) {call->node, *get_node_position(call->node)}
 
 //shit I got tired of writing over and over
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
-#define NODE_DATA(call) get_node_private_data(call)
+#define NODE_DATA(call) get_chain_private_data(call)
 #define ENTITY_DATA(call) get_entity_private_data(call)
 #define PACKET_HEADER(packet, node_data) (header_t*)(packet->data + \
 	node_data->overhead)
@@ -78,12 +81,6 @@ typedef struct _destination {
 } destination_t;
 */
 
-typedef struct
-{
-    nodeid_t this;
-    nodeid_t prev;
-}visited_node_t;
-
 //packet information needed for routing
 typedef struct
 {
@@ -113,6 +110,8 @@ typedef struct
     int num_packets;
     float scale_postscript;
     uint64_t dijk_latency;
+    bfs_engine *bfs;
+    cds_engine *cds;
 }entity_data_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -136,17 +135,13 @@ int get_header_real_size(call_t *call);
 
 //graph functions
 int do_cds(call_t *call, destination_t *dest);
-void remove_from(void *list, destination_t *to_remove);
-destination_t* has_common_nbr(void *l, void *r);
-void add_first_link(call_t *call, void *l, void *r);
-bool no_outside_nbr(void *nbr_list, destination_t *dest);
-void add_outside_nbr(call_t *call, void *list, destination_t *dest);
 void planarize_graph(call_t *call, packet_t *packet);
 int hello_callback(call_t *call, void *args);
 int start_dijk(call_t *call, destination_t *dest);
 void* get_shortest_path(call_t *call, destination_t *dest);
-bool check_in_visited(void *visited, destination_t *to_check);
-visited_node_t* get_node(void *visited, nodeid_t to_get);
+bool in_region(nodeid_t node, void *region);
+void* bfs_nbrs(call_t *call);
+void* cds_nbrs(call_t *call);
 
 
 //tx
@@ -164,6 +159,7 @@ void forward_packet(call_t *call, packet_t *packet, direction_e direction);
 void deliver_packet(call_t *call, packet_t *packet);
 bool combine_packets(call_t *call, destination_t *sender,
     destination_t *next_node, direction_e direction);
+uint64_t buffer_key(call_t *call, packet_t *packet);
 bool flooding_packet(call_t *call, packet_t *packet);
 
 //receiving functions
@@ -213,6 +209,22 @@ int init(call_t *call, void* params)
     entity_data->scale_postscript = 595.0 / (topo_pos->x + 20);
     entity_data->scale_postscript = 1700.0 / (topo_pos->x + 20);
 #endif
+    if((entity_data->bfs = create_bfs_engine(bfs_nbrs)) == NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate BFS engine\nError in routing"
+	    " module\n");
+	free(entity_data);
+	return ERROR;
+    }
+    if((entity_data->cds = create_cds_engine(cds_nbrs, bfs_nbrs, true))
+	== NULL)
+    {
+	fprintf(stderr, "[ERR] Couldn't allocate CDS engine\nError in routing"
+	    " module\n");
+	bfs_engine_destroy(entity_data->bfs);
+	free(entity_data);
+	return ERROR;
+    }
     //save entity private data
     set_entity_private_data(call, entity_data);
 
@@ -267,6 +279,8 @@ int destroy(call_t *call)
         fprintf(results, "%lld\n", entity_data->dijk_latency);
     }
 
+    bfs_engine_destroy(entity_data->bfs);
+    cds_engine_destroy(entity_data->cds);
     free(entity_data);
     entity_data = NULL;
     return 0;
@@ -373,6 +387,8 @@ int bootstrap(call_t *call)
 
     //get mac header overhead to send to application layer for packet allocation
     node_data->overhead = GET_HEADER_SIZE(&call_down);
+    //let the mac index queued packets for combine_packets
+    SET_BUFFER_KEY(&call_down, call, buffer_key);
     //hello callback needs to be run twice, once for collecting neighbor
     //information, and a second time to planerize the graph, it doesn't need to
     //be run again after that for a static graph
@@ -461,204 +477,9 @@ int get_header_real_size(call_t *call)
 //get connected dominating set for geocast region
 int do_cds(call_t *call, destination_t *dest)
 {
-    void *possible = NULL, *dominators = NULL;
-    if((possible = das_create()) == NULL || (dominators = das_create()) == NULL)
-    {
-        fprintf(stderr, "[ERR] Can't allocate lists\n[ERR] Error in cds\n");
-        return ERROR;
-    }
-
-    //get list of nodes in geocast region
-    destination_t *tmp = NEW(destination_t), *tmp2 = NULL;
-    int i;
-    for(i = 0; i < get_node_count(); ++i)
-    {
-	if(tmp == NULL)
-	tmp = NEW(destination_t);
-	tmp->id = i;
-	tmp->position = *get_node_position(i);
-	if(check_in_geocast(dest, tmp))
-	{
-	    destination_t *to_delete = NULL;
-	    das_insert(possible, (void*)tmp);
-
-            call_t call_tmp = *call;
-            call_tmp.node = tmp->id;
-            node_data_t *tmp_node_data = NODE_DATA(&call_tmp);
-            while((to_delete = (destination_t*)das_pop(tmp_node_data->gg_list))
-                != NULL)
-                free(to_delete);
-            to_delete = NULL;
-
-            das_init_traverse(tmp_node_data->nbrs);
-            while((to_delete =
-                (destination_t*)das_traverse(tmp_node_data->nbrs)) != NULL)
-            {
-                call_t call_delete = *call;
-                call_delete.node = to_delete->id;
-                node_data_t *delete_node_data = NODE_DATA(&call_delete);
-                remove_from(delete_node_data->gg_list, tmp);
-            }
-            tmp = NULL;
-        }
-    }
-
-    //generate list of dominators
-    while((tmp = (destination_t*)das_pop(possible)) != NULL)
-    {
-        das_insert(dominators, (void*)tmp);
-
-        call_t call_tmp = *call;
-        call_tmp.node = tmp->id;
-        node_data_t *node_data = NODE_DATA(&call_tmp);
-
-        das_init_traverse(node_data->nbrs);
-        while((tmp2 = (destination_t*)das_traverse(node_data->nbrs)) != NULL)
-        {
-            destination_t *to_add = NEW(destination_t);
-
-            *to_add = *tmp2;
-            remove_from(possible, tmp2);
-            das_insert(node_data->gg_list, (void*)to_add);
-
-            call_t call_neighbor = *call;
-            call_neighbor.node = to_add->id;
-            node_data_t *neighbor_node_data = NODE_DATA(&call_neighbor);
-            to_add = NEW(destination_t);
-            *to_add = *tmp;
-            das_insert(neighbor_node_data->gg_list, (void*)to_add);
-        }
-    }
-    das_destroy(possible);
-
-    while((tmp = (destination_t*)das_pop(dominators)) != NULL)
-    {
-        call_t call_tmp = *call;
-        call_tmp.node = tmp->id;
-        node_data_t *tmp_node_data = NODE_DATA(&call_tmp);
-        das_init_traverse(dominators);
-        while((tmp2 = (destination_t*)das_traverse(dominators)) != NULL)
-        {
-            call_t call_tmp2 = *call;
-            call_tmp2.node = tmp2->id;
-            node_data_t *tmp2_node_data = NODE_DATA(&call_tmp2);
-            if(has_common_nbr(tmp_node_data->gg_list,
-                tmp2_node_data->gg_list) == NULL)
-            {
-                add_first_link(call, tmp_node_data->gg_list,
-                    tmp2_node_data->gg_list);
-            }
-        }
-	if(no_outside_nbr(tmp_node_data->gg_list, dest))
-	    add_outside_nbr(call, tmp_node_data->gg_list, dest);
-        free(tmp);
-    }
-    das_destroy(dominators);
-
-    return 0;
-}
-
-void remove_from(void* list, destination_t* to_remove)
-{
-    destination_t *tmp = NULL;
-
-    das_init_traverse(list);
-    while((tmp = (destination_t*)das_traverse(list)) != NULL)
-    {
-        if(compare_destinations(to_remove, tmp))
-        {
-            das_delete(list, tmp);
-            return;
-        }
-    }
-    return;
-}
-
-destination_t* has_common_nbr(void *l, void *r)
-{
-    destination_t *l_tmp = NULL, *r_tmp = NULL;
-    das_init_traverse(l);
-    while((l_tmp = (destination_t*)das_traverse(l)) != NULL)
-    {
-        das_init_traverse(r);
-        while((r_tmp = (destination_t*)das_traverse(r)) != NULL)
-        {
-            if(compare_destinations(l_tmp, r_tmp))
-                return l_tmp;
-        }
-    }
-    return NULL;
-}
-
-void add_first_link(call_t *call, void *l, void *r)
-{
-    destination_t *l_tmp = NULL, *result = NULL;
-
-    das_init_traverse(l);
-    while((l_tmp = (destination_t*)das_traverse(l)) != NULL)
-    {
-        call_t call_l = *call;
-        call_l.node = l_tmp->id;
-        node_data_t *l_node_data = NODE_DATA(&call_l);
-        if((result = has_common_nbr(l_node_data->nbrs, r)) != NULL)
-        {
-            call_t call_r = *call;
-            call_r.node = result->id;
-            node_data_t *r_node_data = NODE_DATA(&call_r);
-
-            destination_t *to_add = NEW(destination_t);
-            *to_add = *result;
-            das_insert(l_node_data->gg_list, (void*)to_add);
-            to_add = NEW(destination_t);
-            *to_add = *l_tmp;
-            das_insert(r_node_data->gg_list, (void*)to_add);
-        }
-    }
-    return;
-}
-
-bool no_outside_nbr(void *nbr_list, destination_t *dest)
-{
-    destination_t *tmp = NULL;
+    entity_data_t *entity_data = ENTITY_DATA(call);
 
-    das_init_traverse(nbr_list);
-    while((tmp = (destination_t*)das_traverse(nbr_list)) != NULL)
-	if(!check_in_geocast(dest, tmp))
-	    return false;
-    return true;
-}
-
-void add_outside_nbr(call_t *call, void *list, destination_t *dest)
-{
-    destination_t *tmp = NULL, *nbr = NULL;
-
-    das_init_traverse(list);
-    while((tmp = (destination_t*)das_traverse(list)) != NULL)
-    {
-	call_t call_tmp = *call;
-	call_tmp.node = tmp->id;
-	node_data_t *tmp_node_data = NODE_DATA(&call_tmp);
-
-	das_init_traverse(tmp_node_data->nbrs);
-	while((nbr = (destination_t*)das_traverse(tmp_node_data->nbrs)) != NULL)
-	{
-	    if(!check_in_geocast(dest, nbr))
-	    {
-		destination_t *to_add = NEW(destination_t);
-		*to_add = *nbr;
-		das_insert(tmp_node_data->gg_list, (void*)to_add);
-		to_add = NEW(destination_t);
-		*to_add = *tmp;
-
-		call_t call_nbr = *call;
-		call_nbr.node = nbr->id;
-		node_data_t *nbr_node_data = NODE_DATA(&call_nbr);
-		das_insert(nbr_node_data->gg_list, (void*)to_add);
-		return;
-	    }
-	}
-    }
-    return;
+    return cds_run(entity_data->cds, call, in_region, (void*)dest);
 }
 
 //planarization algorithm
@@ -682,6 +503,7 @@ void planarize_graph(call_t *call, packet_t *packet)
 	}
 	*tmp = header->sender;
 	das_insert(node_data->nbrs, (void*)tmp);
+	cds_engine_invalidate(((entity_data_t*)ENTITY_DATA(call))->cds);
 	return;
     }
 
@@ -775,7 +597,7 @@ int hello_callback(call_t *call, void *args)
     header->path = NULL;
 
     // send hello
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
@@ -817,139 +639,42 @@ int start_dijk(call_t *call, destination_t *dest)
 
 void* get_shortest_path(call_t *call, destination_t *dest)
 {
-    node_data_t *node_data = NODE_DATA(call);
-    call_t call_next = *call;
-    destination_t *tmp = NULL;
-    visited_node_t *tmp1 = NEW(visited_node_t), *tmp2 = NULL,
-	*new = NEW(visited_node_t), *last_found = NEW(visited_node_t);
-    void *visited = das_create(), *to_check = das_create();
-    int num_targets = 0, num_found = 0, i;
-
-    //get total num of possible targets
-    for(i = 0; i < get_node_count(); ++i)
-    {
-	if(i == call->node)
-	    continue;
-	destination_t tmp_dest = {i, *get_node_position(i)};
-
-	if(check_in_geocast(dest, &tmp_dest))
-	    ++num_targets;
-    }
-
-    //add source to list as top of tree
-    tmp1->this = call->node;
-    tmp1->prev = NONE;
-    *new = *tmp1;
-    das_insert(to_check, (void*)tmp1);
-    tmp1 = NEW(visited_node_t);
-    *tmp1 = *new;
-    das_insert(visited, (void*)tmp1);
-    new->this = NONE;
-    *last_found = *new;
-
-    //while there are nodes to expand
-    while(das_getsize(to_check) != 0)
-    {
-	//while there nodes in to_check
-	das_init_traverse(to_check);
-	while((tmp1 = (visited_node_t*)das_traverse(to_check)) != NULL)
-	{
-	    if(tmp2 != NULL)
-	    {
-		das_delete(to_check, (void*)tmp2);
-		tmp2 = NULL;
-	    }
-	    if(das_getsize(to_check) == 0)
-		break;
-	    call_next.node = tmp1->this;
-	    node_data = NODE_DATA(&call_next);
-
-	    //check nodes neighbor list
-	    das_init_traverse(node_data->gg_list);
-	    while((tmp = (destination_t*)das_traverse(node_data->gg_list))
-		!= NULL)
-	    {
-		//if neighbor isn't already visited
-		if(!check_in_visited(visited, tmp))
-		{
-		    new->this = tmp->id;
-		    new->prev = tmp1->this;
-		    if(check_in_geocast(dest, tmp))
-		    {
-			*last_found = *new;
-			++num_found;
-		    }
-		    if(num_found == num_targets)
-			break;
-		    tmp2 = new;
-		    das_insert(visited, (void*)new);
-		    new = NEW(visited_node_t);
-		    *new = *tmp2;
-		    das_insert(to_check, (void*)new);
-		    new = NEW(visited_node_t);
-		    tmp2 = NULL;
-		}
-	    }
-	    if(num_found == num_targets)
-		break;
-	    tmp2 = tmp1;
-	}
-	if(num_found == num_targets)
-	    break;
-    }
+    entity_data_t *entity_data = ENTITY_DATA(call);
+    nodeid_t source = call->node, target;
 
-    //create path structure
-    if(last_found->this == NONE)
+    //gg_list is rewired by do_cds for every packet, so nothing is cached:
+    //one traversal stops once every region member is reached and the
+    //path goes to the last one found
+    if((target = bfs_run(entity_data->bfs, call, &source, 1, in_region,
+	(void*)dest)) == BFS_NO_NODE)
 	return NULL;
-    void* path = das_create();
-    nodeid_t* next = NEW(nodeid_t);
-    *next = last_found->this;
-    das_insert(path, (void*)next);
-    while((last_found = get_node(visited, last_found->prev)) != NULL)
-    {
-	if(last_found->this != call->node)
-	{
-	    next = NEW(nodeid_t);
-	    *next = last_found->this;
-	    das_insert(path, (void*)next);
-	}
-    }
-
-    //deallocate used memory
-    while((new = (visited_node_t*)das_pop(to_check)) != NULL)
-	free(new);
-    das_destroy(to_check);
-    while((new = (visited_node_t*)das_pop(visited)) != NULL)
-	free(new);
-    das_destroy(visited);
-    to_check = NULL;
-    visited = NULL;
-
-    return path;
+    return bfs_get_path(entity_data->bfs, target);
 }
 
-bool check_in_visited(void* visited, destination_t *to_check)
+//adapts check_in_geocast to the BFS engine's target predicate
+bool in_region(nodeid_t node, void *region)
 {
-    visited_node_t *tmp = NULL;
+    destination_t tmp = {node, *get_node_position(node)};
 
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-	if(to_check->id == tmp->this)
-	    return true;
-    return false;
+    return check_in_geocast((destination_t*)region, &tmp);
 }
 
-visited_node_t* get_node(void *visited, nodeid_t to_get)
+//planar neighbor list the BFS engine traverses
+void* bfs_nbrs(call_t *call)
 {
-    visited_node_t *tmp = NULL;
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->gg_list;
+}
 
-    das_init_traverse(visited);
-    while((tmp = (visited_node_t*)das_traverse(visited)) != NULL)
-    {
-	if(tmp->this == to_get)
-	    return tmp;
-    }
-    return NULL;
+//physical neighbor list the CDS engine builds its adjacency from
+void* cds_nbrs(call_t *call)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    if(node_data == NULL)
+	return NULL;
+    return node_data->nbrs;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1114,27 +839,16 @@ intersection_e check_intersect(call_t *call, destination_t *source,
 {
     if(check_in_geocast(dest, next))
 	return INTERSECTION;
+    //otherwise an edge reaching the region is a juncture as well
     if(!check_in_geocast(dest, source))
     {
-	destination_t corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y -= 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x -= 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
-	    return INTERSECTION;
-	corner = *dest;
-	corner.position.x += 1;
-	corner.position.y += 1;
-	if(check_intersect(call, &corner, dest, next) != NO_INT)
+	position_t low = dest->position, high = dest->position;
+	low.x -= 1;
+	low.y -= 1;
+	high.x += 1;
+	high.y += 1;
+	if(geo_segment_meets_rect(get_node_position(call->node),
+	    &next->position, &low, &high))
 	    return INTERSECTION;
     }
 
@@ -1143,82 +857,20 @@ intersection_e check_intersect(call_t *call, destination_t *source,
     if(next->id == source->id || call->node == source->id)
 	return NO_INT;
     position_t *current_pos = get_node_position(call->node);
-    //calculate 3-dimensional cross products of source-current vector and
-    //source-destination vector and the source-prev vector and
-    //source-destination vector
-    double vect1 = ((current_pos->x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((current_pos->y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    double vect2 = ((next->position.x - source->position.x) * (dest->position.y
-	- source->position.y)) - ((next->position.y - source->position.y) *
-	(dest->position.x - source->position.x));
-
-    //if BOTH vectors have the same sign, they are BOTH on the same side of the
-    //source-destination line, don't change face
-    if((vect1 < 0 && vect2 < 0) || (vect1 > 0 && vect2 >0))
-	return NO_INT;
 
-    //check to see if current-next and source-destination intersect
-    double a1, a2, b1, b2, c1, c2, det, x, y, dist;
-
-    //get formulas for the two lines the line segments are part of in
-    //Ax + By = C form
-    a1 = dest->position.y - source->position.y;
-    b1 = source->position.x - dest->position.x;
-    c1 = a1 * source->position.x + b1 * source->position.y;
-    a2 = next->position.y - current_pos->y;
-    b2 = current_pos->x - next->position.x;
-    c2 = a2 * current_pos->x + b2 * current_pos->y;
-
-    //if determinant of the two formulas is 0, lines are parallel, check for
-    //overlap of the x coordinates unless source-destination is a vertical
-    //line, then check y coordinates
-    if((det = a1 * b2 - a2 * b1) == 0)
+    //exact orientation tests of current-next against source-destination:
+    //a crossing at current is collinear, one at next is left to next
+    switch(geo_segment_cross(&source->position, &dest->position,
+	current_pos, &next->position))
     {
-	//if(source-destination isn't vertical && min(x)(source-destination) <
-	//max(x)(prev-current) && max(x)(source-destination) >
-	//min(x)(prev-current) || source-destination is vertical &&
-	//min(y)(source-destination) < max(y)(prev-current) &&
-	//max(y)(source-destination) > min(y)(prev-current)
-	if((source->position.x - dest->position.x != 0 &&
-	    fmin(source->position.x, dest->position.x) <
-	    fmax(current_pos->x, next->position.x) &&
-	    fmax(source->position.x, dest->position.x) >
-	    fmin(current_pos->x, next->position.x)) ||
-	    (source->position.x - dest->position.x == 0 &&
-	    fmin(source->position.y, dest->position.y) <
-	    fmax(current_pos->y, next->position.y) &&
-	    fmax(source->position.y, dest->position.y) >
-	    fmin(current_pos->y, next->position.y)))
-	{
-	    return COLLINEAR;
-	}
-    }
-    //if lines are not parallel
-    else
-    {
-	//apply Cramer's rule to solve for point of intersection
-	x = (b2 * c1 - b1 * c2)/det;
-	y = (a1 * c2 - a2 * c1)/det;
-
-	//if the length of the vectors formed by the difference of the
-	//destination and point of intersection and the source and point of
-	//intersection equal the length of the source-destination line segment,
-	//then the lines intersect 
-	dist = hypot((dest->position.x - x), (dest->position.y - y)) +
-	    hypot((source->position.x - x), (source->position.y - y));
-	if(((int)(distance(&source->position, &dest->position) * PRECISION)) ==
-	    (int)(dist * PRECISION))
-	{
-	    if(current_pos->x == x && current_pos->y == y)
-		return COLLINEAR;
-	    if(next->position.x == x && next->position.y == y)
-		return NO_INT;
+	case GEO_CROSS:
 	    return INTERSECTION;
-	}
+	case GEO_CROSS_AT_FROM:
+	case GEO_OVERLAP:
+	    return COLLINEAR;
+	default:
+	    return NO_INT;
     }
-    return NO_INT;
 }
 
 bool check_in_geocast(destination_t *region, destination_t *to_check)
@@ -1585,7 +1237,7 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
 	packet = NULL;
 	return ERROR;
     }
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
 #ifdef LOG_ROUTING
     if(header->type == D_PACKET)
 	PRINT_ROUTING("[RTG] optimal path packet at %d sent to %d\n",
@@ -1603,6 +1255,14 @@ int set_mac_header_tx(call_t *call, packet_t *packet)
     return true;
 }
 
+//key of a queued packet in the mac's buffer index (see combine_packets)
+uint64_t buffer_key(call_t *call, packet_t *packet)
+{
+    node_data_t *node_data = NODE_DATA(call);
+    header_t *header = PACKET_HEADER(packet, node_data);
+    return BUFFER_KEY(header->type, header->sender.id, header->next_node.id);
+}
+
 //checks to see if packets can be combined to reduce number of packets
 //returns true if packets are combined, false otherwise
 bool combine_packets(call_t *call, destination_t *sender,
@@ -1611,10 +1271,9 @@ bool combine_packets(call_t *call, destination_t *sender,
     node_data_t *node_data = NODE_DATA(call);
 
     call_t call_down = CALL_DOWN(call);
-    void *buffer = GET_BUFFER(&call_down);
+    uint64_t key = BUFFER_KEY(DATA_PACKET, sender->id, next_node->id);
     buffer_entry_t *entry = NULL;
-    das_init_traverse(buffer);
-    while((entry = (buffer_entry_t*)das_traverse(buffer)) != NULL)
+    while((entry = FIND_IN_BUFFER(&call_down, key, entry)) != NULL)
     {
 	header_t *header = PACKET_HEADER(entry->packet, node_data);
 	if(header->type == DATA_PACKET &&
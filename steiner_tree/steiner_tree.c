@@ -0,0 +1,866 @@
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "steiner_tree.h"
+
+#ifndef NEW
+#define NEW(type) malloc(sizeof(type))
+#endif
+
+// Slack on the angular sweep bound so rounding never skips a pair the
+// exact Steiner point test would keep.
+#define STEINER_SWEEP_SLACK 1e-6
+
+//=====================================================================
+// - Internal helpers
+
+//---------------------------------------------------------------------
+// * Tuple heap (max-heap on reduction ratio, FIFO among ties)
+
+typedef struct{
+    steiner_tuple*	tuples;
+    int			size;
+    int			capacity;
+    int			seq;
+} steiner_heap;
+
+//---------------------------------------------------------------------
+// * Target and its polar angle around the root
+
+typedef struct{
+    tree_node*		node;
+    double		angle;
+} steiner_polar;
+
+static bool steiner_same_position(position_t *l, position_t *r){
+    return l->x == r->x && l->y == r->y && l->z == r->z;
+}
+
+static bool steiner_same_destination(destination_t *l, destination_t *r){
+    return l->id == r->id && steiner_same_position(&l->position,
+	&r->position);
+}
+
+static int compare_polar(const void* polar1, const void* polar2){
+    double angle1 = ((steiner_polar*)polar1)->angle;
+    double angle2 = ((steiner_polar*)polar2)->angle;
+
+    if(angle1 < angle2) return -1;
+    if(angle1 > angle2) return  1;
+    return 0;
+}
+
+//---------------------------------------------------------------------
+// * Heap push/pop
+//---------------------------------------------------------------------
+static bool steiner_heap_push(steiner_heap* heap, steiner_tuple* tuple){
+    int i;
+
+    if(heap->size == heap->capacity){
+	int capacity = heap->capacity == 0 ? 16 : heap->capacity * 2;
+	steiner_tuple* tuples = realloc(heap->tuples,
+	    sizeof(steiner_tuple) * capacity);
+	if(tuples == NULL) return false;
+	heap->tuples = tuples;
+	heap->capacity = capacity;
+    }
+
+    tuple->seq = heap->seq++;
+    i = heap->size++;
+    while(i > 0 && compare_steiner_tuples(tuple,
+	&heap->tuples[(i - 1) / 2]) < 0){
+	heap->tuples[i] = heap->tuples[(i - 1) / 2];
+	i = (i - 1) / 2;
+    }
+    heap->tuples[i] = *tuple;
+
+    return true;
+}
+
+static steiner_tuple steiner_heap_pop(steiner_heap* heap){
+    steiner_tuple top = heap->tuples[0];
+    steiner_tuple last = heap->tuples[--heap->size];
+    int i = 0;
+
+    while(2 * i + 1 < heap->size){
+	int child = 2 * i + 1;
+	if(child + 1 < heap->size && compare_steiner_tuples(
+	    &heap->tuples[child + 1], &heap->tuples[child]) < 0)
+	    child++;
+	if(compare_steiner_tuples(&last, &heap->tuples[child]) <= 0) break;
+	heap->tuples[i] = heap->tuples[child];
+	i = child;
+    }
+    if(heap->size > 0) heap->tuples[i] = last;
+
+    return top;
+}
+
+//---------------------------------------------------------------------
+// * Release Tuple
+//---------------------------------------------------------------------
+// Frees the tuple's Steiner point if it was computed for this tuple
+// alone (a virtual node nobody adopted).
+//---------------------------------------------------------------------
+static void steiner_tuple_release(steiner_tuple* tuple){
+    if(tuple->t != tuple->s && tuple->t != tuple->u && tuple->t != tuple->v)
+	free_tree(tuple->t);
+}
+
+//---------------------------------------------------------------------
+// * Offer Tuple
+//---------------------------------------------------------------------
+// Computes the tuple (s, t, u, v) and the action it will take. The
+// root s is fixed for the whole construction, so the action is known
+// now: tuples that would be removed, and (u, v) tuples whose Steiner
+// point is s (both targets end up as children of s through their own
+// (u, u) tuples), are dropped instead of queued.
+//---------------------------------------------------------------------
+static void steiner_offer(steiner_heap* heap, tree_node* s, tree_node* u,
+    tree_node* v, double range){
+    steiner_tuple tuple;
+    double st, su, sv, tu, tv;
+
+    tuple.s = s;
+    tuple.u = u;
+    tuple.v = v;
+
+    // A1 : IF u == v, then s adds u|v as child
+    if(u == v){
+	tuple.t = s;
+	tuple.reduction_ratio = 0;
+	tuple.action = STEINER_S_ADDS_U;
+	if(!steiner_heap_push(heap, &tuple))
+	    fprintf(stderr, "[ERR] Can't allocate steiner tuple\n");
+	return;
+    }
+
+    tuple.t = steiner_point(s, u, v);
+    st = compute_node_distance(s, tuple.t);
+    su = compute_node_distance(s, u);
+    sv = compute_node_distance(s, v);
+    tu = compute_node_distance(tuple.t, u);
+    tv = compute_node_distance(tuple.t, v);
+    tuple.reduction_ratio = su + sv > 0 ? 1.0 - (st + tu + tv) / (su + sv) : 0;
+
+    // A2 : IF t is collocated with s, then s adds u and v as children
+    if(tuple.t == s)
+	return;
+    // A3 : IF t is collocated with u, then u adds v as child
+    else if(tuple.t == u)
+	tuple.action = STEINER_U_ADDS_V;
+    // A4 : IF t is collocated with v, then v adds u as child
+    else if(tuple.t == v)
+	tuple.action = STEINER_V_ADDS_U;
+    // A5 : IF d(s, u) < R && d(s, v) < R, then remove this tuple
+    else if(su < range && sv < range)
+	tuple.action = STEINER_REMOVE;
+    // A6 : IF only d(s, u) < R, remove this tuple if
+    //	R + d(t, u) + d(t, v) > d(s, u) + d(s, v), otherwise u adds v
+    else if(su < range)
+	tuple.action = range + tu + tv > su + sv ?
+	    STEINER_REMOVE : STEINER_U_ADDS_V;
+    // A7 : IF only d(s, v) < R, same as A6 with v adding u
+    else if(sv < range)
+	tuple.action = range + tu + tv > su + sv ?
+	    STEINER_REMOVE : STEINER_V_ADDS_U;
+    // A8 : IF d(s, t) < R && R + d(t, u) + d(t, v) > d(s, u) + d(s, v),
+    //	then s adds u and v as children
+    else if(st < range && range + tu + tv > su + sv)
+	tuple.action = STEINER_S_ADDS_UV;
+    // AD : virtual Steiner point t adds u and v as children
+    else
+	tuple.action = STEINER_T_ADDS_UV;
+
+    if(tuple.action == STEINER_REMOVE){
+	steiner_tuple_release(&tuple);
+	return;
+    }
+    if(!steiner_heap_push(heap, &tuple)){
+	fprintf(stderr, "[ERR] Can't allocate steiner tuple\n");
+	steiner_tuple_release(&tuple);
+    }
+}
+
+//---------------------------------------------------------------------
+// * Offer Initial Pairs
+//---------------------------------------------------------------------
+// Queues (u, u) for every target and (u, v) for every pair that can
+// have a Steiner point other than the root. Targets are swept in
+// polar order around the root and a target is only paired with those
+// less than 120 degrees away from it; farther pairs always resolve to
+// the root. Targets sitting on the root have no angle and are paired
+// with everyone.
+//---------------------------------------------------------------------
+static void steiner_offer_initial(steiner_heap* heap, tree_node* root,
+    tree_node** nodes, int count, double range){
+    steiner_polar* polar = malloc(sizeof(steiner_polar) * count);
+    int polar_count = 0, i, j, step;
+
+    for(i = 0; i < count; i++)
+	steiner_offer(heap, root, nodes[i], nodes[i], range);
+
+    // No room for the angular index: offer every pair
+    if(polar == NULL){
+	for(i = 0; i < count; i++)
+	    for(j = i + 1; j < count; j++)
+		steiner_offer(heap, root, nodes[i], nodes[j], range);
+	return;
+    }
+
+    for(i = 0; i < count; i++){
+	if(!steiner_same_position(&nodes[i]->location.position,
+	    &root->location.position)){
+	    polar[polar_count].node = nodes[i];
+	    polar[polar_count++].angle = get_angle_double(
+		nodes[i]->location.position, root->location.position);
+	    continue;
+	}
+	for(j = 0; j < count; j++){
+	    if(j == i || (j < i && steiner_same_position(
+		&nodes[j]->location.position, &root->location.position)))
+		continue;
+	    steiner_offer(heap, root, nodes[i], nodes[j], range);
+	}
+    }
+
+    qsort(polar, polar_count, sizeof(steiner_polar), compare_polar);
+
+    for(i = 0; i < polar_count; i++){
+	for(j = (i + 1) % polar_count, step = 1; step < polar_count;
+	    j = (j + 1) % polar_count, step++){
+	    double sweep = polar[j].angle - polar[i].angle;
+	    if(j < i) sweep += 2 * STEINER_PI;
+	    if(sweep > 2 * STEINER_PI / 3 + STEINER_SWEEP_SLACK) break;
+
+	    steiner_offer(heap, root, polar[i].node, polar[j].node, range);
+	}
+    }
+
+    free(polar);
+}
+
+//=====================================================================
+// - Construction
+
+//---------------------------------------------------------------------
+// * Build Steiner Tree
+//---------------------------------------------------------------------
+// Builds a Steiner tree rooted at source over the real targets. range
+// is the radio range used by the removal and adoption rules.
+//---------------------------------------------------------------------
+tree_node* build_steiner_tree(destination_t* source,
+    destination_t** target_list, int target_count, double range){
+    steiner_heap heap = {NULL, 0, 0, 0};
+    tree_node* root = generate_real_node(source);
+    tree_node** nodes = NULL;
+    int node_count, i;
+
+    if(root == NULL || target_count <= 0) return root;
+
+    // Every AD round retires two active nodes and adds one virtual node,
+    // so at most target_count - 1 virtual nodes join the targets.
+    if((nodes = malloc(sizeof(tree_node*) * 2 * target_count)) == NULL){
+	fprintf(stderr, "[ERR] Can't allocate steiner destinations\n");
+	return root;
+    }
+    for(node_count = 0; node_count < target_count; node_count++)
+	nodes[node_count] = generate_real_node(target_list[node_count]);
+
+    steiner_offer_initial(&heap, root, nodes, target_count, range);
+
+    while(heap.size > 0){
+	steiner_tuple best = steiner_heap_pop(&heap);
+
+	// Tuples made stale by an earlier round are dropped here
+	if(!best.u->isActive || !best.v->isActive){
+	    steiner_tuple_release(&best);
+	    continue;
+	}
+
+#ifdef DBG_STEINER
+	fprintf(stderr, "[STN] ratio %f action %d on u:%d v:%d\n",
+	    best.reduction_ratio, best.action, best.u->location.id,
+	    best.v->location.id);
+#endif
+	switch(best.action){
+	    case STEINER_S_ADDS_U:
+		add_child(root, best.u);
+		break;
+	    case STEINER_S_ADDS_UV:
+		add_child(root, best.u);
+		add_child(root, best.v);
+		break;
+	    case STEINER_U_ADDS_V:
+		add_child(best.u, best.v);
+		break;
+	    case STEINER_V_ADDS_U:
+		add_child(best.v, best.u);
+		break;
+	    case STEINER_T_ADDS_UV:
+		add_child(best.t, best.u);
+		add_child(best.t, best.v);
+
+		// The virtual point becomes a destination; only its own pairs
+		// (itself included) are new
+		nodes[node_count++] = best.t;
+		for(i = 0; i < node_count; i++){
+		    if(nodes[i]->isActive)
+			steiner_offer(&heap, root, best.t, nodes[i], range);
+		}
+		continue;
+	    default:
+		break;
+	}
+	steiner_tuple_release(&best);
+    }
+
+    free(heap.tuples);
+    free(nodes);
+
+    return root;
+}
+
+//=====================================================================
+// - Tree nodes
+
+// Create a tree tree out of a real target
+tree_node* generate_real_node(destination_t* target)
+{
+    tree_node* node = NEW(tree_node);
+    node->location = *target;
+    node->children = NULL;
+    node->child_count = 0;
+    node->isVirtual = false;
+    node->isActive = true;
+
+    return node;
+}
+
+// Create a tree tree out of a virtual target
+tree_node* generate_virtual_node(position_t position)
+{
+    tree_node* vnode = NEW(tree_node);
+
+    // Generate a virtual destination: has ID == -3
+    vnode->location.id = STEINER_VIRTUAL_ID;
+    vnode->location.position = position;
+    vnode->children = NULL;
+    vnode->child_count = 0;
+    vnode->isVirtual = true;
+    vnode->isActive = true;
+
+    return vnode;
+}
+
+// Deep copy a tree so the copy can be reshaped by routing
+tree_node* copy_tree(tree_node* node)
+{
+    tree_node* copy = NEW(tree_node);
+    int i;
+
+    if(copy == NULL) return NULL;
+    *copy = *node;
+    copy->children = NULL;
+    if(node->child_count > 0){
+	copy->children = malloc(sizeof(tree_node*) * node->child_count);
+        for(i = 0; i < node->child_count; i++){
+            copy->children[i] = copy_tree(node->children[i]);
+        }
+    }
+
+    return copy;
+}
+
+// Free a tree and all of its descendants
+void free_tree(tree_node* node)
+{
+    int i;
+
+    if(node == NULL) return;
+    for(i = 0; i < node->child_count; i++){
+        free_tree(node->children[i]);
+    }
+    free(node->children);
+    free(node);
+}
+
+// Add a child node to a parent node's children list (and count)
+void add_child(tree_node* parent, tree_node* child)
+{
+    tree_node** children = parent->children;
+    int i = 0;
+
+    // Allocate a new child array of size + 1
+    parent->child_count++;
+    parent->children = malloc(sizeof(tree_node*) * parent->child_count);
+
+    // Copy over old child array to new larger array
+    if(children != NULL){
+        for(i = 0; i < parent->child_count - 1; i++){
+            parent->children[i] = children[i];
+        }
+        free(children);
+    }
+
+    // Add the newest child at the end
+    parent->children[i] = child;
+
+    // Deactivate child from tree ownership consideration
+    child->isActive = false;
+}
+
+// Remove a child at a given index from a parent's child array
+void remove_child(tree_node* parent, int child_index)
+{
+    tree_node** children = parent->children;
+    int i, j;
+
+    // Allocate a new child array of size - 1
+    parent->child_count--;
+    parent->children = malloc(sizeof(tree_node*) * parent->child_count);
+
+    // Copy over each child from the original array, EXCEPT the designated orphan
+    for(i = 0, j = 0; i < parent->child_count; j++){
+        parent->children[i] = children[j];
+
+        // Continue for all but designated orphan
+        if(i != child_index) i++;
+    }
+    free(children);
+}
+
+// Calculate the sum of the distance this node and all its non-virtual descendants and some origin
+double distance_sum(tree_node* node, position_t origin)
+{
+    double d = (node->isVirtual ? 0 : compute_distance(node->location.position, origin));
+
+    int i;
+    for(i = 0; i < node->child_count; i++){
+        d += distance_sum(node->children[i], origin);
+    }
+
+    return d;
+}
+
+// Calculate the number of non-virtual descendants (+ 1) of a given node
+int sub_target_count(tree_node* node)
+{
+    int total = 0, i;
+
+    if(!node->isVirtual) total++;
+
+    for(i = 0; i < node->child_count; i++){
+        total += sub_target_count(node->children[i]);
+    }
+
+    return total;
+}
+
+// Gather a cumulative list in target_list of all non-virtual descendants of node
+destination_t** sub_target_list(tree_node* node)
+{
+    destination_t** target_list = malloc(sizeof(destination_t*) * sub_target_count(node));
+    int current = 0;
+
+    accumulate_target_list(node, target_list, &current);
+
+    return target_list;
+}
+
+// Recursively accumulate non-virtual descendants of node
+void accumulate_target_list(tree_node* node, destination_t** target_list, int* current)
+{
+    if(!node->isVirtual){
+        target_list[(*current)++] = &node->location;
+    }
+
+    int i;
+    for(i = 0; i < node->child_count; i++){
+        accumulate_target_list(node->children[i], target_list, current);
+    }
+}
+
+// Comparison function ordering steiner tuples by descending reduction ratio,
+// oldest first among equal ratios
+int compare_steiner_tuples(const void* tuple1, const void* tuple2)
+{
+    const steiner_tuple* t1 = (const steiner_tuple*)tuple1;
+    const steiner_tuple* t2 = (const steiner_tuple*)tuple2;
+
+    if(t1->reduction_ratio > t2->reduction_ratio) return -1;
+    if(t1->reduction_ratio < t2->reduction_ratio) return  1;
+    return t1->seq - t2->seq;
+}
+
+// Print function for debugging trees
+void print_tree(tree_node* node, int tab)
+{
+    int i, t;
+
+    for(t = 0; t < tab * 3; t++) fprintf(stderr, " ");
+
+    fprintf(stderr, "<id: %d (%f, %f), active: %s, virtual: %s>\n",
+	node->location.id, node->location.position.x, node->location.position.y,
+        (node->isActive ? "YES" : "NO"),
+        (node->isVirtual ? "YES" : "NO")
+    );
+    for(i = 0; i < node->child_count; i++)
+	print_tree(node->children[i], tab + 1);
+
+}
+
+//=====================================================================
+// - Geometry
+
+// Get the counter-clockwise angle between a east-pointing vector to single point
+double get_angle_single(position_t a)
+{
+    return atan2(a.y, a.x);
+}
+
+// Get the counter-clockwise angle between two points
+double get_angle_double(position_t a, position_t b)
+{
+    return atan2(a.y - b.y, a.x - b.x);
+}
+
+// Get the counter-clockwise angle <ABC
+double get_angle_triple(position_t a, position_t b, position_t c)
+{
+    return atan2(c.y - b.y, c.x - b.x) - atan2(a.y - b.y, a.x - b.x);
+}
+
+// Get the acute angle <ABC
+double get_acute_angle_triple(position_t a, position_t b, position_t c)
+{
+    double angle = fabs(get_angle_triple(a, b, c));
+
+    // Choose acute side
+    if(angle > STEINER_PI) angle = 2 * STEINER_PI - angle;
+
+    return angle;
+}
+
+// Get the third point of an equillateral triangle formed by two points a and b,
+// angled so that the base formed by a and b is facing c.
+position_t get_equillateral_third(position_t a, position_t b, position_t c)
+{
+    // distance from A to B
+    double dAB = compute_distance(a, b);
+
+    // Clockwise angle from A to B
+    double AB = STEINER_PI - get_angle_double(a, b);
+
+    // <BAC in radians
+    double BAC = get_angle_triple(b, a, c);
+
+    // rotate AB by 1/3 PI to get the angle of the third point on the equillateral
+    // triangle.
+    double shift = STEINER_PI / 3;
+
+    // flip rotation if BAC is outside [0, 180] degree range, but not lower than -180
+    if(BAC < 0) shift *= -1;
+    if(fabs(BAC) > STEINER_PI) shift *= -1;
+
+    AB += shift;
+
+    // Generate virtual node at the computed equillateral third
+    position_t equillateral_third;
+    equillateral_third.x = a.x + dAB * cos(AB);
+    equillateral_third.y = a.y - dAB * sin(AB);
+    equillateral_third.z = 0;
+
+    return equillateral_third;
+}
+
+// Calculate the steiner point of three tree nodes - the point which yields a 60-degree angle
+// between each adjacent pair of node locations and itself.
+tree_node* steiner_point(tree_node* a, tree_node* b, tree_node* c)
+{
+    double bac = get_acute_angle_triple(b->location.position, a->location.position, c->location.position);
+    double abc = get_acute_angle_triple(a->location.position, b->location.position, c->location.position);
+    double acb = get_acute_angle_triple(a->location.position, c->location.position, b->location.position);
+
+#ifdef DBG_STEINER
+    fprintf(stderr, "[STN] a : (%f, %f)\n", a->location.position.x, a->location.position.y);
+    fprintf(stderr, "[STN] b : (%f, %f)\n", b->location.position.x, b->location.position.y);
+    fprintf(stderr, "[STN] c : (%f, %f)\n", c->location.position.x, c->location.position.y);
+
+    fprintf(stderr, "[STN] bac : %f\n", bac);
+    fprintf(stderr, "[STN] abc : %f\n", abc);
+    fprintf(stderr, "[STN] acb : %f\n", acb);
+#endif
+
+    // 1) If two points are collocated (same position), steiner is the remaining third point
+    if(steiner_same_position(&a->location.position, &b->location.position)){
+        return c;
+    }
+    else if(steiner_same_position(&a->location.position, &c->location.position)){
+        return b;
+    }
+    else if(steiner_same_position(&b->location.position, &c->location.position)){
+        return a;
+    }
+    // 2) if the acute angle of any <XYZ is > 120 degrees, steiner is Y
+    else if(bac > 2 * STEINER_PI / 3){
+        return a;
+    }
+    else if(abc > 2 * STEINER_PI / 3){
+        return b;
+    }
+    else if(acb > 2 * STEINER_PI / 3){
+        return c;
+    }
+    // 3) Compute the proper steiner point when all special cases checkout
+    else{
+        // Get third points on equillateral triangles formed by two pairs (third pair is uneccessary)
+        position_t ab = get_equillateral_third(a->location.position, b->location.position, c->location.position);
+        position_t ac = get_equillateral_third(a->location.position, c->location.position, b->location.position);
+
+#ifdef DBG_STEINER
+	fprintf(stderr, "[STN] ab : (%f, %f)\n", ab.x, ab.y);
+	fprintf(stderr, "[STN] ac : (%f, %f)\n", ac.x, ac.y);
+#endif
+
+	// Compute intersection of the lines formed by each equillateral third and the remaining point
+        position_t steiner = get_intersection_point(ab, c->location.position, ac, b->location.position);
+
+#ifdef DBG_STEINER
+        fprintf(stderr, "[STN] st : (%f, %f)\n", steiner.x, steiner.y);
+#endif
+        return generate_virtual_node(steiner);
+    }
+}
+
+// Compute the distance between two steiner tree node locations
+double compute_node_distance(tree_node* a, tree_node* b){
+    return compute_distance(a->location.position, b->location.position);
+}
+
+// Compute the distance between two locations
+double compute_distance(position_t a, position_t b){
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+// Get the point of intersection between the lines containing points a1+a2 and b1+b2
+position_t get_intersection_point(position_t a1, position_t a2, position_t b1, position_t b2)
+{
+#ifdef DBG_STEINER
+    fprintf(stderr, "[STN] Calculating intersection between L1<(%f, %f) - (%f, %f)>\n[STN]   and L2<(%f, %f) - (%f, %f)> ... \n",
+	a1.x, a1.y, a2.x, a2.y, b1.x, b1.y, b2.x, b2.y);
+#endif
+
+    position_t intersection;
+    intersection.z = 0;
+
+    // line slopes
+    double m1 = 0, m2 = 0;
+
+    // Calculate slope (if possible: non-vertical line)
+    if(a2.x != a1.x){
+        m1 = (a2.y - a1.y) / (a2.x - a1.x);
+    }
+
+    if(b2.x != b1.x){
+        m2 = (b2.y - b1.y) / (b2.x - b1.x);
+    }
+
+#ifdef DBG_STEINER
+    fprintf(stderr, "   M1: %f\n   M2: %f\n", m1, m2);
+#endif
+
+    // Check for vertical lines
+    if(a2.x == a1.x && b2.x == b1.x){
+        // if both lines are vertical, the lines are parallel and no point of intersection exists
+        intersection.x = 0;
+        intersection.y = 0;
+
+        fprintf(stderr, "[ERR] Tried to calculate the intersection of two parallel lines.");
+    }
+    else if(a2.x == a1.x){
+        intersection.x = a1.x;
+        intersection.y = m2 * (a1.x - b1.x) + b1.y;
+    }
+    else if(b2.x == b1.x){
+        intersection.x = b1.x;
+        intersection.y = m1 * (b1.x - a1.x) + a1.y;
+    }
+    else{
+        intersection.x = (a1.y - m1 * a1.x - b1.y + m2 * b1.x) / (m2 - m1);
+        intersection.y = (m1 * m2 * (b1.x - a1.x) - m1 * b1.y + m2 * a1.y) / (m2 - m1);
+    }
+
+#ifdef DBG_STEINER
+    fprintf(stderr, "[STN] intersection is: (%f, %f)\n", intersection.x, intersection.y);
+#endif
+
+    return intersection;
+}
+
+//=====================================================================
+// - Cache
+
+static int compare_cache_destinations(const void* dest1, const void* dest2){
+    const destination_t* l = (const destination_t*)dest1;
+    const destination_t* r = (const destination_t*)dest2;
+
+    if(l->id != r->id) return l->id < r->id ? -1 : 1;
+    if(l->position.x != r->position.x) return l->position.x < r->position.x ? -1 : 1;
+    if(l->position.y != r->position.y) return l->position.y < r->position.y ? -1 : 1;
+    if(l->position.z != r->position.z) return l->position.z < r->position.z ? -1 : 1;
+    return 0;
+}
+
+//---------------------------------------------------------------------
+// * Key Hash (FNV-1a over ids and coordinates)
+//---------------------------------------------------------------------
+static uint64_t steiner_hash_word(uint64_t hash, uint64_t word){
+    int i;
+
+    for(i = 0; i < 8; i++){
+	hash ^= (word >> (i * 8)) & 0xff;
+	hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static uint64_t steiner_hash_destination(uint64_t hash, destination_t* dest){
+    uint64_t bits;
+
+    hash = steiner_hash_word(hash, (uint64_t)(int64_t)dest->id);
+    memcpy(&bits, &dest->position.x, sizeof(bits));
+    hash = steiner_hash_word(hash, bits);
+    memcpy(&bits, &dest->position.y, sizeof(bits));
+    hash = steiner_hash_word(hash, bits);
+    memcpy(&bits, &dest->position.z, sizeof(bits));
+
+    return steiner_hash_word(hash, bits);
+}
+
+static void steiner_cache_clear(steiner_cache_entry* entry){
+    free_tree(entry->tree);
+    free(entry->targets);
+    entry->tree = NULL;
+    entry->targets = NULL;
+    entry->target_count = 0;
+}
+
+//---------------------------------------------------------------------
+// * Create Steiner Cache
+//---------------------------------------------------------------------
+// Direct-mapped cache of slot_cnt trees built with radio range 'range'.
+// A colliding key simply replaces the slot's tree.
+//---------------------------------------------------------------------
+steiner_cache* create_steiner_cache(double range, int slot_cnt){
+    steiner_cache* cache = NEW(steiner_cache);
+    int i;
+
+    if(cache == NULL) return NULL;
+    if(slot_cnt < 1) slot_cnt = STEINER_CACHE_SLOTS;
+    if((cache->slots = malloc(sizeof(steiner_cache_entry) * slot_cnt)) == NULL){
+	free(cache);
+	return NULL;
+    }
+
+    cache->range = range;
+    cache->slot_cnt = slot_cnt;
+    cache->hits = 0;
+    cache->misses = 0;
+    for(i = 0; i < slot_cnt; i++){
+	cache->slots[i].tree = NULL;
+	cache->slots[i].targets = NULL;
+	cache->slots[i].target_count = 0;
+    }
+
+    return cache;
+}
+
+//---------------------------------------------------------------------
+// * Destroy Steiner Cache
+//---------------------------------------------------------------------
+void steiner_cache_destroy(steiner_cache* cache){
+    int i;
+
+    if(cache == NULL) return;
+    for(i = 0; i < cache->slot_cnt; i++)
+	steiner_cache_clear(&cache->slots[i]);
+    free(cache->slots);
+    free(cache);
+}
+
+//---------------------------------------------------------------------
+// * Cached Build
+//---------------------------------------------------------------------
+// Returns a private copy of the Steiner tree rooted at source over the
+// target set, building it only if the (source, sorted targets) key is
+// not cached. Targets are matched on id and position, so a moved node
+// or a different virtual pivot is a different key. The caller owns
+// the returned tree and may reshape it freely.
+//---------------------------------------------------------------------
+tree_node* steiner_cache_build(steiner_cache* cache, destination_t* source,
+    destination_t** target_list, int target_count){
+    destination_t* targets = NULL;
+    destination_t** sorted = NULL;
+    steiner_cache_entry* entry;
+    uint64_t key = 14695981039346656037ULL;
+    int i;
+
+    if(cache == NULL) return NULL;
+    if(target_count < 0) target_count = 0;
+
+    if(target_count > 0 &&
+	(targets = malloc(sizeof(destination_t) * target_count)) == NULL)
+	return build_steiner_tree(source, target_list, target_count,
+	    cache->range);
+    for(i = 0; i < target_count; i++)
+	targets[i] = *target_list[i];
+    qsort(targets, target_count, sizeof(destination_t),
+	compare_cache_destinations);
+
+    key = steiner_hash_destination(key, source);
+    for(i = 0; i < target_count; i++)
+	key = steiner_hash_destination(key, &targets[i]);
+
+    entry = &cache->slots[key % cache->slot_cnt];
+    if(entry->tree != NULL && entry->key == key &&
+	entry->target_count == target_count &&
+	steiner_same_destination(&entry->source, source)){
+	for(i = 0; i < target_count; i++)
+	    if(!steiner_same_destination(&entry->targets[i], &targets[i]))
+		break;
+	if(i == target_count){
+	    free(targets);
+	    cache->hits++;
+	    return copy_tree(entry->tree);
+	}
+    }
+
+    // Miss: build from the canonical order so equal keys give equal trees
+    cache->misses++;
+    if(target_count > 0 &&
+	(sorted = malloc(sizeof(destination_t*) * target_count)) == NULL){
+	free(targets);
+	return build_steiner_tree(source, target_list, target_count,
+	    cache->range);
+    }
+    for(i = 0; i < target_count; i++)
+	sorted[i] = &targets[i];
+
+    steiner_cache_clear(entry);
+    entry->key = key;
+    entry->source = *source;
+    entry->targets = targets;
+    entry->target_count = target_count;
+    entry->tree = build_steiner_tree(source, sorted, target_count,
+	cache->range);
+    free(sorted);
+
+    return entry->tree == NULL ? NULL : copy_tree(entry->tree);
+}
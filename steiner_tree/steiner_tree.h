@@ -0,0 +1,135 @@
+//=====================================================================
+// ** Steiner Tree
+//=====================================================================
+// Geometric Steiner tree heuristic used by the GMP family to split a
+// multicast target set. A tuple (s, t, u, v) pairs two targets u and
+// v with the root s and their Steiner point t; tuples are consumed in
+// descending order of reduction ratio, each attaching targets to the
+// root, to one another, or to a new virtual Steiner point.
+//
+// Construction is incremental: tuples live in a max-heap, tuples made
+// stale by an earlier round are dropped as they surface, and only the
+// pairs of a newly added virtual point are pushed. Because the root
+// never changes, a tuple's action is fixed when it is generated:
+// tuples that would only be discarded are never queued, and an
+// angular index of the targets around the root skips the pairs whose
+// Steiner point is the root itself (those targets are attached to
+// the root by their own (u, u) tuple anyway).
+//
+// A steiner_cache keeps finished trees keyed on the source and the
+// sorted target set, so forwarding nodes that split the same
+// sub-target list again get a copy instead of a rebuild.
+//=====================================================================
+#ifndef __steiner_tree__
+#define __steiner_tree__
+
+#include <stdbool.h>
+#include <include/modelutils.h>
+
+#define STEINER_PI 3.14159265
+#define STEINER_VIRTUAL_ID -3
+#define STEINER_CACHE_SLOTS 256
+
+//---------------------------------------------------------------------
+// * Routing tree of multicast targets
+
+typedef struct tnode{
+    destination_t	location;
+    struct tnode**	children;
+    int			child_count;
+    bool		isVirtual;
+    bool		isActive;
+} tree_node;
+
+//---------------------------------------------------------------------
+// * Action a tuple takes when it reaches the top of the heap
+
+typedef enum {
+    STEINER_REMOVE,	// A5, A6-a, A7-a : drop the tuple
+    STEINER_S_ADDS_U,	// A1 : u == v, s adds u
+    STEINER_S_ADDS_UV,	// A2, A8 : s adds u and v
+    STEINER_U_ADDS_V,	// A3, A6-b : u adds v
+    STEINER_V_ADDS_U,	// A4, A7-b : v adds u
+    STEINER_T_ADDS_UV	// AD : virtual t adds u and v
+} steiner_action_e;
+
+//---------------------------------------------------------------------
+// * Tuple (root, steiner, left, right) for tree construction
+
+typedef struct{
+    tree_node*		s;
+    tree_node*		t;
+    tree_node*		u;
+    tree_node*		v;
+    double		reduction_ratio;
+    steiner_action_e	action;
+    int			seq;
+} steiner_tuple;
+
+//---------------------------------------------------------------------
+// * Cached tree for one (source, sorted target set) key
+
+typedef struct{
+    uint64_t		key;
+    destination_t	source;
+    destination_t*	targets;
+    int			target_count;
+    tree_node*		tree;
+} steiner_cache_entry;
+
+//---------------------------------------------------------------------
+// * Steiner tree cache main data structure
+
+typedef struct{
+    double		range;
+    int			slot_cnt;
+    steiner_cache_entry* slots;
+    int			hits;	// builds served from a slot
+    int			misses;	// builds that computed a tree
+} steiner_cache;
+
+//-----------------------------------
+// - Steiner Tree Methods
+//-----------------------------------
+tree_node*	build_steiner_tree(destination_t* source,
+		    destination_t** target_list, int target_count,
+		    double range);
+
+// - Tree nodes
+tree_node*	generate_real_node(destination_t* target);
+tree_node*	generate_virtual_node(position_t position);
+tree_node*	copy_tree(tree_node* node);
+void		free_tree(tree_node* node);
+void		add_child(tree_node* parent, tree_node* child);
+void		remove_child(tree_node* parent, int child_index);
+double		distance_sum(tree_node* node, position_t origin);
+int		sub_target_count(tree_node* node);
+destination_t**	sub_target_list(tree_node* node);
+void		accumulate_target_list(tree_node* node,
+		    destination_t** target_list, int* current);
+int		compare_steiner_tuples(const void* tuple1,
+		    const void* tuple2);
+void		print_tree(tree_node* node, int tab);
+
+// - Geometry
+double		get_angle_single(position_t a);
+double		get_angle_double(position_t a, position_t b);
+double		get_angle_triple(position_t a, position_t b, position_t c);
+double		get_acute_angle_triple(position_t a, position_t b,
+		    position_t c);
+position_t	get_equillateral_third(position_t a, position_t b,
+		    position_t c);
+position_t	get_intersection_point(position_t a1, position_t a2,
+		    position_t b1, position_t b2);
+tree_node*	steiner_point(tree_node* a, tree_node* b, tree_node* c);
+double		compute_node_distance(tree_node* a, tree_node* b);
+double		compute_distance(position_t a, position_t b);
+
+// - Cache
+steiner_cache*	create_steiner_cache(double range, int slot_cnt);
+void		steiner_cache_destroy(steiner_cache* cache);
+tree_node*	steiner_cache_build(steiner_cache* cache,
+		    destination_t* source, destination_t** target_list,
+		    int target_count);
+
+#endif //__steiner_tree__
@@ -28,7 +28,7 @@ model_t model =
 #define ERROR -1
 #define EMPTY_DESTINATION {-2, {-1, -1, -1}}
 
-#define CALL_DOWN(call) {get_entity_bindings_down(call)->elts[0], call->node,\
+#define CALL_DOWN(call) {get_chain(call)->down, call->node,\
 	call->entity}
 
 #define TRUE 1
@@ -206,7 +206,7 @@ int call_back(call_t *call, void *args)
     }
 
     entity_data->data_tx++;
-    TX(&call_down, packet);
+    TX_DOWN(call, packet);
     return 0;
 }
 
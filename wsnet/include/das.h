@@ -14,6 +14,18 @@
 typedef int (* das_delete_func_t)(void *, void *);
 
 
+/** \brief A doubly linked list, the default structure. **/
+#define DAS_LIST    0
+
+/** \brief A growable array: O(1) das_get() and cache friendly traversals. **/
+#define DAS_VECTOR  1
+
+/** \brief A set keyed by the int id each object starts with (e.g. a
+ * destination_t): O(1) das_find() and das_delete(), which then match objects
+ * on their id and not on their address. **/
+#define DAS_HASH    2
+
+
 /**
  * \brief Initialize the das module. Done by the wsnet core.
  * \return 0 if success, -1 otherwise.
@@ -28,6 +40,16 @@ int das_init(void);
 void *das_create(void);
 
 
+/**
+ * \brief Create an empty data structure of a given kind. Every das function
+ * works on any kind: objects are traversed newest first, das_pop() returns the
+ * newest one and das_pop_FIFO() the oldest one.
+ * \param kind DAS_LIST, DAS_VECTOR or DAS_HASH.
+ * \return An opaque pointer to the data structure, NULL on error.
+ **/ 
+void *das_create_with(int kind);
+
+
 /**
  * \brief Destroy a data structure. Objects in the structure are not deallocated.
  * \param das the opaque pointer to the data structure.
@@ -108,4 +130,14 @@ void das_init_traverse(void *das);
 void *das_traverse(void *das);
 
 
+/**
+ * \brief Return the object at a given rank of the traversal order, in O(1)
+ * for a DAS_VECTOR. Other kinds restart the current traversal.
+ * \param das the opaque pointer to the data structure.
+ * \param index the rank of the object, 0 being the newest one.
+ * \return The object, NULL if index is out of range.
+ **/
+void *das_get(void *das, int index);
+
+
 #endif //__das__
@@ -166,4 +166,71 @@ int get_entity_links_down_nbr(call_t *c);
 entityid_t *get_entity_links_down(call_t *c);
 
 
+/* ************************************************** */
+/* ************************************************** */
+/** \typedef chain_t
+ * \brief An entity of a bundle with its first up and down entities already
+ * resolved, see get_chain().
+ **/
+/** \struct _chain
+ * \brief An entity of a bundle with its first up and down entities already
+ * resolved. Should use type chain_t.
+ **/
+typedef struct _chain {
+    entityid_t up;                               /* first entity up, -1 if none */
+    entityid_t down;                             /* first entity down, -1 if none */
+    void (*tx) (call_t *c, packet_t *packet);    /* tx of down, NULL if none */
+    int slot;                                    /* of the node private data, -1 if not in the bundle */
+} chain_t;
+
+/** \typedef node_chain_t
+ * \brief The chains of the bundle of a node, and the node private data.
+ **/
+/** \struct _node_chain
+ * \brief The chains of the bundle of a node, and the node private data.
+ * Should use type node_chain_t.
+ **/
+typedef struct _node_chain {
+    chain_t *chain;                              /* by entity id */
+    void **private;                              /* by slot */
+} node_chain_t;
+
+/* by node id, set once nodes are configured (before setnode()) */
+extern node_chain_t *node_chains;
+
+
+/**
+ * \brief Return "c->entity" in the bundle of "c->node", with its first up and
+ * down entities, as resolved at configuration.
+ * \param c sould be {entity id, node id, -1}.
+ * \return The chain of the entity in the node.
+ **/
+static inline chain_t *get_chain(call_t *c) {
+    return node_chains[c->node].chain + c->entity;
+}
+
+
+/**
+ * \brief Same as get_node_private_data(), through the chains.
+ * \param c sould be {entity id, node id, -1}.
+ * \return A (void *) pointer to the (entity, node) private data.
+ **/
+static inline void *get_chain_private_data(call_t *c) {
+    node_chain_t *node_chain = node_chains + c->node;
+    return node_chain->private[node_chain->chain[c->entity].slot];
+}
+
+
+/**
+ * \brief Transmit a packet to the first entity down "c->entity" in "c->node".
+ * \param c sould be {entity id, node id, -1}.
+ * \param packet the packet.
+ **/
+static inline void TX_DOWN(call_t *c, packet_t *packet) {
+    chain_t *chain = get_chain(c);
+    call_t c0 = {chain->down, c->node, c->entity};
+    chain->tx(&c0, packet);
+}
+
+
 #endif //__entity_public__
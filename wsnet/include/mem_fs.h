@@ -7,6 +7,19 @@
 #ifndef __mem_fs__
 #define __mem_fs__
 
+#include <stdio.h>
+
+
+/** \typedef mem_fs_stats_t
+ * \brief Usage of a memory slice.
+ **/
+typedef struct _mem_fs_stats {
+    int  size;       /* size of the blocks of the slice */
+    long live;       /* blocks currently allocated */
+    long high_water; /* maximum of live since declaration or last reset */
+    long capacity;   /* blocks the slice can hold without growing */
+} mem_fs_stats_t;
+
 
 /**
  * \brief Clean the mem_fs module. Done by the wsnet core.
@@ -38,4 +51,29 @@ void *mem_fs_alloc(void *slice);
 void mem_fs_dealloc(void *slice, void *pointer);
 
 
+/**
+ * \brief Return every block of every slice at once, keeping the slices
+ * declared and their memory for later allocations. Blocks allocated before
+ * the reset must not be used or deallocated afterwards. The core does not
+ * call it: modules release their blocks one by one when they are cleaned.
+ * \return 0 on success, -1 if the allocation policy does not support it.
+ **/
+int mem_fs_reset(void);
+
+
+/**
+ * \brief Get the usage of a slice.
+ * \param slice the opaque pointer to the memory slice.
+ * \param stats filled with the slice usage.
+ **/
+void mem_fs_slice_stats(void *slice, mem_fs_stats_t *stats);
+
+
+/**
+ * \brief Print the usage of every declared slice.
+ * \param stream where to print.
+ **/
+void mem_fs_dump_stats(FILE *stream);
+
+
 #endif //__mem_fs__
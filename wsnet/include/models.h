@@ -55,6 +55,10 @@ typedef struct _model { /* Model description          */
  **/
 typedef struct _propagation_methods {
     double (* propagation) (call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, double rxdBm);
+    /* optional: sets *dst to the nodes src can reach, sorted by id, and
+     * returns their number. The medium then only delivers to these nodes
+     * (and src itself) instead of every node. */
+    int (* receivers) (call_t *c, nodeid_t src, nodeid_t **dst);
 } propagation_methods_t;
 
 
@@ -260,6 +264,10 @@ typedef struct _mac_methods {
     void* (*get_buffer)(call_t *call);
     void (*set_buffer)(call_t *call, void *new_buffer);
     /* end of edition */
+    void (*set_buffer_key)(call_t *call, call_t *call_up,
+        uint64_t (*key)(call_t *call, packet_t *packet));
+    void* (*find_in_buffer)(call_t *call, uint64_t key, void *after);
+    void (*delete_from_buffer)(call_t *call, void *entry);
 } mac_methods_t;
 
 
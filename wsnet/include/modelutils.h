@@ -89,6 +89,128 @@ typedef struct
 {
     packet_t *packet;
     event_t *event;
+    uint64_t key;
 }buffer_entry_t;
 /* end of edition */
+
+/* buffer index: lets a routing module find its packets in the mac buffer
+ * without walking it. The routing module registers a function computing a
+ * packet's key (see BUFFER_KEY), the mac keys every packet it queues and
+ * FIND_IN_BUFFER returns the queued entries with a given key, newest first.
+ * Keys may collide, callers still check the headers of what they get. */
+typedef uint64_t (*buffer_key_t)(call_t *call, packet_t *packet);
+
+#define BUFFER_KEY(type, sender, next_hop) \
+    ((((uint64_t)(type) & 0xffff) << 48) | \
+    (((uint64_t)(sender) & 0xffffff) << 24) | \
+    ((uint64_t)(next_hop) & 0xffffff))
+
+/**
+ * \brief Register the key function of the routing entity call_up with the mac
+ * entity below it.
+ * \return 0 on success, -1 if the mac has no buffer index.
+ **/
+int SET_BUFFER_KEY(call_t *call, call_t *call_up, buffer_key_t key);
+
+/**
+ * \brief Next entry of the mac buffer with the given key, after entry after
+ * (from the newest if after is NULL).
+ * \return The entry, or NULL if there is none or the mac has no buffer index.
+ **/
+buffer_entry_t *FIND_IN_BUFFER(call_t *call, uint64_t key,
+    buffer_entry_t *after);
+
+/**
+ * \brief Take an entry found with FIND_IN_BUFFER out of the mac buffer. The
+ * caller owns the entry, its packet and its event afterwards.
+ * \return 0 on success, -1 if the mac can't delete single entries.
+ **/
+int DELETE_FROM_BUFFER(call_t *call, buffer_entry_t *entry);
+
+/* index maintenance, for the mac modules */
+typedef struct _buffer_index buffer_index_t;
+
+buffer_index_t *buffer_index_create(void);
+void buffer_index_destroy(buffer_index_t *index);
+void buffer_index_clear(buffer_index_t *index);
+void buffer_index_insert(buffer_index_t *index, buffer_entry_t *entry);
+void buffer_index_remove(buffer_index_t *index, buffer_entry_t *entry);
+void buffer_index_rebuild(buffer_index_t *index, void *buffer);
+buffer_entry_t *buffer_index_find(buffer_index_t *index, uint64_t key,
+    buffer_entry_t *after);
+
+/* binary tables: models reading large tables from a file (routes,
+ * positions, links) also accept a binary form of the file, a table_header_t
+ * followed by count records of record_size bytes, which is mapped in memory
+ * instead of being parsed. The magic tells the tables apart. */
+#define TABLE_MAGIC_SIZE 8
+
+typedef struct _table_header {
+    char magic[TABLE_MAGIC_SIZE];
+    int32_t record_size;
+    int32_t count;
+} table_header_t;
+
+typedef struct _table {
+    void *records;  /* count records, read only */
+    int count;
+    void *map;      /* the mapping, or the records read from a text form */
+    size_t length;  /* 0 for a text form */
+} table_t;
+
+/**
+ * \brief Map the binary table of file path.
+ * \return 0 on success, 1 if the file is not a binary table with this magic
+ * (a text table for instance), -1 on error.
+ **/
+int table_map(char *path, char *magic, int record_size, table_t *table);
+
+/**
+ * \brief Unmap a table mapped by table_map or loaded by table_load.
+ **/
+void table_unmap(table_t *table);
+
+/**
+ * \brief Write count records as a binary table in file path.
+ * \return 0 on success, -1 on error.
+ **/
+int table_write(char *path, char *magic, int record_size, void *records,
+    int count);
+
+/* tables of the filestatic models, sorted by key without duplicates: routes
+ * by node then destination, positions by node, links by source then
+ * destination. In the text form, the last line of a route or a link wins
+ * and the first position of a node wins; lines of positions and links that
+ * do not parse or whose nodes are not in [0, node_cnt) are skipped. */
+#define TABLE_ROUTES    0
+#define TABLE_POSITIONS 1
+#define TABLE_LINKS     2
+
+#define ROUTE_TABLE_MAGIC    "WSNETRT1"
+#define POSITION_TABLE_MAGIC "WSNETMB1"
+#define LINK_TABLE_MAGIC     "WSNETPG1"
+
+typedef struct _route_record {
+    nodeid_t node;
+    nodeid_t dst;
+    nodeid_t n_hop;
+} route_record_t;
+
+typedef struct _position_record {
+    nodeid_t id;
+    position_t position;
+} position_record_t;
+
+typedef struct _link_record {
+    nodeid_t src;
+    nodeid_t dst;
+    double success;
+} link_record_t;
+
+/**
+ * \brief Load the table of kind TABLE_* of file path, in binary or text form.
+ * node_cnt bounds the node ids of the text form, -1 for no bound.
+ * \return 0 on success, -1 on error.
+ **/
+int table_load(char *path, int kind, int node_cnt, table_t *table);
 #endif //__modelutils__
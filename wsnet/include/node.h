@@ -42,5 +42,12 @@ void node_kill(nodeid_t id);
 int is_node_alive(nodeid_t id);
 
 
+/** 
+ * \brief Return the topology version. The version changes whenever a node is born, dies or moves.
+ * \return The topology version.
+ **/
+uint64_t get_topology_version(void);
+
+
 
 #endif //__node_public__
@@ -49,6 +49,17 @@ packet_t *packet_create(call_t *c, int size, int real_size);
 packet_t *packet_alloc(call_t *c, int size);
 
 
+/**
+ * \brief Change the data size of a packet, keeping the data up to the
+ * smaller of the two sizes. packet->data may move, real_size is left
+ * unchanged.
+ * \param packet the packet to resize.
+ * \param size the new data size (in bytes).
+ * \return 0 on success, -1 on error (the packet is left unchanged).
+ **/
+int packet_resize(packet_t *packet, int size);
+
+
 
 
 
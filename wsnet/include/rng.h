@@ -43,6 +43,173 @@ gsl_rng *get_rng_by_id(void *rng_id);
 void *create_rng(int rng_type, unsigned long int seed);
 /* destroy */
 
+
+/**
+ * Counter based streams (Philox4x32-10). A stream is keyed by (seed, node,
+ * entity, purpose) and its n-th value only depends on that key and on n, not
+ * on the order of the other draws of the simulation. Streams are independent,
+ * cost nothing to create and are drawn without any lookup: a model keeps one
+ * per node and purpose, e.g. in its node private data.
+ **/
+typedef struct _rng_stream {
+    uint32_t key[2];             /* seed */
+    uint32_t counter[4];         /* block, node, entity, purpose */
+    uint32_t block[4];           /* current block */
+    int used;                    /* values of block already drawn */
+} rng_stream_t;
+
+/**
+ * \brief Initialize a stream with the seed of the default RNG.
+ * \param stream the stream to initialize.
+ * \param c the node and entity of the stream.
+ * \param purpose distinguishes the streams of a node and entity.
+ **/
+void rng_stream_init(rng_stream_t *stream, call_t *c, uint32_t purpose);
+
+/**
+ * \brief Initialize a stream with a given seed.
+ * \param stream the stream to initialize.
+ * \param seed the seed.
+ * \param node the node of the stream.
+ * \param entity the entity of the stream.
+ * \param purpose distinguishes the streams of a node and entity.
+ **/
+void rng_stream_init_with(rng_stream_t *stream, uint64_t seed, nodeid_t node, entityid_t entity, uint32_t purpose);
+
+/**
+ * \brief Move a stream to its index-th 32 bits value, in O(1).
+ * \param stream the stream.
+ * \param index the value to be drawn next, lower than 2^34.
+ **/
+void rng_stream_seek(rng_stream_t *stream, uint64_t index);
+
+/**
+ * \brief Return the next 32 bits value of a stream.
+ * \param stream the stream.
+ * \return A random value in [0,2^32[.
+ **/
+uint32_t rng_stream_uint32(rng_stream_t *stream);
+
+/**
+ * \brief Return a random double value in [0,1[, drawing two values.
+ * \param stream the stream.
+ * \return A random double value in [0,1[.
+ **/
+double rng_stream_double(rng_stream_t *stream);
+
+/**
+ * \brief Return a random double value in [min,max[.
+ * \param stream the stream.
+ * \param min the min value that can be drawn.
+ * \param max the max value that can be drawn.
+ * \return A random double value in [min,max[.
+ **/
+double rng_stream_double_range(rng_stream_t *stream, double min, double max);
+
+/**
+ * \brief Return a random integer value in [min,max], without bias.
+ * \param stream the stream.
+ * \param min the min value that can be drawn.
+ * \param max the max value that can be drawn.
+ * \return A random integer value in [min,max].
+ **/
+int rng_stream_integer_range(rng_stream_t *stream, int min, int max);
+
+/**
+ * \brief Return a random time in [min,max].
+ * \param stream the stream.
+ * \param min the min value that can be drawn.
+ * \param max the max value that can be drawn.
+ * \return A random time in [min,max].
+ **/
+uint64_t rng_stream_time_range(rng_stream_t *stream, uint64_t min, uint64_t max);
+
+
+/**
+ * \brief Fill an array with standard normal values (Box-Muller). Uniforms are
+ * drawn first, then transformed in a separate loop over the batch, which
+ * still calls log, sqrt, cos and sin for each pair.
+ * \param stream the stream.
+ * \param out the array to fill.
+ * \param k the number of values.
+ **/
+void rng_stream_normals(rng_stream_t *stream, double *out, int k);
+
+/**
+ * \brief Fill an array with exponential values of mean 1, e.g. Rayleigh
+ * fading powers, or terms of a Nakagami-m (gamma) power.
+ * \param stream the stream.
+ * \param out the array to fill.
+ * \param k the number of values.
+ **/
+void rng_stream_exponentials(rng_stream_t *stream, double *out, int k);
+
+
+/**
+ * Buffered samplers: a stream with RNG_SAMPLER_SIZE normal and exponential
+ * values drawn ahead in batches, for models that draw one value per
+ * reception, such as fading and shadowing propagation models.
+ **/
+#define RNG_SAMPLER_SIZE 64
+
+typedef struct _rng_sampler {
+    rng_stream_t stream;
+    int normals;                 /* values left in normal */
+    int exponentials;            /* values left in exponential */
+    double normal[RNG_SAMPLER_SIZE];
+    double exponential[RNG_SAMPLER_SIZE];
+} rng_sampler_t;
+
+/**
+ * \brief Initialize a sampler, see rng_stream_init(). Called from init(),
+ * where c->node is -1, it gives one stream shared by all the nodes.
+ * \param sampler the sampler to initialize.
+ * \param c the node and entity of the sampler stream.
+ * \param purpose distinguishes the streams of a node and entity.
+ **/
+void rng_sampler_init(rng_sampler_t *sampler, call_t *c, uint32_t purpose);
+
+/**
+ * \brief Create one sampler per node for the entity c->entity, e.g. for a
+ * propagation model to draw the values of each receiver from its own stream,
+ * whatever the order of the receptions. Free the array with free().
+ * \param c the entity of the sampler streams.
+ * \param purpose distinguishes the streams of a node and entity.
+ * \return The samplers, indexed by node id, NULL on error.
+ **/
+rng_sampler_t *rng_node_samplers_create(call_t *c, uint32_t purpose);
+
+/**
+ * \brief Return a standard normal value.
+ * \param sampler the sampler.
+ * \return A standard normal value.
+ **/
+double rng_sampler_normal(rng_sampler_t *sampler);
+
+/**
+ * \brief Return an exponential value of mean 1.
+ * \param sampler the sampler.
+ * \return An exponential value of mean 1.
+ **/
+double rng_sampler_exponential(rng_sampler_t *sampler);
+
+/**
+ * \brief Return k standard normal values at once, e.g. for all the receivers
+ * of a transmission.
+ * \param sampler the sampler.
+ * \param out the array to fill.
+ * \param k the number of values.
+ **/
+void rng_sampler_normals(rng_sampler_t *sampler, double *out, int k);
+
+/**
+ * \brief Return k exponential values of mean 1 at once.
+ * \param sampler the sampler.
+ * \param out the array to fill.
+ * \param k the number of values.
+ **/
+void rng_sampler_exponentials(rng_sampler_t *sampler, double *out, int k);
+
 /**
  * \brief Return a random distance.
  * \param rng_id ID of the RNG to use.
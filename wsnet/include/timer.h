@@ -69,6 +69,61 @@ void timer_clean(void);
 /* fetch a timer */
 qtimer_t *fetch_timer(void *timer_id);
 
+
+/**
+ * timer wheel
+ * A hierarchical timing wheel (TIMER_WHEEL_LEVELS levels of
+ * TIMER_WHEEL_SLOTS slots) for large numbers of one-shot deadlines, such
+ * as neighbor-table expiry. Deadlines are rounded up to a multiple of the
+ * wheel tick, all entries expiring in the same tick are fired from a
+ * single scheduler event, and adding or cancelling an entry is O(1).
+ * Entries are embedded in the caller's own structures and never
+ * allocated by the wheel.
+ **/
+#define TIMER_WHEEL_BITS   6
+#define TIMER_WHEEL_SLOTS  (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+
+typedef struct timer_entry_s {
+    struct timer_entry_s *next;
+    struct timer_entry_s **pprev;  /* NULL when the entry is not pending */
+    uint64_t tick;
+    int level;
+    int slot;
+    void (*callback)(call_t *c, void *data);
+    void *data;
+} timer_entry_t;
+
+typedef struct timer_wheel_s {
+    call_t c;
+    uint64_t tick;                 /* tick length */
+    uint64_t now;                  /* last tick processed */
+    uint64_t occupied[TIMER_WHEEL_LEVELS];
+    timer_entry_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    timer_entry_t *overflow;       /* beyond the last level */
+    struct _event *event;          /* pending scheduler event, if any */
+    uint64_t event_tick;
+    int running;
+} timer_wheel_t;
+
+/* create a timer wheel whose callbacks are called with c */
+timer_wheel_t *timer_wheel_create(call_t *c, uint64_t tick);
+
+/* destroy a timer wheel, pending entries are dropped but not freed */
+void timer_wheel_destroy(timer_wheel_t *wheel);
+
+/* init an entry before its first use */
+void timer_entry_init(timer_entry_t *entry, void *callback, void *data);
+
+/* (re)schedule an entry to expire at the given absolute time */
+void timer_wheel_add(timer_wheel_t *wheel, timer_entry_t *entry, uint64_t expiry);
+
+/* cancel a pending entry, no-op otherwise */
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_entry_t *entry);
+
+/* return 1 if the entry is pending */
+int timer_entry_pending(timer_entry_t *entry);
+
 #endif	/* _PERIODIC_TIMER_H */
 
 
@@ -145,7 +145,8 @@ typedef struct _packet {
     double *noise_mW;      /**< packet noise in mW**/
     double *ber;           /**< packet ber **/
 
-    char *data;            /**< packet data **/
+    char *data;            /**< packet data, inline right after the packet when it fits its slab **/
+    int slab;              /**< size class of the packet allocation, -1 if none **/
 } packet_t;
 
 
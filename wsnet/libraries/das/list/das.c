@@ -1,6 +1,6 @@
 /**
  *  \file   das.c
- *  \brief  DAta Structure : list implementation 
+ *  \brief  DAta Structure : list, vector and hash implementations
  *  \author Guillaume Chelius & Elyes Ben Hamida
  *  \date   2007
  **/
@@ -21,13 +21,37 @@ typedef struct _das_elt {
 } das_elt_t;
 
 typedef struct _das {
+    int       kind;
     int       size;
+    /* DAS_LIST */
     das_elt_t *trav;
     das_elt_t *elts;
     das_elt_t *elts_end; 
+    /* DAS_VECTOR : ring of size objects from first, oldest first.
+     * DAS_HASH   : objects in [first, end[, oldest first, NULL once deleted,
+     *              and an open addressing index of their positions. */
+    void      **array;
+    int       capacity;          /* power of 2 */
+    int       first;
+    int       end;
+    int       index;             /* traversal */
+    int       *slots;            /* position + 1, SLOT_FREE or SLOT_DELETED */
+    int       slots_size;        /* 2 * capacity */
+    int       slots_used;        /* not SLOT_FREE */
 } das_t;
 
 
+/* ************************************************** */
+/* ************************************************** */
+#define DAS_MIN_CAPACITY 8
+
+#define SLOT_FREE      0
+#define SLOT_DELETED  -1
+
+#define VECTOR_AT(das, i)  ((das)->array[((das)->first + (i)) & ((das)->capacity - 1)])
+#define HASH_KEY(data)     (*((int *) (data)))
+
+
 /* ************************************************** */
 /* ************************************************** */
 static void *mem_das = NULL;      /* memory slice for das */
@@ -50,19 +74,303 @@ int das_init(void) {
 }
 
 
+/* ************************************************** */
+/* ************************************************** */
+static int vector_grow(das_t *das) {
+    int capacity = das->capacity ? das->capacity * 2 : DAS_MIN_CAPACITY;
+    void **array;
+    int i;
+
+    if ((array = (void **) malloc(capacity * sizeof(void *))) == NULL) {
+        fprintf(stderr, "das: malloc error (vector_grow())\n");
+        return -1;
+    }
+    for (i = 0; i < das->size; i++) {
+        array[i] = VECTOR_AT(das, i);
+    }
+
+    free(das->array);
+    das->array = array;
+    das->capacity = capacity;
+    das->first = 0;
+    return 0;
+}
+
+static void vector_insert(das_t *das, void *data) {
+    if ((das->size == das->capacity) && vector_grow(das)) {
+        return;
+    }
+    VECTOR_AT(das, das->size) = data;
+    das->size++;
+}
+
+static void *vector_pop(das_t *das) {
+    if (das->size == 0) {
+        return NULL;
+    }
+    das->size--;
+    return VECTOR_AT(das, das->size);
+}
+
+static void *vector_pop_FIFO(das_t *das) {
+    void *data;
+
+    if (das->size == 0) {
+        return NULL;
+    }
+    data = VECTOR_AT(das, 0);
+    das->first = (das->first + 1) & (das->capacity - 1);
+    das->size--;
+    return data;
+}
+
+static int vector_find(das_t *das, void *data) {
+    int i;
+
+    for (i = das->size - 1; i >= 0; i--) {
+        if (VECTOR_AT(das, i) == data) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void vector_delete(das_t *das, void *data) {
+    int i = vector_find(das, data);
+
+    if (i < 0) {
+        return;
+    }
+    free(VECTOR_AT(das, i));
+    das->size--;
+    for (; i < das->size; i++) {
+        VECTOR_AT(das, i) = VECTOR_AT(das, i + 1);
+    }
+}
+
+static void vector_selective_delete(das_t *das, das_delete_func_t delete, void *arg) {
+    int i, kept = 0;
+
+    for (i = 0; i < das->size; i++) {
+        void *data = VECTOR_AT(das, i);
+        if (delete(data, arg)) {
+            free(data);
+        } else {
+            VECTOR_AT(das, kept++) = data;
+        }
+    }
+    das->size = kept;
+}
+
+static void *vector_get(das_t *das, int index) {
+    if ((index < 0) || (index >= das->size)) {
+        return NULL;
+    }
+    return VECTOR_AT(das, das->size - 1 - index);
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static inline int hash_slot(das_t *das, int key) {
+    return (int) (((unsigned int) key * 2654435761u) & (das->slots_size - 1));
+}
+
+static void hash_index(das_t *das, int position) {
+    int slot = hash_slot(das, HASH_KEY(das->array[position]));
+
+    while (das->slots[slot] > SLOT_FREE) {
+        slot = (slot + 1) & (das->slots_size - 1);
+    }
+    if (das->slots[slot] == SLOT_FREE) {
+        das->slots_used++;
+    }
+    das->slots[slot] = position + 1;
+}
+
+/* slot of the position of an object with the key of data, -1 if none */
+static int hash_lookup(das_t *das, void *data) {
+    int key = HASH_KEY(data);
+    int slot, position;
+
+    if (das->size == 0) {
+        return -1;
+    }
+
+    slot = hash_slot(das, key);
+    while ((position = das->slots[slot]) != SLOT_FREE) {
+        if ((position != SLOT_DELETED) && (HASH_KEY(das->array[position - 1]) == key)) {
+            return slot;
+        }
+        slot = (slot + 1) & (das->slots_size - 1);
+    }
+    return -1;
+}
+
+/* positions move, the index is rebuilt, which also drops deleted slots */
+static int hash_compact(das_t *das) {
+    int capacity = das->capacity;
+    int slots_size = das->slots_size;
+    void **array = das->array;
+    int *slots = das->slots;
+    int i, n = 0;
+
+    if ((das->size * 2 >= das->capacity) || (das->capacity == 0)) {
+        capacity = das->capacity ? das->capacity * 2 : DAS_MIN_CAPACITY;
+        slots_size = capacity * 2;
+        if ((array = (void **) malloc(capacity * sizeof(void *))) == NULL) {
+            fprintf(stderr, "das: malloc error (hash_compact())\n");
+            return -1;
+        }
+        if ((slots = (int *) malloc(slots_size * sizeof(int))) == NULL) {
+            fprintf(stderr, "das: malloc error (hash_compact())\n");
+            free(array);
+            return -1;
+        }
+    }
+
+    for (i = das->first; i < das->end; i++) {
+        if (das->array[i] != NULL) {
+            array[n++] = das->array[i];
+        }
+    }
+
+    if (array != das->array) {
+        free(das->array);
+        free(das->slots);
+    }
+    das->array = array;
+    das->slots = slots;
+    das->capacity = capacity;
+    das->slots_size = slots_size;
+    das->first = 0;
+    das->end = n;
+
+    memset(das->slots, 0, das->slots_size * sizeof(int));
+    das->slots_used = 0;
+    for (i = 0; i < n; i++) {
+        hash_index(das, i);
+    }
+    return 0;
+}
+
+/* used and deleted slots never fill more than half of the index */
+static void hash_insert(das_t *das, void *data) {
+    if (((das->end == das->capacity) || (das->slots_used == das->capacity))
+        && hash_compact(das)) {
+        return;
+    }
+    das->array[das->end] = data;
+    hash_index(das, das->end);
+    das->end++;
+    das->size++;
+}
+
+static void *hash_remove(das_t *das, int slot) {
+    int position = das->slots[slot] - 1;
+    void *data = das->array[position];
+
+    das->slots[slot] = SLOT_DELETED;
+    das->array[position] = NULL;
+    das->size--;
+
+    while ((das->first < das->end) && (das->array[das->first] == NULL)) {
+        das->first++;
+    }
+    while ((das->end > das->first) && (das->array[das->end - 1] == NULL)) {
+        das->end--;
+    }
+    return data;
+}
+
+/* slot of the object stored at position */
+static int hash_position_slot(das_t *das, int position) {
+    int slot = hash_slot(das, HASH_KEY(das->array[position]));
+
+    while (das->slots[slot] != position + 1) {
+        slot = (slot + 1) & (das->slots_size - 1);
+    }
+    return slot;
+}
+
+static void *hash_pop(das_t *das) {
+    if (das->size == 0) {
+        return NULL;
+    }
+    return hash_remove(das, hash_position_slot(das, das->end - 1));
+}
+
+static void *hash_pop_FIFO(das_t *das) {
+    if (das->size == 0) {
+        return NULL;
+    }
+    return hash_remove(das, hash_position_slot(das, das->first));
+}
+
+static void hash_delete(das_t *das, void *data) {
+    int slot = hash_lookup(das, data);
+
+    if (slot >= 0) {
+        free(hash_remove(das, slot));
+    }
+}
+
+static void hash_selective_delete(das_t *das, das_delete_func_t delete, void *arg) {
+    int i;
+
+    for (i = das->end - 1; i >= das->first; i--) {
+        if ((das->array[i] != NULL) && delete(das->array[i], arg)) {
+            free(hash_remove(das, hash_position_slot(das, i)));
+        }
+    }
+}
+
+static void *hash_traverse(das_t *das) {
+    int i = (das->index < 0) ? das->end - 1 : das->index - 1;
+
+    while ((i >= das->first) && (das->array[i] == NULL)) {
+        i--;
+    }
+    if (i < das->first) {
+        das->index = das->first;
+        return NULL;
+    }
+    das->index = i;
+    return das->array[i];
+}
+
+
 /* ************************************************** */
 /* ************************************************** */
 void *das_create(void) {
+    return das_create_with(DAS_LIST);
+}
+
+void *das_create_with(int kind) {
     das_t *das;
     
+    if ((kind != DAS_LIST) && (kind != DAS_VECTOR) && (kind != DAS_HASH)) {
+        fprintf(stderr, "das: unknown kind %d (das_create_with())\n", kind);
+        return NULL;
+    }
+
     if ((das = (das_t *) mem_fs_alloc(mem_das)) == NULL) {
         return NULL;
     }
     
+    das->kind     = kind;
     das->size     = 0;
     das->elts     = NULL;
     das->trav     = NULL;
     das->elts_end = NULL;
+    das->array    = NULL;
+    das->capacity = 0;
+    das->first    = 0;
+    das->end      = 0;
+    das->index    = -1;
+    das->slots    = NULL;
+    das->slots_size = 0;
+    das->slots_used = 0;
     
     return (void *) das;
 }
@@ -75,6 +383,9 @@ void das_destroy(void *d) {
         return;
     }
 
+    free(das->array);
+    free(das->slots);
+
     while ((elt = das->elts) != NULL) {
         das->elts = elt->next;
         mem_fs_dealloc(mem_das_elts, elt);       
@@ -99,6 +410,14 @@ void das_insert(void *d, void *data){
     das_t *das = (das_t *) d;
     das_elt_t *elt;
     
+    if (das->kind == DAS_VECTOR) {
+        vector_insert(das, data);
+        return;
+    } else if (das->kind == DAS_HASH) {
+        hash_insert(das, data);
+        return;
+    }
+
     if ((elt = (das_elt_t *) mem_fs_alloc(mem_das_elts)) == NULL) {
         return;
     }    
@@ -123,6 +442,12 @@ void *das_pop(void *d) {
     das_elt_t *elt;
     void *data;
     
+    if (das->kind == DAS_VECTOR) {
+        return vector_pop(das);
+    } else if (das->kind == DAS_HASH) {
+        return hash_pop(das);
+    }
+
     if ((elt = das->elts) == NULL) {
         return NULL;
     }
@@ -146,6 +471,12 @@ void *das_pop_FIFO(void *d) {
     das_elt_t *elt;
     void *data;
     
+    if (das->kind == DAS_VECTOR) {
+        return vector_pop_FIFO(das);
+    } else if (das->kind == DAS_HASH) {
+        return hash_pop_FIFO(das);
+    }
+
     if ((elt = das->elts_end) == NULL) {
         return NULL;
     } else if (das->elts_end == das->elts) {
@@ -172,6 +503,12 @@ int das_find(void *d, void *data) {
     das_t *das = (das_t *) d;
     das_elt_t *elt = das->elts;
     
+    if (das->kind == DAS_VECTOR) {
+        return vector_find(das, data) >= 0;
+    } else if (das->kind == DAS_HASH) {
+        return hash_lookup(das, data) >= 0;
+    }
+
     while (elt != NULL) {
         if (elt->data == data) {
             return 1;
@@ -186,6 +523,14 @@ void das_delete(void *d, void *data) {
     das_t *das = (das_t *) d;
     das_elt_t *elt = das->elts, *o_elt = NULL;
     
+    if (das->kind == DAS_VECTOR) {
+        vector_delete(das, data);
+        return;
+    } else if (das->kind == DAS_HASH) {
+        hash_delete(das, data);
+        return;
+    }
+
     while (elt != NULL) {
         
         if (elt->data == data) {
@@ -223,6 +568,14 @@ void das_selective_delete(void *d, das_delete_func_t delete, void *arg) {
     das_t *das = (das_t *) d;
     das_elt_t *elt = das->elts, *o_elt = NULL, *c_elt;
     
+    if (das->kind == DAS_VECTOR) {
+        vector_selective_delete(das, delete, arg);
+        return;
+    } else if (das->kind == DAS_HASH) {
+        hash_selective_delete(das, delete, arg);
+        return;
+    }
+
     while (elt != NULL) {    
         if (delete(elt->data, arg)) {
             c_elt = elt;
@@ -264,12 +617,20 @@ void das_selective_delete(void *d, das_delete_func_t delete, void *arg) {
 void das_init_traverse(void *d) {
     das_t *das = (das_t *) d;
     
+    das->index = -1;
     das->trav = NULL;
 }
 
 void *das_traverse(void *d) {
     das_t *das = (das_t *) d;
 
+    if (das->kind == DAS_VECTOR) {
+        das->index++;
+        return vector_get(das, das->index);
+    } else if (das->kind == DAS_HASH) {
+        return hash_traverse(das);
+    }
+
     if (das->trav == NULL) {
         das->trav = das->elts;
     } else {
@@ -282,3 +643,19 @@ void *das_traverse(void *d) {
         return NULL;
     }
 }
+
+void *das_get(void *d, int index) {
+    das_t *das = (das_t *) d;
+    void *data;
+
+    if (das->kind == DAS_VECTOR) {
+        return vector_get(das, index);
+    }
+
+    if ((index < 0) || (index >= das->size)) {
+        return NULL;
+    }
+    das_init_traverse(das);
+    while (((data = das_traverse(das)) != NULL) && index--) ;
+    return data;
+}
@@ -1,6 +1,6 @@
 /**
  *  \file   hadas.c
- *  \brief  Hashed DAta Structure
+ *  \brief  Hashed DAta Structure : open addressing (Robin Hood) implementation
  *  \author Guillaume Chelius & Elyes Ben Hamida
  *  \date   2007
  **/
@@ -14,30 +14,35 @@
 
 /* ************************************************** */
 /* ************************************************** */
-#define HASH_SIZE 32
+#define HASH_MIN_SIZE 16         /* power of 2 */
 
 
 /* ************************************************** */
 /* ************************************************** */
+/* Robin Hood linear probing: a cluster is sorted by bucket, so an element is
+ * never further from its bucket than the element before it, and lookups stop
+ * as soon as they are further than the element they look at. Deletions shift
+ * the next elements back instead of leaving tombstones. */
 typedef struct _hadas_elt {
     void *key;
     void *data;
-    struct _hadas_elt *next;
-    struct _hadas_elt *previous;
+    unsigned long long hash;     /* mixed */
+    int distance;                /* 1 + distance to its bucket, 0 if empty */
 } hadas_elt_t;
 
-typedef struct _sodas {
+typedef struct _hadas {
     int size;
+    int mask;                    /* number of buckets - 1 */
+    int shift;                   /* 64 - log2(number of buckets) */
     hash_hash_t hash;
     hash_equal_t equal;
-    hadas_elt_t *elts[HASH_SIZE];
+    hadas_elt_t *elts;
 } hadas_t;
 
 
 /* ************************************************** */
 /* ************************************************** */
 static void *mem_hadas = NULL;      /* memory slice for hadas */
-static void *mem_hadas_elts = NULL; /* memory slice for hadas elements */
 
 
 /* ************************************************** */
@@ -47,19 +52,95 @@ int hadas_init(void) {
         return -1;
     }
 
-    if ((mem_hadas_elts = mem_fs_slice_declare(sizeof(hadas_elt_t))) == NULL) {
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* keys are often ids or consecutive addresses: Fibonacci hashing spreads
+ * them evenly over the buckets, which are given by the high bits */
+static inline unsigned long long hadas_hash(hadas_t *hadas, void *key) {
+    return (unsigned long long) hadas->hash(key) * 0x9E3779B97F4A7C15ULL;
+}
+
+#define HADAS_BUCKET(hadas, hash) ((int) ((hash) >> (hadas)->shift))
+
+/* a newest element is put before the elements with the same key, so that the
+ * last inserted one is found first; the elements it passes before are shifted
+ * by one, which keeps the order of the cluster */
+static void hadas_place(hadas_t *hadas, hadas_elt_t elt, int newest) {
+    int i = HADAS_BUCKET(hadas, elt.hash);
+    hadas_elt_t tmp;
+
+    for (elt.distance = 1; hadas->elts[i].distance; elt.distance++) {
+        if ((hadas->elts[i].distance < elt.distance)
+            || (newest && (hadas->elts[i].distance == elt.distance)
+                && (hadas->elts[i].hash == elt.hash)
+                && hadas->equal(hadas->elts[i].key, elt.key))) {
+            break;
+        }
+        i = (i + 1) & hadas->mask;
+    }
+
+    while (hadas->elts[i].distance) {
+        tmp = hadas->elts[i];
+        hadas->elts[i] = elt;
+        elt = tmp;
+        elt.distance++;
+        i = (i + 1) & hadas->mask;
+    }
+    hadas->elts[i] = elt;
+}
+
+static int hadas_resize(hadas_t *hadas, int buckets) {
+    hadas_elt_t *elts = hadas->elts;
+    int i, start, old_buckets = hadas->mask + 1;
+
+    if ((hadas->elts = (hadas_elt_t *) calloc(buckets, sizeof(hadas_elt_t))) == NULL) {
+        fprintf(stderr, "hadas: malloc error (hadas_resize())\n");
+        hadas->elts = elts;
         return -1;
     }
+    hadas->mask = buckets - 1;
+    for (hadas->shift = 64; buckets > 1; buckets >>= 1) {
+        hadas->shift--;
+    }
 
+    /* from an empty bucket, elements with the same key come newest first */
+    for (start = 0; (start < old_buckets) && elts[start].distance; start++) ;
+    for (i = 1; i <= old_buckets; i++) {
+        hadas_elt_t *elt = &elts[(start + i) & (old_buckets - 1)];
+        if (elt->distance) {
+            hadas_place(hadas, *elt, 0);
+        }
+    }
+
+    free(elts);
     return 0;
 }
 
+/* index of the element of key, -1 if none */
+static int hadas_find(hadas_t *hadas, void *key) {
+    unsigned long long hash = hadas_hash(hadas, key);
+    int i = HADAS_BUCKET(hadas, hash);
+    int distance;
+
+    for (distance = 1; hadas->elts[i].distance >= distance; distance++) {
+        if ((hadas->elts[i].hash == hash) && hadas->equal(key, hadas->elts[i].key)) {
+            return i;
+        }
+        i = (i + 1) & hadas->mask;
+    }
+
+    return -1;
+}
+
 
 /* ************************************************** */
 /* ************************************************** */
 void *hadas_create(hash_hash_t hash, hash_equal_t equal) {
     hadas_t *hadas;
-    int i;
     
     if ((hadas = (hadas_t *) mem_fs_alloc(mem_hadas)) == NULL) {
         return NULL;
@@ -68,9 +149,12 @@ void *hadas_create(hash_hash_t hash, hash_equal_t equal) {
     hadas->size = 0;
     hadas->equal = equal;
     hadas->hash = hash;
+    hadas->mask = -1;
+    hadas->elts = NULL;
 
-    for(i=0;i<HASH_SIZE;i++){
-      hadas->elts[i] = NULL;
+    if (hadas_resize(hadas, HASH_MIN_SIZE)) {
+        mem_fs_dealloc(mem_hadas, hadas);
+        return NULL;
     }
     
     return (void *) hadas;
@@ -78,17 +162,10 @@ void *hadas_create(hash_hash_t hash, hash_equal_t equal) {
 
 void hadas_destroy(void *s) {
     hadas_t *hadas = (hadas_t *) s;
-    hadas_elt_t *elt;
-    int i;
 
     if (hadas != NULL) {
-      for (i = 0; i < HASH_SIZE; i++) {
-        while ((elt = hadas->elts[i]) != NULL) {
-	  hadas->elts[i] = elt->next;
-	  mem_fs_dealloc(mem_hadas_elts, elt);       
-        }
-      }
-      mem_fs_dealloc(mem_hadas, hadas);
+        free(hadas->elts);
+        mem_fs_dealloc(mem_hadas, hadas);
     }
 }
 
@@ -97,74 +174,46 @@ void hadas_destroy(void *s) {
 /* ************************************************** */
 void hadas_insert(void *s, void *key, void *data){
     hadas_t *hadas = (hadas_t *) s;
-    hadas_elt_t *elt;
-    unsigned long hash = hadas->hash(key) % HASH_SIZE;
-    
+    hadas_elt_t elt;
     
-    if ((elt = (hadas_elt_t *) mem_fs_alloc(mem_hadas_elts)) == NULL) {
+    /* at most 7/8 full */
+    if (((hadas->size + 1) * 8 > (hadas->mask + 1) * 7)
+        && hadas_resize(hadas, (hadas->mask + 1) * 2)) {
         return;
     }
-    
-    elt->key = key;
-    elt->data = data;
-    elt->next = NULL;
-    elt->previous = NULL;
-
-    if (hadas->elts[hash] == NULL) {
-        hadas->elts[hash] = elt;
-    } else {
-        elt->next = hadas->elts[hash];
-        hadas->elts[hash]->previous = elt;
-        hadas->elts[hash] = elt;
-    }
+
+    elt.key = key;
+    elt.data = data;
+    elt.hash = hadas_hash(hadas, key);
+    hadas_place(hadas, elt, 1);
 
     hadas->size++;
 }
 
 void *hadas_get(void *h, void *key) {
     hadas_t *hadas = (hadas_t *) h;
-    unsigned long hash = hadas->hash(key) % HASH_SIZE;
-    hadas_elt_t *elt = hadas->elts[hash];
+    int i = hadas_find(hadas, key);
     
-    while (elt != NULL) {
-        if (hadas->equal(key, elt->key)) {
-            return elt->data;
-        }
-        elt = elt->next;
-    }
-    
-    return NULL;
+    return (i < 0) ? NULL : hadas->elts[i].data;
 }
 
 void hadas_delete(void *h, void *key) {
     hadas_t *hadas = (hadas_t *) h;
-    unsigned long hash = hadas->hash(key) % HASH_SIZE;
-    hadas_elt_t *elt = hadas->elts[hash], *o_elt = NULL;
+    int i = hadas_find(hadas, key), next;
     
-    while (elt != NULL) {
-        if (hadas->equal(elt->key, key)) {
-            /* delete from the begining*/
-            if (o_elt == NULL) {
-                hadas->elts[hash] = elt->next;
-                if (hadas->elts[hash] != NULL) {
-                    hadas->elts[hash]->previous = NULL;
-                }
-            } else {
-                o_elt->next = elt->next;
-                if (elt->next != NULL){ 
-                    elt->next->previous = o_elt;
-                }
-            }
-            
-            hadas->size--;
-            mem_fs_dealloc(mem_hadas_elts, elt);
-            return;
-        }
-        o_elt = elt;
-        elt = elt->next;
+    if (i < 0) {
+        return;
     }
-    
-    return;
-}
 
+    /* shift back the elements that are not in their bucket */
+    next = (i + 1) & hadas->mask;
+    while (hadas->elts[next].distance > 1) {
+        hadas->elts[i] = hadas->elts[next];
+        hadas->elts[i].distance--;
+        i = next;
+        next = (next + 1) & hadas->mask;
+    }
+    hadas->elts[i].distance = 0;
 
+    hadas->size--;
+}
@@ -0,0 +1,170 @@
+/**
+ *  \file   hadas_bench.c
+ *  \brief  Hashed DAta Structure microbenchmark
+ *  \date   2026
+ **/
+/* Compares hadas with the 32 bucket chained table it replaced, on keys such
+ * as the ones of the timer library (consecutive addresses), and checks that
+ * both return the same objects. Standalone; from the wsnet directory:
+ *
+ *   gcc -O2 -I . libraries/hadas/hash/hadas_bench.c
+ *       libraries/hadas/hash/hadas.c libraries/mem_fs/malloc/mem_fs.c
+ *       -o hadas_bench && ./hadas_bench
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <include/mem_fs.h>
+#include <include/hadas.h>
+
+
+/* ************************************************** */
+/* ************************************************** */
+#define BENCH_OPS     1000000
+#define CHAIN_SIZE    32
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* the former implementation, minus mem_fs */
+typedef struct _chain_elt {
+    void *key;
+    void *data;
+    struct _chain_elt *next;
+} chain_elt_t;
+
+static chain_elt_t *chains[CHAIN_SIZE];
+
+static void chain_insert(void *key, void *data) {
+    chain_elt_t *elt = (chain_elt_t *) malloc(sizeof(chain_elt_t));
+    unsigned long hash = (unsigned long) key % CHAIN_SIZE;
+
+    elt->key = key;
+    elt->data = data;
+    elt->next = chains[hash];
+    chains[hash] = elt;
+}
+
+static void *chain_get(void *key) {
+    chain_elt_t *elt = chains[(unsigned long) key % CHAIN_SIZE];
+
+    while (elt != NULL) {
+        if (elt->key == key) {
+            return elt->data;
+        }
+        elt = elt->next;
+    }
+    return NULL;
+}
+
+static void chain_delete(void *key) {
+    chain_elt_t **elt = &chains[(unsigned long) key % CHAIN_SIZE], *d;
+
+    while (*elt != NULL) {
+        if ((*elt)->key == key) {
+            d = *elt;
+            *elt = d->next;
+            free(d);
+            return;
+        }
+        elt = &(*elt)->next;
+    }
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static unsigned long key_hash(void *key) {
+    return (unsigned long) key;
+}
+
+static int key_equal(void *key0, void *key1) {
+    return (int) (key0 == key1);
+}
+
+static unsigned int seed;
+
+static unsigned int bench_rand(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* the live keys [oldest, oldest + live[ are in the tables; each op
+ * gets a random live key, then replaces the oldest key by a new one, as
+ * timers are created and deleted */
+int main(void) {
+    int lives[] = {16, 256, 4096, 65536};
+    int l, i, mismatches;
+    double t, chain_ns, hadas_ns;
+    char *base = (char *) 0x1000;
+
+    hadas_init();
+
+    printf("keys\tchained (ns/op)\thadas (ns/op)\tspeedup\tmismatches\n");
+    for (l = 0; l < (int) (sizeof(lives) / sizeof(lives[0])); l++) {
+        int live = lives[l];
+        void *hadas = hadas_create(key_hash, key_equal);
+        long oldest = 0, next = 0;
+        long sum = 0;
+
+        seed = 1;
+        for (; next < live; next++) {
+            chain_insert(base + next, base + next + 1);
+            hadas_insert(hadas, base + next, base + next + 1);
+        }
+
+        t = now();
+        for (i = 0; i < BENCH_OPS; i++) {
+            long key = oldest + bench_rand() % live;
+            sum += (long) chain_get(base + key);
+            chain_delete(base + oldest);
+            chain_insert(base + next, base + next + 1);
+            oldest++; next++;
+        }
+        chain_ns = (now() - t) / BENCH_OPS;
+
+        seed = 1;
+        oldest -= BENCH_OPS;
+        next -= BENCH_OPS;
+        t = now();
+        for (i = 0; i < BENCH_OPS; i++) {
+            long key = oldest + bench_rand() % live;
+            sum -= (long) hadas_get(hadas, base + key);
+            hadas_delete(hadas, base + oldest);
+            hadas_insert(hadas, base + next, base + next + 1);
+            oldest++; next++;
+        }
+        hadas_ns = (now() - t) / BENCH_OPS;
+
+        mismatches = (sum != 0);
+        for (i = 0; i < live + 16; i++) {
+            void *key = base + oldest - 8 + i;
+            if (chain_get(key) != hadas_get(hadas, key)) {
+                mismatches++;
+            }
+        }
+
+        printf("%d\t%.1f\t\t%.1f\t\t%.1fx\t%d\n", live, chain_ns, hadas_ns,
+               chain_ns / hadas_ns, mismatches);
+
+        for (; oldest < next; oldest++) {
+            chain_delete(base + oldest);
+        }
+        hadas_destroy(hadas);
+    }
+
+    mem_fs_clean();
+    return 0;
+}
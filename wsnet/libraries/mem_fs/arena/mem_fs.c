@@ -0,0 +1,283 @@
+/**
+ *  \file   mem_fs.c
+ *  \brief  Fixed size memory management with growable arenas
+ *  \date   2026
+ *
+ * Each slice owns a list of chunks that grows geometrically: a new chunk
+ * holds as many containers as all the previous ones together (at least
+ * ARENA_INITIAL_NUMBER, at most ARENA_MAX_CHUNK bytes). Chunks are carved
+ * lazily with a bump pointer, so growing a slice touches no memory, and
+ * deallocated containers go to a per-slice free list that is served first.
+ *
+ * mem_fs_reset() empties every slice in O(number of chunks) and keeps the
+ * chunks for later allocations. Build with -DMEM_FS_HUGEPAGES to map
+ * chunks on transparent huge pages (Linux), and with -DMEM_FS_STATS to
+ * print the slices usage when the module is cleaned.
+ **/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef MEM_FS_HUGEPAGES
+#include <sys/mman.h>
+#endif
+
+#include <include/mem_fs.h>
+
+
+/* ************************************************** */
+/* ************************************************** */
+#define ARENA_INITIAL_NUMBER 1024
+#define ARENA_MAX_CHUNK      (64 << 20)
+#define ARENA_ALIGN          8
+#define ARENA_HUGEPAGE       (2 << 20)
+
+
+/* ************************************************** */
+/* ************************************************** */
+typedef union _container {
+    char             *data; /* pointer to the data */
+    union _container *next; /* pointer to the next free container */
+} container_t;
+
+typedef struct _chunk {
+    char          *memory; /* chunk memory */
+    size_t         bytes;  /* chunk size */
+    int            mapped; /* memory comes from mmap */
+    struct _chunk *next;   /* next chunk of the slice */
+} chunk_t;
+
+typedef struct _slice {
+    int            size;       /* size of a container */
+    long           live;       /* allocated containers */
+    long           high_water; /* maximum of live */
+    long           capacity;   /* containers in all chunks */
+    container_t   *f_free;     /* first free container */
+    chunk_t       *chunks;     /* first chunk */
+    chunk_t       *current;    /* chunk being carved */
+    chunk_t       *last;       /* last chunk */
+    char          *bump;       /* next uncarved container of current */
+    char          *end;        /* end of current */
+    struct _slice *next;       /* next slice */
+} slice_t;
+
+
+/* ************************************************** */
+/* ************************************************** */
+slice_t *slices = NULL;
+
+
+/* ************************************************** */
+/* ************************************************** */
+static void arena_chunk_free(chunk_t *chunk) {
+#ifdef MEM_FS_HUGEPAGES
+    if (chunk->mapped) {
+        munmap(chunk->memory, chunk->bytes);
+    } else
+#endif
+    free(chunk->memory);
+    free(chunk);
+}
+
+void mem_fs_clean(void) {
+#ifdef MEM_FS_STATS
+    mem_fs_dump_stats(stderr);
+#endif
+
+    /* free all declared slices and their chunks */
+    while (slices) {
+        slice_t *slice = slices;
+        slices = slice->next;
+        while (slice->chunks) {
+            chunk_t *chunk = slice->chunks;
+            slice->chunks = chunk->next;
+            arena_chunk_free(chunk);
+        }
+        free(slice);
+    }
+    
+    return;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+void *mem_fs_slice_declare(int size) {
+    slice_t *slice = slices;
+    int n_size = (size > (int) sizeof(container_t)) ? size : (int) sizeof(container_t);
+
+    /* protect against too small containers*/
+    if (size <= 0) {
+        fprintf(stderr, "mem_fs: size too small (%d) in slice declaration (mem_fs_slice_declare())\n", size);
+        return NULL;
+    }
+    n_size = (n_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    
+    /* search for an already declared slice */
+    while (slice) {
+        if (slice->size == n_size) {
+            return slice;
+        }
+        slice = slice->next;
+    }
+    
+    /* allocate new slice, its first chunk comes with the first allocation */
+    if ((slice = (slice_t *) calloc(1, sizeof(slice_t))) == NULL) {
+        fprintf(stderr, "mem_fs: malloc error in slice declaration (mem_fs_slice_declare())\n");
+        return NULL;
+    }
+    slice->size = n_size;
+
+    /* update slices */
+    slice->next = slices;
+    slices = slice;
+
+    return (void *) slice;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static chunk_t *arena_chunk_alloc(slice_t *slice) {
+    chunk_t *chunk;
+    long number = (slice->capacity > ARENA_INITIAL_NUMBER) ? slice->capacity : ARENA_INITIAL_NUMBER;
+    size_t bytes = (size_t) number * slice->size;
+
+    if (bytes > ARENA_MAX_CHUNK) {
+        bytes = ARENA_MAX_CHUNK - ARENA_MAX_CHUNK % slice->size;
+        if (bytes == 0) {
+            bytes = slice->size;
+        }
+    }
+
+    if ((chunk = (chunk_t *) malloc(sizeof(chunk_t))) == NULL) {
+        return NULL;
+    }
+    chunk->mapped = 0;
+    chunk->next = NULL;
+
+#ifdef MEM_FS_HUGEPAGES
+    /* whole huge pages only, the rounding is more containers */
+    if (bytes >= ARENA_HUGEPAGE) {
+        size_t mapped = (bytes + ARENA_HUGEPAGE - 1) & ~((size_t) ARENA_HUGEPAGE - 1);
+        void *memory = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+            madvise(memory, mapped, MADV_HUGEPAGE);
+#endif
+            chunk->memory = (char *) memory;
+            chunk->bytes = mapped;
+            chunk->mapped = 1;
+            return chunk;
+        }
+    }
+#endif
+
+    if ((chunk->memory = (char *) malloc(bytes)) == NULL) {
+        free(chunk);
+        return NULL;
+    }
+    chunk->bytes = bytes;
+    return chunk;
+}
+
+static void arena_carve(slice_t *slice, chunk_t *chunk) {
+    slice->current = chunk;
+    slice->bump = chunk->memory;
+    slice->end = chunk->memory + (chunk->bytes / slice->size) * slice->size;
+}
+
+static int arena_grow(slice_t *slice) {
+    chunk_t *chunk;
+
+    /* after a reset, reuse the chunks that follow */
+    if (slice->current != NULL && slice->current->next != NULL) {
+        arena_carve(slice, slice->current->next);
+        return 0;
+    }
+
+    if ((chunk = arena_chunk_alloc(slice)) == NULL) {
+        fprintf(stderr, "mem_fs: malloc error in chunk allocation (arena_grow())\n");
+        return -1;
+    }
+    if (slice->last == NULL) {
+        slice->chunks = chunk;
+    } else {
+        slice->last->next = chunk;
+    }
+    slice->last = chunk;
+    slice->capacity += chunk->bytes / slice->size;
+    arena_carve(slice, chunk);
+
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+void *mem_fs_alloc(void *arg0) {
+    slice_t *slice = (slice_t *) arg0;
+    void *container;
+
+    if (slice->f_free != NULL) {
+        /* recycled container first */
+        container = slice->f_free;
+        slice->f_free = slice->f_free->next;
+    } else {
+        if (slice->bump == slice->end && arena_grow(slice)) {
+            return NULL;
+        }
+        container = slice->bump;
+        slice->bump += slice->size;
+    }
+
+    if (++slice->live > slice->high_water) {
+        slice->high_water = slice->live;
+    }
+    return container;
+}
+
+void mem_fs_dealloc(void *arg0, void *arg1) {
+    slice_t *slice = (slice_t *) arg0;
+    container_t *container = (container_t *) arg1;
+
+    /* update the chained containers */
+    container->next = slice->f_free;
+    slice->f_free = container;
+    slice->live--;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int mem_fs_reset(void) {
+    slice_t *slice;
+
+    for (slice = slices; slice; slice = slice->next) {
+        slice->f_free = NULL;
+        slice->live = 0;
+        slice->high_water = 0;
+        if (slice->chunks != NULL) {
+            arena_carve(slice, slice->chunks);
+        }
+    }
+
+    return 0;
+}
+
+void mem_fs_slice_stats(void *arg0, mem_fs_stats_t *stats) {
+    slice_t *slice = (slice_t *) arg0;
+
+    stats->size = slice->size;
+    stats->live = slice->live;
+    stats->high_water = slice->high_water;
+    stats->capacity = slice->capacity;
+}
+
+void mem_fs_dump_stats(FILE *stream) {
+    slice_t *slice;
+
+    for (slice = slices; slice; slice = slice->next) {
+        fprintf(stream, "mem_fs: slice %d bytes, live %ld, high water %ld, capacity %ld\n",
+                slice->size, slice->live, slice->high_water, slice->capacity);
+    }
+}
@@ -13,8 +13,10 @@
 /* ************************************************** */
 /* ************************************************** */
 typedef struct _slice {
-    int            size; /* size of a container */
-    struct _slice *next; /* next declared slice */
+    int            size;       /* size of a container */
+    long           live;       /* allocated containers */
+    long           high_water; /* maximum of live */
+    struct _slice *next;       /* next declared slice */
 } slice_t;
 
 slice_t *slices = NULL;
@@ -59,6 +61,7 @@ void *mem_fs_slice_declare(int size) {
         return NULL;
     }
     slice->size = size;
+    slice->live = slice->high_water = 0;
     
     /* update slices */
     slice->next = slices;
@@ -70,10 +73,43 @@ void *mem_fs_slice_declare(int size) {
 
 /* ************************************************** */
 /* ************************************************** */
-void *mem_fs_alloc(void *slice) {
-    return malloc(((slice_t *) slice)->size);
+void *mem_fs_alloc(void *arg0) {
+    slice_t *slice = (slice_t *) arg0;
+    void *pointer = malloc(slice->size);
+
+    if (pointer != NULL && ++slice->live > slice->high_water) {
+        slice->high_water = slice->live;
+    }
+    return pointer;
 }
 
-void mem_fs_dealloc(void *slice, void *pointer) {
+void mem_fs_dealloc(void *arg0, void *pointer) {
+    ((slice_t *) arg0)->live--;
     free(pointer);
 }
+
+
+/* ************************************************** */
+/* ************************************************** */
+int mem_fs_reset(void) {
+    /* blocks are not tracked, they cannot be reclaimed in bulk */
+    return -1;
+}
+
+void mem_fs_slice_stats(void *arg0, mem_fs_stats_t *stats) {
+    slice_t *slice = (slice_t *) arg0;
+
+    stats->size = slice->size;
+    stats->live = slice->live;
+    stats->high_water = slice->high_water;
+    stats->capacity = slice->live;
+}
+
+void mem_fs_dump_stats(FILE *stream) {
+    slice_t *slice;
+
+    for (slice = slices; slice; slice = slice->next) {
+        fprintf(stream, "mem_fs: slice %d bytes, live %ld, high water %ld\n",
+                slice->size, slice->live, slice->high_water);
+    }
+}
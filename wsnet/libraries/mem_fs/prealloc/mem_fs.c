@@ -27,12 +27,15 @@ typedef struct _slice {
     int            size;   /* size of a container */
     int            length; /* slice length */
     int            free;   /* number of free containers */
+    int            high_water; /* maximum of allocated containers */
     container_t   *f_free; /* first free container */
     struct _slice *next;   /* next slice */
 } slice_t;
 
 typedef struct _page {
     char         *memory; /* memory page */
+    slice_t      *slice;  /* slice the page belongs to */
+    int           length; /* number of containers in the page */
     struct _page *next;   /* pointer to the next memory page */
 } page_t;
 
@@ -65,6 +68,22 @@ void mem_fs_clean(void) {
 }
 
 
+/* ************************************************** */
+/* ************************************************** */
+static void mem_fs_chain(slice_t *slice, char *containers, int length) {
+    container_t *container;
+    int i;
+
+    for (i = 0; i < (length - 1); i++) {
+        container = (container_t *) (containers + i * slice->size);
+        container->next = (container_t *) (containers + (i + 1) * slice->size);
+    }
+    container = (container_t *) (containers + (length - 1) * slice->size);
+    container->next = slice->f_free;
+    slice->f_free = (container_t *) containers;
+}
+
+
 /* ************************************************** */
 /* ************************************************** */
 void *mem_fs_slice_declare(int size) {
@@ -94,6 +113,7 @@ void *mem_fs_slice_declare(int size) {
         return NULL;
     }
     slice->size = n_size;
+    slice->high_water = 0;
     
     /* Containers pre-allocation */
     if ((containers = malloc(slice->size * (slice->length = slice->free = PREALLOCATION_NUMBER))) == NULL) {
@@ -123,6 +143,8 @@ void *mem_fs_slice_declare(int size) {
     
     /* update pages */
     page->memory = containers;
+    page->slice = slice;
+    page->length = slice->length;
     page->next = pages;
     pages = page;
 
@@ -169,6 +191,8 @@ int mem_fs_slice_realloc(slice_t *slice) {
     
     /* chain the page */
     page->memory = containers;
+    page->slice = slice;
+    page->length = slice->free;
     page->next = pages;
     pages = page;
 
@@ -193,6 +217,9 @@ void *mem_fs_alloc(void *arg0) {
     container = slice->f_free;
     slice->f_free = container->next;
     slice->free--;
+    if (slice->length - slice->free > slice->high_water) {
+        slice->high_water = slice->length - slice->free;
+    }
 
     /* return the allocated container */
     return (void *) container;
@@ -207,3 +234,40 @@ void mem_fs_dealloc(void *arg0, void *arg1) {
     slice->f_free = container;
     slice->free++;
 }
+
+
+/* ************************************************** */
+/* ************************************************** */
+int mem_fs_reset(void) {
+    slice_t *slice;
+    page_t *page;
+
+    for (slice = slices; slice; slice = slice->next) {
+        slice->f_free = NULL;
+        slice->free = slice->length;
+        slice->high_water = 0;
+    }
+    for (page = pages; page; page = page->next) {
+        mem_fs_chain(page->slice, page->memory, page->length);
+    }
+
+    return 0;
+}
+
+void mem_fs_slice_stats(void *arg0, mem_fs_stats_t *stats) {
+    slice_t *slice = (slice_t *) arg0;
+
+    stats->size = slice->size;
+    stats->live = slice->length - slice->free;
+    stats->high_water = slice->high_water;
+    stats->capacity = slice->length;
+}
+
+void mem_fs_dump_stats(FILE *stream) {
+    slice_t *slice;
+
+    for (slice = slices; slice; slice = slice->next) {
+        fprintf(stream, "mem_fs: slice %d bytes, live %d, high water %d, capacity %d\n",
+                slice->size, slice->length - slice->free, slice->high_water, slice->length);
+    }
+}
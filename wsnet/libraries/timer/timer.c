@@ -186,3 +186,275 @@ int timer_init(void) {
 void timer_clean(void) {
     hadas_destroy(timers);
 }
+
+
+/* ************************************************** */
+/* ************************************************** */
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_SPAN (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)
+
+static int timer_wheel_callback(call_t *c, void *arg);
+
+/**
+ * \brief link an entry in a slot list
+ **/
+static void timer_entry_link(timer_entry_t **head, timer_entry_t *entry) {
+    entry->next = *head;
+    if (entry->next != NULL) {
+        entry->next->pprev = &entry->next;
+    }
+    *head = entry;
+    entry->pprev = head;
+}
+
+/**
+ * \brief unlink an entry, clearing the slot occupancy if it was the last one
+ **/
+static void timer_entry_unlink(timer_wheel_t *wheel, timer_entry_t *entry) {
+    *entry->pprev = entry->next;
+    if (entry->next != NULL) {
+        entry->next->pprev = entry->pprev;
+    }
+    if ((entry->level < TIMER_WHEEL_LEVELS)
+        && (wheel->slots[entry->level][entry->slot] == NULL)) {
+        wheel->occupied[entry->level] &= ~(1ULL << entry->slot);
+    }
+    entry->next = NULL;
+    entry->pprev = NULL;
+}
+
+/**
+ * \brief place an entry relative to the last processed tick: on the level
+ * of the highest group of bits in which its tick differs.
+ **/
+static void timer_wheel_place(timer_wheel_t *wheel, timer_entry_t *entry) {
+    uint64_t diff = entry->tick ^ wheel->now;
+    int level = 0;
+
+    if (diff >> TIMER_WHEEL_SPAN) {
+        entry->level = TIMER_WHEEL_LEVELS;
+        entry->slot = 0;
+        timer_entry_link(&wheel->overflow, entry);
+        return;
+    }
+    while ((level < TIMER_WHEEL_LEVELS - 1)
+           && (diff >> (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    entry->level = level;
+    entry->slot = (entry->tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    timer_entry_link(&wheel->slots[level][entry->slot], entry);
+    wheel->occupied[level] |= 1ULL << entry->slot;
+}
+
+/**
+ * \brief first tick at which something is due (an entry expires or a slot
+ * must be cascaded).
+ * \return 0 if the wheel is empty.
+ **/
+static uint64_t timer_wheel_next(timer_wheel_t *wheel) {
+    int level;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        int shift = TIMER_WHEEL_BITS * level;
+        int index = (wheel->now >> shift) & TIMER_WHEEL_MASK;
+        uint64_t above = (index == TIMER_WHEEL_MASK) ? 0 :
+            wheel->occupied[level] & (~0ULL << (index + 1));
+
+        if (above != 0) {
+            uint64_t group = (wheel->now >> (shift + TIMER_WHEEL_BITS))
+                << (shift + TIMER_WHEEL_BITS);
+            return group | ((uint64_t) __builtin_ctzll(above) << shift);
+        }
+    }
+    if (wheel->overflow != NULL) {
+        return ((wheel->now >> TIMER_WHEEL_SPAN) + 1) << TIMER_WHEEL_SPAN;
+    }
+    return 0;
+}
+
+/**
+ * \brief make sure a scheduler event is pending for the next due tick,
+ * bringing the pending one forward if needed.
+ **/
+static void timer_wheel_reschedule(timer_wheel_t *wheel) {
+    uint64_t next;
+
+    if (wheel->running || (next = timer_wheel_next(wheel)) == 0) {
+        return;
+    }
+    if ((wheel->event != NULL) && (wheel->event_tick <= next)) {
+        return;
+    }
+    if (wheel->event != NULL) {
+        scheduler_delete_callback(&wheel->c, wheel->event);
+    }
+    wheel->event_tick = next;
+    wheel->event = scheduler_add_callback(next * wheel->tick, &wheel->c,
+                                          timer_wheel_callback, wheel);
+}
+
+/**
+ * \brief re-place every entry of a slot list relative to the current tick
+ **/
+static void timer_wheel_cascade(timer_wheel_t *wheel, timer_entry_t **head) {
+    timer_entry_t *entry = *head, *next;
+
+    *head = NULL;
+    for (; entry != NULL; entry = next) {
+        next = entry->next;
+        timer_wheel_place(wheel, entry);
+    }
+}
+
+/**
+ * \brief process tick t: cascade the slots starting at t, then fire the
+ * entries expiring at t.
+ **/
+static void timer_wheel_process(timer_wheel_t *wheel, uint64_t t) {
+    timer_entry_t *entry;
+    int level, slot;
+
+    wheel->now = t;
+    if ((t & ((1ULL << TIMER_WHEEL_SPAN) - 1)) == 0) {
+        timer_wheel_cascade(wheel, &wheel->overflow);
+    }
+    for (level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        int shift = TIMER_WHEEL_BITS * level;
+        if (t & ((1ULL << shift) - 1)) {
+            continue;
+        }
+        slot = (t >> shift) & TIMER_WHEEL_MASK;
+        wheel->occupied[level] &= ~(1ULL << slot);
+        timer_wheel_cascade(wheel, &wheel->slots[level][slot]);
+    }
+
+    /* callbacks may add or cancel any entry, so pop one at a time */
+    slot = t & TIMER_WHEEL_MASK;
+    while ((entry = wheel->slots[0][slot]) != NULL) {
+        timer_entry_unlink(wheel, entry);
+        entry->callback(&wheel->c, entry->data);
+    }
+}
+
+/**
+ * \brief scheduler callback of a wheel, fires every entry due by now.
+ **/
+static int timer_wheel_callback(call_t *c, void *arg) {
+    timer_wheel_t *wheel = (timer_wheel_t *) arg;
+    uint64_t now = get_time() / wheel->tick, next;
+
+    wheel->event = NULL;
+    wheel->running = 1;
+    while (((next = timer_wheel_next(wheel)) != 0) && (next <= now)) {
+        timer_wheel_process(wheel, next);
+    }
+    wheel->running = 0;
+    timer_wheel_reschedule(wheel);
+    return 0;
+}
+
+/**
+ * \brief create a timer wheel
+ * \param c: call information given to the entry callbacks
+ * \param tick: tick length, deadlines are rounded up to a multiple of it
+ * \return the new wheel, NULL on error
+ **/
+timer_wheel_t *timer_wheel_create(call_t *c, uint64_t tick) {
+    timer_wheel_t *wheel;
+
+    if ((tick == 0) || ((wheel = calloc(1, sizeof(timer_wheel_t))) == NULL)) {
+        return NULL;
+    }
+    memcpy(&wheel->c, c, sizeof(call_t));
+    wheel->tick = tick;
+    wheel->now = get_time() / tick;
+    return wheel;
+}
+
+/**
+ * \brief destroy a timer wheel, its pending entries are left unlinked
+ * \param wheel: the wheel to destroy
+ **/
+void timer_wheel_destroy(timer_wheel_t *wheel) {
+    timer_entry_t *entry;
+    int level, slot;
+
+    if (wheel == NULL) {
+        return;
+    }
+    if (wheel->event != NULL) {
+        scheduler_delete_callback(&wheel->c, wheel->event);
+    }
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            while ((entry = wheel->slots[level][slot]) != NULL) {
+                timer_entry_unlink(wheel, entry);
+            }
+        }
+    }
+    while ((entry = wheel->overflow) != NULL) {
+        timer_entry_unlink(wheel, entry);
+    }
+    free(wheel);
+}
+
+/**
+ * \brief init a wheel entry
+ * \param entry: the entry
+ * \param callback: function called as callback(c, data) on expiry
+ * \param data: callback parameter
+ **/
+void timer_entry_init(timer_entry_t *entry, void *callback, void *data) {
+    entry->next = NULL;
+    entry->pprev = NULL;
+    entry->callback = (void (*)(call_t *, void *)) callback;
+    entry->data = data;
+}
+
+/**
+ * \brief schedule an entry, moving it if it is already pending. It fires
+ * at the first tick boundary at or after expiry, and never in the
+ * current tick.
+ * \param wheel: the wheel
+ * \param entry: an initialized entry
+ * \param expiry: absolute expiry time
+ **/
+void timer_wheel_add(timer_wheel_t *wheel, timer_entry_t *entry, uint64_t expiry) {
+    uint64_t tick = expiry / wheel->tick + ((expiry % wheel->tick) ? 1 : 0);
+    uint64_t now = get_time() / wheel->tick, next;
+
+    if (entry->pprev != NULL) {
+        timer_entry_unlink(wheel, entry);
+    }
+    /* catch up with the clock when nothing is due by now, so that no slot
+     * of the new entry starts in the past */
+    next = timer_wheel_next(wheel);
+    if ((now > wheel->now) && ((next == 0) || (next > now))) {
+        wheel->now = now;
+    }
+    entry->tick = (tick > now) ? tick : now + 1;
+    timer_wheel_place(wheel, entry);
+    timer_wheel_reschedule(wheel);
+}
+
+/**
+ * \brief cancel an entry
+ * \param wheel: the wheel the entry was added to
+ * \param entry: the entry
+ **/
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_entry_t *entry) {
+    if (entry->pprev != NULL) {
+        timer_entry_unlink(wheel, entry);
+    }
+}
+
+/**
+ * \brief check whether an entry is pending
+ * \param entry: the entry
+ * \return 1 if pending, 0 otherwise
+ **/
+int timer_entry_pending(timer_entry_t *entry) {
+    return entry->pprev != NULL;
+}
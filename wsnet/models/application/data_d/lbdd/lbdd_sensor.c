@@ -56,6 +56,9 @@ model_t model =  {
 #define DIRECTION_UP    'U'
 #define DIRECTION_DOWN  'D'
 
+/* granularity of neighbor expiry (1ms) */
+#define EXPIRY_TICK 1000000
+
 
 /* ************************************************** */
 /* ************************************************** */
@@ -113,6 +116,7 @@ struct lbdd_neighbor {
     int id;
     position_t position;                         
     uint64_t time;
+    timer_entry_t expiry;
 };
 
 /**************************************************************************/
@@ -133,6 +137,7 @@ struct nodedata {
 
     /* storage */
     void *neighbors;
+    timer_wheel_t *expiry;
     int s_seq[MAX_SOURCE];
     int r_seq[MAX_SINK];
     int d_source[MAX_METADATA];
@@ -323,6 +328,12 @@ int setnode(call_t *c, void *params) {
         }
     }
 
+    /* after the parameters, so that their error path has no wheel to free */
+    if ((nodedata->expiry = timer_wheel_create(c, EXPIRY_TICK)) == NULL) {
+        fprintf(stderr,"[LBDD] Error while creating the neighbor expiry timer wheel !\n");
+        goto error;
+    }
+
     set_node_private_data(c, nodedata);
     return 0;
 
@@ -338,6 +349,7 @@ int unsetnode(call_t *c) {
 
     //lbdd_stats(c);
 
+    timer_wheel_destroy(nodedata->expiry);
     while ((neighbor = (struct lbdd_neighbor *) das_pop(nodedata->neighbors)) != NULL) {
         free(neighbor);
     }
@@ -469,16 +481,14 @@ struct lbdd_neighbor *lbdd_next_hop(call_t *c, position_t *position) {
     return n_hop;
 }
 
-int neighbor_timeout(void *data, void *arg) {
-    call_t *c = (call_t *) arg;
+/* Neighbor expiry, fired by the node timer wheel once the neighbor has not
+ * been heard for more than h_timeout */
+void neighbor_timeout(call_t *c, void *data) {
     struct nodedata *nodedata = get_node_private_data(c);
     struct lbdd_neighbor *neighbor = (struct lbdd_neighbor *) data;
 
-    if ((get_time() - neighbor->time) > nodedata->h_timeout) {
-        return 1;
-    }
-
-    return 0;
+    das_delete(nodedata->neighbors, neighbor);
+    free(neighbor);
 }
 
 /* Periodic exchange of hello packets */
@@ -511,11 +521,6 @@ int hello_callback(call_t *c, void *args) {
     TX(&c0, packet);	   
     entitydata->TX_hello++;
     
-    /* check neighbors timeout */
-    if (nodedata->h_timeout > 0) {
-        das_selective_delete(nodedata->neighbors, neighbor_timeout, (void *) c);
-    }
-    
     /* schedules hello */
     if (nodedata->h_nbr > 0) {
         nodedata->h_nbr --;
@@ -594,6 +599,9 @@ void rx_lbdd_hello(call_t *c, packet_t *packet) {
             neighbor->position.y = hello->position.y;
             neighbor->position.z = hello->position.z;
             neighbor->time       = get_time();
+            if (nodedata->h_timeout > 0) {
+                timer_wheel_add(nodedata->expiry, &(neighbor->expiry), neighbor->time + nodedata->h_timeout + 1);
+            }
             packet_dealloc(packet);
             return;
         }
@@ -606,6 +614,10 @@ void rx_lbdd_hello(call_t *c, packet_t *packet) {
     neighbor->position.y = hello->position.y;
     neighbor->position.z = hello->position.z;
     neighbor->time       = get_time();
+    timer_entry_init(&(neighbor->expiry), neighbor_timeout, neighbor);
+    if (nodedata->h_timeout > 0) {
+        timer_wheel_add(nodedata->expiry, &(neighbor->expiry), neighbor->time + nodedata->h_timeout + 1);
+    }
     das_insert(nodedata->neighbors, (void *) neighbor);
     packet_dealloc(packet);
     return;
@@ -62,6 +62,9 @@ struct nodedata {
 
     void *packets;
     buffer_entry_t *txbuf;
+    buffer_index_t *index;
+    buffer_key_t key;
+    call_t key_call;
 
     double EDThreshold;
     int cs;
@@ -109,6 +112,7 @@ int setnode(call_t *c, void *params) {
     nodedata->state = STATE_IDLE;
     nodedata->packets = das_create();
     nodedata->txbuf = NULL;
+    nodedata->key = NULL;
     nodedata->cca = 1;
     nodedata->cs = 1;
     nodedata->EDThreshold = EDThresholdMin;
@@ -165,6 +169,9 @@ int setnode(call_t *c, void *params) {
         nodedata->MinBE = macMinBE;
     }
 
+    if ((nodedata->index = buffer_index_create()) == NULL) {
+        goto error;
+    }
 
     set_node_private_data(c, nodedata);
     return 0;
@@ -182,6 +189,7 @@ int unsetnode(call_t *c) {
 	free(buff_ent);
     }
     das_destroy(nodedata->packets);    
+    buffer_index_destroy(nodedata->index);
     if (nodedata->txbuf) {
         packet_dealloc(nodedata->txbuf->packet);
 	free(nodedata->txbuf);
@@ -225,6 +233,7 @@ int state_machine(call_t *c, void *args) {
             if (nodedata->txbuf == NULL) {
                 return 0;
             }
+            buffer_index_remove(nodedata->index, nodedata->txbuf);
         }
         
         if (nodedata->MaxCSMABackoffs != 0) {
@@ -273,7 +282,7 @@ printf("[RDO] Too many backoffs, dropping packet at %d\n", c->node);
 	free(nodedata->txbuf);
         nodedata->txbuf = NULL;
         timeout = packet->size * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod;
-        TX(&c0, packet); 
+        TX_DOWN(c, packet);
         nodedata->state = STATE_TXING;
         nodedata->clock = get_time() + timeout;
         scheduler_add_callback(nodedata->clock, c, state_machine, NULL);
@@ -317,11 +326,13 @@ void tx(call_t *c, packet_t *packet) {
     struct nodedata *nodedata = get_node_private_data(c);
     buffer_entry_t *buff_ent = malloc(sizeof(buffer_entry_t));
     buff_ent->packet = packet;
+    buff_ent->key = nodedata->key ? nodedata->key(&nodedata->key_call, packet) : 0;
     
     nodedata->clock = get_time() + COMP_TIME;  
     buff_ent->event = scheduler_add_callback(nodedata->clock, c, state_machine,
 	NULL);
     das_insert(nodedata->packets, (void*)buff_ent); 
+    buffer_index_insert(nodedata->index, buff_ent);
 }
 
 
@@ -394,10 +405,51 @@ void set_buffer(call_t *call, void *new_buffer)
 	das_pop(new_buffer);
 
     node_data->packets = new_buffer;
+    buffer_index_rebuild(node_data->index, new_buffer);
     set_node_private_data(call, node_data);
     return;
 }
 
+//registers the routing module's buffer key function
+void set_buffer_key(call_t *call, call_t *call_up, buffer_key_t key)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+    node_data->key = key;
+    node_data->key_call = *call_up;
+}
+
+//next buffer entry with the given key, the packet in backoff (which
+//get_buffer puts in front of the buffer) coming first
+void* find_in_buffer(call_t *call, uint64_t key, void *after)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+    buffer_entry_t *txbuf = node_data->txbuf;
+
+    if(txbuf != NULL && after == txbuf)
+	after = NULL;
+    else if(txbuf != NULL && after == NULL && txbuf->key == key)
+	return txbuf;
+    return buffer_index_find(node_data->index, key, (buffer_entry_t*)after);
+}
+
+//takes an entry out of the buffer, the caller frees it. Dropping the
+//packet in backoff restarts the state machine, as set_buffer does.
+void delete_from_buffer(call_t *call, void *entry)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+
+    if(entry == node_data->txbuf)
+    {
+	node_data->txbuf = NULL;
+	node_data->state = STATE_IDLE;
+	node_data->clock = get_time();
+	scheduler_add_callback(node_data->clock, call, state_machine, NULL);
+	return;
+    }
+    das_delete(node_data->packets, entry);
+    buffer_index_remove(node_data->index, (buffer_entry_t*)entry);
+}
+
 
 /* ************************************************** */
 /* ************************************************** */
@@ -408,5 +460,8 @@ mac_methods_t methods
                          get_header_size,
                          get_header_real_size,
 			 get_buffer,
-			 set_buffer};
+			 set_buffer,
+			 set_buffer_key,
+			 find_in_buffer,
+			 delete_from_buffer};
 
@@ -655,7 +655,7 @@ int state_machine(call_t *c, void *args) {
             }
 
             /* Send the preamble or SYNC packet */
-            TX(&c0, packet);
+            TX_DOWN(c, packet);
 
             nodedata->clock = get_time() + timeout;
             bmac_add_callback(nodedata->clock, c, state_machine);
@@ -674,7 +674,7 @@ int state_machine(call_t *c, void *args) {
             timeout = (packet->size * 8 * radio_get_Tb(&c0));
 
             /* Send the Data packet */
-            TX(&c0, packet); 
+            TX_DOWN(c, packet);
 
             nodedata->state = STATE_TXING;
             nodedata->dst_data = header->dst;
@@ -759,7 +759,7 @@ int state_machine(call_t *c, void *args) {
             nodedata->dst_ack = 0;
 
             /* Send the ACK */
-            TX(&c0, packet);
+            TX_DOWN(c, packet);
 
             /* Adjust clock to the end of transmission */
             timeout = packet_size * 8 /* conversion Bytes -> bits */ 
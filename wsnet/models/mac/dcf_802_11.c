@@ -352,7 +352,7 @@ int dcf_802_11_state_machine(call_t *c, void *args) {
         timeout = (sizeof(struct _dcf_802_11_header) + sizeof(struct _dcf_802_11_rts_header)) * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod + (sizeof(struct _dcf_802_11_header) + sizeof(struct _dcf_802_11_cts_header)) * 8 * radio_get_Tb(&c0) + SPEED_LIGHT; 			
         
         /* Send RTS */
-        TX(&c0, packet); 
+        TX_DOWN(c, packet);
         
         /* Wait for timeout or CTS */
         nodedata->state = STATE_TIMEOUT;
@@ -404,7 +404,7 @@ int dcf_802_11_state_machine(call_t *c, void *args) {
         timeout = (sizeof(struct _dcf_802_11_header) + sizeof(struct _dcf_802_11_cts_header)) * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod + nodedata->size * 8 * radio_get_Tb(&c0) + SPEED_LIGHT;
         
         /* Send CTS */
-        TX(&c0, packet); 
+        TX_DOWN(c, packet);
         
         /* Wait for timeout or DATA */
         nodedata->state = STATE_CTS_TIMEOUT;
@@ -434,7 +434,7 @@ int dcf_802_11_state_machine(call_t *c, void *args) {
         timeout = packet->size * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod + (sizeof(struct _dcf_802_11_header) + sizeof(struct _dcf_802_11_ack_header)) * 8 * radio_get_Tb(&c0) + SPEED_LIGHT;
         
         /* Send data */
-        TX(&c0, packet);
+        TX_DOWN(c, packet);
         
         /* Wait for timeout or ACK */
         nodedata->state = STATE_TIMEOUT;
@@ -448,7 +448,7 @@ int dcf_802_11_state_machine(call_t *c, void *args) {
         timeout = packet->size * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod;
         
         /* Send data */
-        TX(&c0, packet);
+        TX_DOWN(c, packet);
         
         /* Wait for timeout or ACK */
         nodedata->state = STATE_BROAD_DONE;
@@ -467,7 +467,7 @@ int dcf_802_11_state_machine(call_t *c, void *args) {
         timeout =  packet->size * 8 * radio_get_Tb(&c0) + macMinSIFSPeriod;
         
         /* Send ack */
-        TX(&c0, packet);
+        TX_DOWN(c, packet);
         
         /* Wait for end of transmission */
         nodedata->state = STATE_DONE;
@@ -46,6 +46,9 @@ struct entitydata {
 /* ************************************************** */
 struct nodedata {
     void *buffer;
+    buffer_index_t *index;
+    buffer_key_t key;
+    call_t key_call;
 #ifdef ONE_PACKET_AT_A_TIME
     int scheduler;
 #endif
@@ -111,6 +114,8 @@ int setnode(call_t *c, void *params) {
     struct nodedata *nodedata = (struct nodedata *) malloc(sizeof(struct nodedata));
 
     nodedata->buffer    = das_create();
+    nodedata->index     = buffer_index_create();
+    nodedata->key       = NULL;
 
 #ifdef ONE_PACKET_AT_A_TIME
     nodedata->scheduler = 0;
@@ -131,6 +136,7 @@ int unsetnode(call_t *c) {
     }
 
     das_destroy(nodedata->buffer);
+    buffer_index_destroy(nodedata->index);
 
     return 0;
 }
@@ -170,6 +176,7 @@ int tx_delay(call_t *c, void *args) {
     das_init_traverse(nodedata->buffer);
     if((entry = (buffer_entry_t*)das_pop_FIFO(nodedata->buffer)) == NULL)
       return 0;
+    buffer_index_remove(nodedata->index, entry);
 
    struct _mac_header *header = (struct _mac_header *) entry->packet->data;
  
@@ -250,6 +257,7 @@ void tx(call_t *c, packet_t *packet) {
     struct nodedata *nodedata = get_node_private_data(c);
     buffer_entry_t *entry = malloc(sizeof(buffer_entry_t));
     entry->packet = packet;
+    entry->key = nodedata->key ? nodedata->key(&nodedata->key_call, packet) : 0;
     int duration = packet->size / entitydata->bandwidth * ONE_MS;
 
 #ifdef ONE_PACKET_AT_A_TIME
@@ -258,6 +266,7 @@ void tx(call_t *c, packet_t *packet) {
         uint64_t delay = get_time() + duration;
         entry->event = scheduler_add_callback(delay, c, tx_delay, NULL);
 	das_insert(nodedata->buffer, (void*)entry);
+	buffer_index_insert(nodedata->index, entry);
     }
 #else
    uint64_t delay = get_time() + duration;
@@ -276,6 +285,7 @@ void tx(call_t *c, packet_t *packet) {
 
    entry->event = scheduler_add_callback(delay, c, tx_delay, NULL);
    das_insert(nodedata->buffer, (void*)entry);
+   buffer_index_insert(nodedata->index, entry);
 #endif
 }
 
@@ -349,9 +359,33 @@ void set_buffer(call_t *call, void* new_buffer)
     struct nodedata *node_data = get_node_private_data(call);
     das_destroy(node_data->buffer);
     node_data->buffer = new_buffer;
+    buffer_index_rebuild(node_data->index, new_buffer);
     set_node_private_data(call, node_data);
 }
 
+//registers the routing module's buffer key function
+void set_buffer_key(call_t *call, call_t *call_up, buffer_key_t key)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+    node_data->key = key;
+    node_data->key_call = *call_up;
+}
+
+//next buffer entry with the given key
+void* find_in_buffer(call_t *call, uint64_t key, void *after)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+    return buffer_index_find(node_data->index, key, (buffer_entry_t*)after);
+}
+
+//takes an entry out of the buffer, the caller frees it
+void delete_from_buffer(call_t *call, void *entry)
+{
+    struct nodedata *node_data = get_node_private_data(call);
+    das_delete(node_data->buffer, entry);
+    buffer_index_remove(node_data->index, (buffer_entry_t*)entry);
+}
+
 /* ************************************************** */
 /* ************************************************** */
 mac_methods_t methods = {rx, 
@@ -360,7 +394,10 @@ mac_methods_t methods = {rx,
                          get_header_size,
                          get_header_real_size,
 			 get_buffer,
-			 set_buffer};
+			 set_buffer,
+			 set_buffer_key,
+			 find_in_buffer,
+			 delete_from_buffer};
 
 
     
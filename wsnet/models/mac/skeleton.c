@@ -116,7 +116,7 @@ int state_machine(call_t *c, void *args) {
         timeout = packet->size * 8 * radio_get_Tb(&c0) + SIFS;
 
         /* send packet */
-        TX(&c0, packet); 
+        TX_DOWN(c, packet);
 
         /* change state */
         nodedata->state = STATE_TXING;
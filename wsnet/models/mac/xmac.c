@@ -695,7 +695,7 @@ int state_machine(call_t *c, void *args) {
                 //        nodedata->preamble_count);
 
                 /* Send the preamble packet */
-                TX(&c0, packet);
+                TX_DOWN(c, packet);
             } else {
                 /* All the preamble has been sent */
                 nodedata->preamble_count = 0;
@@ -728,7 +728,7 @@ int state_machine(call_t *c, void *args) {
             timeout = (packet->size * 8 * radio_get_Tb(&c0));
 
             /* Send the Data packet */
-            TX(&c0, packet); 
+            TX_DOWN(c, packet);
 
             nodedata->state = STATE_TXING;
             nodedata->dst_data = header->dst;
@@ -816,7 +816,7 @@ int state_machine(call_t *c, void *args) {
             set_mac_header(c, packet, &destination, PREAMBLE_ACK);
 
             /* Send the Preamble ACK */
-            TX(&c0, packet);
+            TX_DOWN(c, packet);
 
             /* Adjust clock to the end of transmission */
             timeout = (packet_size * 8 /* conversion Bytes -> bits */ 
@@ -853,7 +853,7 @@ int state_machine(call_t *c, void *args) {
             nodedata->dst_ack = 0;
 
             /* Send the DATA ACK */
-            TX(&c0, packet);
+            TX_DOWN(c, packet);
 
             /* Adjust clock to the end of transmission */
             timeout = packet_size * 8 /* conversion Bytes -> bits */ 
@@ -21,10 +21,35 @@ model_t model =  {
 /* ************************************************** */
 /* ************************************************** */
 struct entitydata {
-    FILE *file;
+    position_t *positions;
+    char *found;
 };
 
 
+/* ************************************************** */
+/* ************************************************** */
+/* reads the position file once, in binary or text form */
+int read_positions(struct entitydata *entitydata, char *filepath) {
+    position_record_t *records;
+    table_t table;
+    int i;
+
+    if (table_load(filepath, TABLE_POSITIONS, get_node_count(), &table)) {
+        fprintf(stderr, "filestatic: can not read positions of %s in init()\n", filepath);
+        return -1;
+    }
+    records = (position_record_t *) table.records;
+    for (i = 0; i < table.count; i++) {
+        if ((records[i].id >= 0) && (records[i].id < get_node_count())) {
+            entitydata->positions[records[i].id] = records[i].position;
+            entitydata->found[records[i].id] = 1;
+        }
+    }
+    table_unmap(&table);
+    return 0;
+}
+
+
 /* ************************************************** */
 /* ************************************************** */
 int init(call_t *c, void *params) {
@@ -43,9 +68,14 @@ int init(call_t *c, void *params) {
         }
     }
 
-    /* open file */
-    if ((entitydata->file = fopen(filepath, "r")) == NULL) {
-        fprintf(stderr, "filestatic: can not open file %s in init()\n", filepath);
+    /* extract positions from file */
+    entitydata->positions = malloc(get_node_count() * sizeof(position_t));
+    entitydata->found = calloc(get_node_count(), sizeof(char));
+    if ((entitydata->positions == NULL) || (entitydata->found == NULL)) {
+        fprintf(stderr, "filestatic: can not allocate positions in init()\n");
+        goto error;
+    }
+    if (read_positions(entitydata, filepath)) {
         goto error;
     }
 
@@ -53,6 +83,8 @@ int init(call_t *c, void *params) {
     return 0;
 
  error:
+    free(entitydata->positions);
+    free(entitydata->found);
     free(entitydata);
     return -1;
 }
@@ -60,10 +92,8 @@ int init(call_t *c, void *params) {
 int destroy(call_t *c) {
     struct entitydata *entitydata = get_entity_private_data(c);
 
-    if (entitydata->file != NULL) {
-        fclose(entitydata->file);
-    }
-
+    free(entitydata->positions);
+    free(entitydata->found);
     free(entitydata);
     return 0;
 }
@@ -72,28 +102,14 @@ int destroy(call_t *c) {
 /* ************************************************** */
 /* ************************************************** */
 int setnode(call_t *c, void *params) {
-    int id, found = 0;
-    double x, y, z;
     struct entitydata *entitydata = get_entity_private_data(c);
-    char str[128];
-
-    /* position at the beginning */
-    fseek(entitydata->file, 0L, SEEK_SET);
-    while (fgets(str, 128, entitydata->file) != NULL) {
-        sscanf(str, "%d %lf %lf %lf\n",  &id, &x, &y, &z);
-        if (id == c->node) {
-            found = 1;
-            get_node_position(c->node)->x = x;
-            get_node_position(c->node)->y = y;
-            get_node_position(c->node)->z = z;
-            break; 
-        }
-    }
 
-    if (found == 0) {
+    /* position at the beginning, loaded in init() */
+    if (entitydata->found[c->node] == 0) {
         fprintf(stderr, "filestatic: node %d position not found (setnode())\n", c->node);
         return -1;       
     }
+    *get_node_position(c->node) = entitydata->positions[c->node];
 
     return 0;
 }
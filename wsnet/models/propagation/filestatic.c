@@ -20,8 +20,14 @@ model_t model =  {
 
 /* ************************************************** */
 /* ************************************************** */
+/* the listed links, sorted by source then destination (one row of links per
+ * source). Unlisted links never succeed. */
 struct entitydata {
-    double *success;
+    table_t table;
+    link_record_t *links;
+    int link_cnt;
+    int *first;         /* links of node i: [first[i], first[i + 1]) */
+    nodeid_t *dst;      /* destinations of links, for receivers() */
     int node_cnt;
 };
 
@@ -32,13 +38,13 @@ int init(call_t *c, void *params) {
     struct entitydata *entitydata = malloc(sizeof(struct entitydata));
     param_t *param;
     char *filepath = NULL;
-    int src, dst;
-    double proba;
-    FILE *file;
-    char str[128];
+    int i, k = 0;
 
     /* default values */
     filepath = "propagation.data";
+    entitydata->node_cnt = get_node_count();
+    entitydata->first = NULL;
+    entitydata->dst = NULL;
 
     /* get parameters */
     das_init_traverse(params);
@@ -48,39 +54,55 @@ int init(call_t *c, void *params) {
         }
     }
 
-    /* open file */
-    if ((file = fopen(filepath, "r")) == NULL) {
-        fprintf(stderr, "filestatic: can not open file %s in init()\n", filepath);
-        goto error;
+    /* extract link success probability, in binary or text form */
+    if (table_load(filepath, TABLE_LINKS, entitydata->node_cnt, &entitydata->table)) {
+        fprintf(stderr, "filestatic: can not read links of %s in init()\n", filepath);
+        free(entitydata);
+        return -1;
+    }
+    entitydata->links = (link_record_t *) entitydata->table.records;
+    entitydata->link_cnt = entitydata->table.count;
+    for (i = 0; i < entitydata->link_cnt; i++) {
+        if ((entitydata->links[i].dst < 0) || (entitydata->links[i].dst >= entitydata->node_cnt)) {
+            fprintf(stderr, "filestatic: links of %s exceed the node count in init()\n", filepath);
+            goto error;
+        }
     }
 
-    /* extract link success probability */
-    entitydata->node_cnt = get_node_count();
-    entitydata->success = malloc(sizeof(double) * entitydata->node_cnt *entitydata->node_cnt);
-    for (src = 0; src < entitydata->node_cnt; src++) {
-        for (dst = 0; dst < entitydata->node_cnt; dst++) {
-            
-            *(entitydata->success + (src * entitydata->node_cnt) + dst) = MIN_DBM;
+    /* index the links by source */
+    entitydata->first = malloc((entitydata->node_cnt + 1) * sizeof(int));
+    entitydata->dst = malloc((entitydata->link_cnt ? entitydata->link_cnt : 1) * sizeof(nodeid_t));
+    if ((entitydata->first == NULL) || (entitydata->dst == NULL)) {
+        fprintf(stderr, "filestatic: can not allocate links in init()\n");
+        goto error;
+    }
+    for (i = 0; i <= entitydata->node_cnt; i++) {
+        while ((k < entitydata->link_cnt) && (entitydata->links[k].src < i)) {
+            k++;
         }
+        entitydata->first[i] = k;
     }
-    fseek(file, 0L, SEEK_SET);
-    while (fgets(str, 128, file) != NULL) {
-        sscanf(str, "%d %d %lf\n",  &src, &dst, &proba);
-        *(entitydata->success + (src * entitydata->node_cnt) + dst) = proba;
+    for (i = 0; i < entitydata->link_cnt; i++) {
+        entitydata->dst[i] = entitydata->links[i].dst;
     }
 
-    fclose(file);
     set_entity_private_data(c, entitydata);
     return 0;
 
  error:
+    table_unmap(&entitydata->table);
+    free(entitydata->first);
+    free(entitydata->dst);
     free(entitydata);
     return -1;
 }
 
 int destroy(call_t *c) {
     struct entitydata *entitydata = get_entity_private_data(c);
-    free(entitydata->success);
+
+    table_unmap(&entitydata->table);
+    free(entitydata->first);
+    free(entitydata->dst);
     free(entitydata);
     return 0;
 }
@@ -88,9 +110,31 @@ int destroy(call_t *c) {
 
 /* ************************************************** */
 /* ************************************************** */
+int receivers(call_t *c, nodeid_t src, nodeid_t **dst) {
+    struct entitydata *entitydata = get_entity_private_data(c);
+
+    *dst = entitydata->dst + entitydata->first[src];
+    return entitydata->first[src + 1] - entitydata->first[src];
+}
+
 double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, double rxdBm) {
     struct entitydata *entitydata = get_entity_private_data(c);
-    double success = *(entitydata->success + (src * entitydata->node_cnt) + dst);
+    int lo = entitydata->first[src], hi = entitydata->first[src + 1];
+    double success;
+
+    /* binary search of the row of src */
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (entitydata->dst[mid] < dst) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if ((lo == entitydata->first[src + 1]) || (entitydata->dst[lo] != dst)) {
+        return MIN_DBM;
+    }
+    success = entitydata->links[lo].success;
 
     if (success == 1) {
         return rxdBm;
@@ -106,4 +150,4 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
 
 /* ************************************************** */
 /* ************************************************** */
-propagation_methods_t methods = {propagation};
+propagation_methods_t methods = {propagation, receivers};
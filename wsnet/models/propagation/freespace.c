@@ -103,4 +103,4 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
 
 /* ************************************************** */
 /* ************************************************** */
-propagation_methods_t methods = {propagation};
+propagation_methods_t methods = {propagation, NULL};
@@ -39,6 +39,9 @@ struct entitydata {
     double last_rxdBm;
     double Pr0;
     double period;      // coorelation time
+    // normal and exponential values drawn in batches, from one stream per
+    // receiver
+    rng_sampler_t *samplers;
 };
 
 
@@ -113,6 +116,10 @@ int init(call_t *c, void *params) {
     entitydata->factor = 300 / (4 * M_PI * frequency);
     entitydata->crossover_distance = entitydata->ht * entitydata->hr / entitydata->factor;
 
+    if ((entitydata->samplers = rng_node_samplers_create(c, 0)) == NULL) {
+        goto error;
+    }
+
     set_entity_private_data(c, entitydata);
     return 0;
 
@@ -123,15 +130,17 @@ int init(call_t *c, void *params) {
 }
 
 int destroy(call_t *c) {
-    free(get_entity_private_data(c));
+    struct entitydata *entitydata = get_entity_private_data(c);
+    free(entitydata->samplers);
+    free(entitydata);
     return 0;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-double normal (double avg, double deviation) {
-    return (avg + deviation * cos(2*M_PI*get_random_double()) * sqrt(-2.0 * log(get_random_double())));
+double normal (struct entitydata *entitydata, nodeid_t dst, double avg, double deviation) {
+    return (avg + deviation * rng_sampler_normal(entitydata->samplers + dst));
 }
 
 
@@ -256,20 +265,20 @@ double compute_lognormal_shadowing(struct entitydata *entitydata, nodeid_t src,
 
     dist = distance(get_node_position(src), get_node_position(dst));
 
-    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(0.0, entitydata->deviation);
+    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(entitydata, dst, 0.0, entitydata->deviation);
     
     return mW2dBm(entitydata->Pr0) + powerloss_dbm;
 }
 
 /* ************************************************** */
 /* ************************************************** */
-double compute_fading(struct entitydata *entitydata) {
+double compute_fading(struct entitydata *entitydata, nodeid_t dst) {
 //	struct entitydata *entitydata = get_entity_private_data(c);	
 	double sum = 0;
 	int i;    	
 
 	for(i=0; i < entitydata->m; i++){
-		sum = sum - log(get_random_double());
+		sum = sum + rng_sampler_exponential(entitydata->samplers + dst);
 	}
 	return 10 * log10(sum/entitydata->m);
 }
@@ -288,10 +297,10 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
       case LOGNORMAL    : rx_dBm = compute_lognormal_shadowing(entitydata, src, dst, rxdBm); break;
       default : rx_dBm = rxdBm; /* should not happen */
     }
-    return rx_dBm + compute_fading(entitydata);
+    return rx_dBm + compute_fading(entitydata, dst);
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-propagation_methods_t methods = {propagation};
+propagation_methods_t methods = {propagation, NULL};
@@ -37,6 +37,10 @@ struct entitydata {
     double crossover_distance;
     double last_rxdBm;
     double Pr0;
+
+    /* normal and exponential values drawn in batches, from one stream per
+     * receiver */
+    rng_sampler_t *samplers;
 };
 
 
@@ -105,6 +109,10 @@ int init(call_t *c, void *params) {
     entitydata->factor = 300 / (4 * M_PI * frequency);
     entitydata->crossover_distance = entitydata->ht * entitydata->hr / entitydata->factor;
 
+    if ((entitydata->samplers = rng_node_samplers_create(c, 0)) == NULL) {
+        goto error;
+    }
+
     set_entity_private_data(c, entitydata);
     return 0;
 
@@ -114,15 +122,17 @@ int init(call_t *c, void *params) {
 }
 
 int destroy(call_t *c) {
-    free(get_entity_private_data(c));
+    struct entitydata *entitydata = get_entity_private_data(c);
+    free(entitydata->samplers);
+    free(entitydata);
     return 0;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-double normal (double avg, double deviation) {
-    return (avg + deviation * cos(2*M_PI*get_random_double()) * sqrt(-2.0 * log(get_random_double())));
+double normal (struct entitydata *entitydata, nodeid_t dst, double avg, double deviation) {
+    return (avg + deviation * rng_sampler_normal(entitydata->samplers + dst));
 }
 
 
@@ -247,7 +257,7 @@ double compute_lognormal_shadowing(struct entitydata *entitydata, nodeid_t src,
 
     dist = distance(get_node_position(src), get_node_position(dst));
 
-    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(0.0, entitydata->deviation);
+    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(entitydata, dst, 0.0, entitydata->deviation);
     
     return mW2dBm(entitydata->Pr0) + powerloss_dbm;
 }
@@ -255,9 +265,9 @@ double compute_lognormal_shadowing(struct entitydata *entitydata, nodeid_t src,
 
 /* ************************************************** */
 /* ************************************************** */
-double compute_fading() {
+double compute_fading(struct entitydata *entitydata, nodeid_t dst) {
   //    return 5.0 * log10(-2.0 * VARIANCE * log(get_random_double()));
-  return 10*log10(-1.55 * VARIANCE * log(get_random_double()));
+  return 10*log10(1.55 * VARIANCE * rng_sampler_exponential(entitydata->samplers + dst));
 }
 
   
@@ -275,10 +285,10 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
       default : rx_dBm = rxdBm; /* should not happen */
     }
 
-    return rx_dBm + compute_fading();
+    return rx_dBm + compute_fading(entitydata, dst);
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-propagation_methods_t methods = {propagation};
+propagation_methods_t methods = {propagation, NULL};
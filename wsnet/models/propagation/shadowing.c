@@ -28,6 +28,9 @@ struct entitydata {
     double factor;
     double last_rxdBm;
     double Pr0;
+
+    /* normal values drawn in batches, from one stream per receiver */
+    rng_sampler_t *samplers;
 };
 
 
@@ -73,6 +76,10 @@ int init(call_t *c, void *params) {
     /* update factor */
     entitydata->factor = 300 / (4 * M_PI * frequency);
 
+    if ((entitydata->samplers = rng_node_samplers_create(c, 0)) == NULL) {
+        goto error;
+    }
+
     set_entity_private_data(c, entitydata);
     return 0;
 
@@ -82,15 +89,17 @@ int init(call_t *c, void *params) {
 }
 
 int destroy(call_t *c) {
-    free(get_entity_private_data(c));
+    struct entitydata *entitydata = get_entity_private_data(c);
+    free(entitydata->samplers);
+    free(entitydata);
     return 0;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-double normal (double avg, double deviation) {
-    return (avg + deviation * cos(2*M_PI*get_random_double()) * sqrt(-2.0 * log(get_random_double())));
+double normal (struct entitydata *entitydata, nodeid_t dst, double avg, double deviation) {
+    return (avg + deviation * rng_sampler_normal(entitydata->samplers + dst));
 }
 
 
@@ -132,7 +141,7 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
 
     dist = distance(get_node_position(src), get_node_position(dst));
 
-    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(0.0, entitydata->deviation);
+    powerloss_dbm = -10.0 * entitydata->pathloss * log10(dist/entitydata->dist0) + normal(entitydata, dst, 0.0, entitydata->deviation);
     
     return mW2dBm(entitydata->Pr0) + powerloss_dbm;
 }
@@ -140,4 +149,4 @@ double propagation(call_t *c, packet_t *packet, nodeid_t src, nodeid_t dst, doub
 
 /* ************************************************** */
 /* ************************************************** */
-propagation_methods_t methods = {propagation};
+propagation_methods_t methods = {propagation, NULL};
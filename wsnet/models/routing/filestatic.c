@@ -22,34 +22,40 @@ model_t model =  {
 
 /* ************************************************** */
 /* ************************************************** */
-struct route {
-    nodeid_t dst;
-    nodeid_t n_hop;
-};
-
 struct routing_header {
     nodeid_t dst;
     nodeid_t src;
 };
 
 struct entitydata {
-    FILE *file;
+    table_t table;      /* routes of every node, sorted by node then destination */
+    int *first;         /* routes of node i: [first[i], first[i + 1]) */
 };
 
 struct nodedata {
-    void *routes;
+    route_record_t *routes;
+    int route_cnt;
     int overhead;
 };
 
 
 /* ************************************************** */
 /* ************************************************** */
-unsigned long route_hash(void *key) { 
-    return (unsigned long) key;
-}
+route_record_t *route_lookup(struct nodedata *nodedata, nodeid_t dst) {
+    int lo = 0, hi = nodedata->route_cnt;
 
-int route_equal(void *key0, void *key1) { 
-    return (int) (key0 == key1);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (nodedata->routes[mid].dst < dst) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if ((lo < nodedata->route_cnt) && (nodedata->routes[lo].dst == dst)) {
+        return &nodedata->routes[lo];
+    }
+    return NULL;
 }
 
 
@@ -57,11 +63,14 @@ int route_equal(void *key0, void *key1) {
 /* ************************************************** */
 int init(call_t *c, void *params) {
     struct entitydata *entitydata = malloc(sizeof(struct entitydata));
+    route_record_t *routes;
     param_t *param;
     char *filepath = NULL;
+    int i, k = 0, node_cnt = get_node_count();
 
     /* default values */
     filepath = "routing.data";
+    entitydata->first = NULL;
 
     /* get parameters */
     das_init_traverse(params);
@@ -71,16 +80,31 @@ int init(call_t *c, void *params) {
         }
     }
   
-    /* open file */
-    if ((entitydata->file = fopen(filepath, "r")) == NULL) {
-        fprintf(stderr, "filestatic: can not open file %s in init()\n", filepath);
+    /* extract routing tables from file, in binary or text form */
+    if (table_load(filepath, TABLE_ROUTES, node_cnt, &entitydata->table)) {
+        fprintf(stderr, "filestatic: can not read routes of %s in init()\n", filepath);
+        free(entitydata);
+        return -1;
+    }
+
+    /* index the routes by node */
+    if ((entitydata->first = malloc((node_cnt + 1) * sizeof(int))) == NULL) {
+        fprintf(stderr, "filestatic: can not allocate routes in init()\n");
         goto error;
     }
+    routes = (route_record_t *) entitydata->table.records;
+    for (i = 0; i <= node_cnt; i++) {
+        while ((k < entitydata->table.count) && (routes[k].node < i)) {
+            k++;
+        }
+        entitydata->first[i] = k;
+    }
     
     set_entity_private_data(c, entitydata);
     return 0;
 
  error:
+    table_unmap(&entitydata->table);
     free(entitydata);
     return -1;
 }
@@ -88,10 +112,8 @@ int init(call_t *c, void *params) {
 int destroy(call_t *c) {
     struct entitydata *entitydata = get_entity_private_data(c);
 
-    if (entitydata->file != NULL) {
-        fclose(entitydata->file);
-    }
-
+    table_unmap(&entitydata->table);
+    free(entitydata->first);
     free(entitydata);
     return 0;
 }
@@ -102,47 +124,18 @@ int destroy(call_t *c) {
 int setnode(call_t *c, void *params) {
     struct entitydata *entitydata = get_entity_private_data(c);
     struct nodedata *nodedata = malloc(sizeof(struct nodedata));
-    char str[128];
-    int id, dst, n_hop;
     
-    /* extract routing table from file */
-    nodedata->routes = hadas_create(route_hash, route_equal);
-    
-    /* extract routing table from file */
-    fseek(entitydata->file, 0L, SEEK_SET);
-    while (fgets(str, 128, entitydata->file) != NULL) {
-        if (sscanf(str, "%d %d %d\n",  &id, &dst, &n_hop) != 3) {
-            fprintf(stderr, "filestatic: unable to read route in setnode()\n");
-            goto error;
-        }
-        
-        if (id == c->node) {
-            struct route *route = (struct route *) malloc(sizeof(struct route));
-            route->dst = dst;
-            route->n_hop = n_hop;
-            hadas_insert(nodedata->routes, (void *) ((unsigned long) (route->dst)), (void *) route);
-        }
-    }
+    /* routing table of the node, loaded in init() */
+    nodedata->routes = (route_record_t *) entitydata->table.records + entitydata->first[c->node];
+    nodedata->route_cnt = entitydata->first[c->node + 1] - entitydata->first[c->node];
     
     nodedata->overhead = -1;
     set_node_private_data(c, nodedata);
     return 0;
-
- error:
-    free(entitydata);
-    return -1;
 }
 
 int unsetnode(call_t *c) {
     struct nodedata *nodedata = get_node_private_data(c);
-    struct route *route;
-    int i = get_node_count();
-    while (i--) {
-        if ((route = (struct route *) hadas_get(nodedata->routes, (void *) ((unsigned long) i))) != NULL) {
-            free(route);
-        }
-    }
-    hadas_destroy(nodedata->routes);    
     free(nodedata);
     return 0;
 }
@@ -169,7 +162,7 @@ int ioctl(call_t *c, int option, void *in, void **out) {
 /* ************************************************** */
 int set_header(call_t *c, packet_t *packet, destination_t *dst) {
     struct nodedata *nodedata = get_node_private_data(c);
-    struct route *route = hadas_get(nodedata->routes, (void *) ((unsigned long) (dst->id)));
+    route_record_t *route = route_lookup(nodedata, dst->id);
     struct routing_header *header = (struct routing_header *) (packet->data + nodedata->overhead);
     call_t c0 = {get_entity_bindings_down(c)->elts[0], c->node, c->entity};
     destination_t n_hop;
@@ -210,9 +203,7 @@ int get_header_real_size(call_t *c) {
 /* ************************************************** */
 /* ************************************************** */
 void tx(call_t *c, packet_t *packet) {
-    call_t c0 = {get_entity_bindings_down(c)->elts[0], c->node, c->entity};
-    
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 
@@ -222,7 +213,7 @@ void forward(call_t *c, packet_t *packet) {
     struct nodedata *nodedata = get_node_private_data(c);
     call_t c0 = {get_entity_bindings_down(c)->elts[0], c->node, c->entity};
     struct routing_header *header = (struct routing_header *) (packet->data + nodedata->overhead);
-    struct route *route = hadas_get(nodedata->routes, (void *) ((unsigned long) (header->dst)));
+    route_record_t *route = route_lookup(nodedata, header->dst);
     destination_t destination;
 
     if (route == NULL) {
@@ -235,7 +226,7 @@ void forward(call_t *c, packet_t *packet) {
         packet_dealloc(packet);
         return;
     }
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 void rx(call_t *c, packet_t *packet) {
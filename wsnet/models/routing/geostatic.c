@@ -327,8 +327,7 @@ int get_header_real_size(call_t *c) {
 /* ************************************************** */
 /* ************************************************** */
 void tx(call_t *c, packet_t *packet) {
-    call_t c0 = {get_entity_bindings_down(c)->elts[0], c->node, c->entity};
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 /* ************************************************** */
@@ -371,7 +370,7 @@ void forward(call_t *c, packet_t *packet) {
                   "(from %d to %d, hop limit %d)\n",
                    c->node, header->src, header->dst, 
                    header->hop);
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 
@@ -319,7 +319,7 @@ int advert_callback(call_t *c, void *args) {
     header->hop = 1;
     
     /* send hello */
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
     nodedata->hello_tx++;
 
     /* check neighbors timeout  */
@@ -335,10 +335,9 @@ int advert_callback(call_t *c, void *args) {
 /* ************************************************** */
 void tx(call_t *c, packet_t *packet) {
     struct nodedata *nodedata = get_node_private_data(c);
-    call_t c0 = {get_entity_bindings_down(c)->elts[0], c->node, c->entity};
     
     nodedata->data_tx++;
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 
@@ -393,7 +392,7 @@ void forward(call_t *c, packet_t *packet) {
     
     /* forwarding packet */
     nodedata->data_tx++;
-    TX(&c0, packet);
+    TX_DOWN(c, packet);
 }
 
 
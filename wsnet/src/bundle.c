@@ -32,6 +32,46 @@ bundle_t *get_bundle_by_id(bundleid_t id) {
 }
 
  
+/* ************************************************** */
+/* ************************************************** */
+/* first up and down entities of every entity in the bundle, with the tx of
+ * the one down, so that get_chain() is a couple of loads */
+int bundle_chain_create(bundle_t *bundle) {
+    int i;
+
+    if ((bundle->chain = (chain_t *) malloc(sizeof(chain_t) * entities.size)) == NULL) {
+        fprintf(stderr, "bundle: malloc error (bundle_chain_create())\n");
+        return -1;
+    }
+
+    for (i = 0; i < entities.size; i++) {
+        chain_t *chain = bundle->chain + i;
+        entity_t *entity = get_entity_by_id(i);
+        int slot = entity->bundles.elts[bundle->id];
+
+        chain->up = -1;
+        chain->down = -1;
+        chain->tx = NULL;
+        chain->slot = slot;
+
+        if (slot == -1) {
+            continue;
+        }
+        if (bundle->up[slot].size) {
+            entity_t *up = get_entity_by_id(bundle->up[slot].elts[0]);
+            chain->up = up->id;
+        }
+        if (bundle->down[slot].size) {
+            entity_t *down = get_entity_by_id(bundle->down[slot].elts[0]);
+            chain->down = down->id;
+            chain->tx = down->methods ? down->methods->generic.tx : NULL;
+        }
+    }
+
+    return 0;
+}
+
+
 /* ************************************************** */
 /* ************************************************** */
 int bundle_init(void) {
@@ -59,6 +99,7 @@ void bundle_clean(void) {
         bundle_t *bundle = get_bundle_by_id(i);
         
         free(bundle->name);
+        free(bundle->chain);
         
         if (bundle->antenna.size) {
             free(bundle->antenna.elts);
@@ -35,6 +35,8 @@ typedef struct _bundle {
 
     array_t *up;
     array_t *down;
+
+    chain_t *chain;             /* by entity id, see bundle_chain_create() */
 } bundle_t;
 
 
@@ -57,6 +59,7 @@ bundle_t *get_bundle_by_id(bundleid_t id);
 
 /* ************************************************** */
 /* ************************************************** */
+int bundle_chain_create(bundle_t *bundle);
 int bundle_init(void);
 int bundle_bootstrap(void);
 void bundle_clean(void);
@@ -31,34 +31,23 @@ void parse_bundle_init(bundle_t *bundle, int id) {
 
     bundle->up = NULL;
     bundle->down = NULL;
+    bundle->chain = NULL;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_name(xmlNodePtr nd1, bundle_t *bundle) {
-    xmlAttrPtr attr;
-
-    for (attr = nd1->properties; attr; attr = attr->next) {
-        if (!strcmp((char *) attr->name, XML_A_NAME)) {
-            bundle->name = strdup((char *) attr->children->content);
-            return 0;
-        }
-    }
-
-    return -1;
+int parse_bundle_name(scenario_t *sc, sc_bundle_t *sc_bundle, bundle_t *bundle) {
+    bundle->name = strdup(SC_STRING(sc, sc_bundle->name));
+    return 0;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_birth(xmlNodePtr nd1, bundle_t *bundle) {
-    xmlAttrPtr attr;
-
-    for (attr = nd1->properties; attr; attr = attr->next) {
-        if (!strcmp((gchar *) attr->name, XML_A_BIRTH)) {
-            bundle->birth = (char *) attr->children->content;
-        }
+int parse_bundle_birth(scenario_t *sc, sc_bundle_t *sc_bundle, bundle_t *bundle) {
+    if (sc_bundle->birth != SCENARIO_NONE) {
+        bundle->birth = SC_STRING(sc, sc_bundle->birth);
     }
 
     return 0;
@@ -67,16 +56,9 @@ int parse_bundle_birth(xmlNodePtr nd1, bundle_t *bundle) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_default(xmlNodePtr nd1, bundle_t *bundle) {
-    xmlAttrPtr attr;
-
-    for (attr = nd1->properties; attr; attr = attr->next) {
-        if (!strcmp((char *) attr->name, XML_A_DEFAULT)) {
-            gchar *v = g_strstrip((gchar *) attr->children->content);
-            if  (!strcmp(v, "true") || !strcmp(v, "1")) {
-                dflt_bundle = bundle;
-            }
-        }
+int parse_bundle_default(sc_bundle_t *sc_bundle, bundle_t *bundle) {
+    if (sc_bundle->dflt) {
+        dflt_bundle = bundle;
     }
     
     return 0;
@@ -85,16 +67,9 @@ int parse_bundle_default(xmlNodePtr nd1, bundle_t *bundle) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_worldsens(xmlNodePtr nd1, bundle_t *bundle) {
-    xmlAttrPtr attr;
-
-    for (attr = nd1->properties; attr; attr = attr->next) {
-        if (!strcmp((char *) attr->name, XML_A_WORLDSENS)) {
-            gchar *v = g_strstrip((gchar *) attr->children->content);
-            if  (!strcmp(v, "true") || !strcmp(v, "1")) {
-                bundle->worldsens = NODE_DISCONNECTED;
-            }
-        }
+int parse_bundle_worldsens(sc_bundle_t *sc_bundle, bundle_t *bundle) {
+    if (sc_bundle->worldsens) {
+        bundle->worldsens = NODE_DISCONNECTED;
     }
     
     return 0;
@@ -103,14 +78,11 @@ int parse_bundle_worldsens(xmlNodePtr nd1, bundle_t *bundle) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_allocate(xmlNodePtr nd1, bundle_t *bundle) {
-    xmlNodePtr nd2;
+int parse_bundle_allocate(sc_bundle_t *sc_bundle, bundle_t *bundle) {
     int i;
 
     /* count antenna & entities */
-    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
-        bundle->entity.size++;
-    }
+    bundle->entity.size = sc_bundle->members.count;
 
     /* allocate antenna & entitites */
     if ((bundle->entity.elts = (int *) malloc(sizeof(int) * bundle->entity.size)) == NULL) {
@@ -138,7 +110,7 @@ int parse_bundle_allocate(xmlNodePtr nd1, bundle_t *bundle) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_types(xmlNodePtr nd1, bundle_t *bundle) {
+int parse_bundle_types(bundle_t *bundle) {
     int i;
     int antenna_c = 0;
     int radio_c = 0;
@@ -226,20 +198,11 @@ int parse_bundle_types(xmlNodePtr nd1, bundle_t *bundle) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_updown(xmlNodePtr nd2, bundle_t *bundle, int entity_c) {
-    xmlNodePtr nd3;
-    xmlAttrPtr attr;
-    int up_c = 0;
-    int down_c = 0;
+int parse_bundle_updown(scenario_t *sc, sc_member_t *member, bundle_t *bundle, int entity_c) {
+    int i;
     
-    /* count attributes */
-    for (nd3 = nd2->children; nd3; nd3 = nd3->next) {
-        if (!strcmp((char *) nd3->name, XML_E_UP)) {
-            bundle->up[entity_c].size++;                
-        } else if (!strcmp((char *) nd3->name, XML_E_DOWN)) {
-            bundle->down[entity_c].size++;                
-        }
-    }
+    bundle->up[entity_c].size = member->up.count;
+    bundle->down[entity_c].size = member->down.count;
     
     /* allocate */
     if ((bundle->up[entity_c].size) && 
@@ -256,26 +219,11 @@ int parse_bundle_updown(xmlNodePtr nd2, bundle_t *bundle, int entity_c) {
     }
     
     /* fill */
-    for (nd3 = nd2->children; nd3; nd3 = nd3->next ) {
-        if (!strcmp((char *) nd3->name, XML_E_UP)) {
-            for (attr = nd3->properties; attr; attr = attr->next) {
-                entity_t *entity;
-                if ((entity = get_entity_by_name((char *) attr->children->content)) == NULL) {
-                    fprintf(stderr, "config: wrong entity '%s' has been used (parse_bundle())", attr->children->content);
-                    return -1;
-                }
-                bundle->up[entity_c].elts[up_c++] = entity->id;
-            }
-        } else if (!strcmp((char *) nd3->name, XML_E_DOWN)) {
-            for (attr = nd3->properties; attr; attr = attr->next) {
-                entity_t *entity;
-                if ((entity = get_entity_by_name((char *) attr->children->content)) == NULL) {
-                    fprintf(stderr, "config: wrong entity '%s' has been used (parse_bundle())", attr->children->content);
-                    return -1;
-                }
-                bundle->down[entity_c].elts[down_c++] = entity->id;
-            }
-        }
+    for (i = 0; i < member->up.count; i++) {
+        bundle->up[entity_c].elts[i] = SC_LIST(sc, member->up, int32_t)[i];
+    }
+    for (i = 0; i < member->down.count; i++) {
+        bundle->down[entity_c].elts[i] = SC_LIST(sc, member->down, int32_t)[i];
     }
 
     return 0;
@@ -284,36 +232,13 @@ int parse_bundle_updown(xmlNodePtr nd2, bundle_t *bundle, int entity_c) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle_args(xmlNodePtr nd2, bundle_t *bundle, entity_t *entity, int entity_c) {
-    xmlNodePtr nd3;
-    xmlAttrPtr attr;
-    param_t *param;
-
-    for (nd3 = nd2->children ; nd3 ; nd3 = nd3->next ) {
-        if (!strcmp((char *) nd3->name, XML_E_DEFAULT)) {
-            dflt_param_t *dflt_param;
-                
-            if ((dflt_param = (dflt_param_t *) malloc(sizeof(dflt_param_t))) == NULL) {
-                fprintf(stderr, "config: malloc error (parse_bundle())\n");
-                return -1;
-            }
-            dflt_param->entityid = entity->id;
-            dflt_param->bundleid = bundle->id;
-            dflt_param->nodeid = -1;
-            if ((dflt_param->params = das_create()) == NULL) {
-                return -1;
-            }
-                
-            for (attr = nd3->properties; attr; attr = attr->next) {
-                if ((param = (param_t *) malloc(sizeof(param_t))) == NULL) {
-                    fprintf(stderr, "config: malloc error (parse_bundle())\n");
-                    return -1;
-                }
-                param->key = (char *) attr->name;
-                param->value = (char *) attr->children->content;
-                das_insert(dflt_param->params, param);
-            }   
-            das_insert(dflt_params, dflt_param);
+int parse_bundle_args(scenario_t *sc, sc_member_t *member, bundle_t *bundle) {
+    sc_default_t *dflt = SC_LIST(sc, member->defaults, sc_default_t);
+    int i;
+
+    for (i = 0; i < member->defaults.count; i++) {
+        if (add_dflt_params(sc, &dflt[i], bundle->id, -1)) {
+            return -1;
         }
     }
 
@@ -323,43 +248,33 @@ int parse_bundle_args(xmlNodePtr nd2, bundle_t *bundle, entity_t *entity, int en
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle(xmlNodePtr nd1, int id) {
+int parse_bundle(scenario_t *sc, sc_bundle_t *sc_bundle, int id) {
     bundle_t *bundle = get_bundle_by_id(id);
-    xmlNodePtr nd2;
-    xmlAttrPtr attr;
-    int entity_c = 0;
+    sc_member_t *member = SC_LIST(sc, sc_bundle->members, sc_member_t);
+    int entity_c;
 
     /* initialize */
     parse_bundle_init(bundle, id);
 
-    if (parse_bundle_name(nd1, bundle)) {
+    if (parse_bundle_name(sc, sc_bundle, bundle)) {
         return -1;
     }
-    if (parse_bundle_worldsens(nd1, bundle)) {
+    if (parse_bundle_worldsens(sc_bundle, bundle)) {
         return -1;
     }
-    if (parse_bundle_birth(nd1, bundle)) {
+    if (parse_bundle_birth(sc, sc_bundle, bundle)) {
         return -1;
     }
-    if (parse_bundle_default(nd1, bundle)) {
+    if (parse_bundle_default(sc_bundle, bundle)) {
         return -1;
     }
-    if (parse_bundle_allocate(nd1, bundle)) {
+    if (parse_bundle_allocate(sc_bundle, bundle)) {
         return -1;
     }
     
     /* retrieve entitites */
-    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {  
-        entity_t *entity = NULL;
-        
-        for (attr = nd2->properties; attr; attr = attr->next) {
-            if (!strcmp((gchar *) attr->name, XML_A_ENTITY)) {
-                if ((entity = get_entity_by_name((char *) attr->children->content)) == NULL) {
-                    fprintf(stderr, "config: wrong entity '%s' has been used (parse_bundle())", attr->children->content);
-                    return -1;
-                }
-            }
-        }
+    for (entity_c = 0; entity_c < bundle->entity.size; entity_c++) {
+        entity_t *entity = get_entity_by_id(member[entity_c].entity);
             
         /* include entity in bundle and vice-versa */
         bundle->entity.elts[entity_c] = entity->id;
@@ -367,19 +282,20 @@ int parse_bundle(xmlNodePtr nd1, int id) {
         
         
         /* retrieve elements */
-        if (parse_bundle_updown(nd2, bundle, entity_c)) {
+        if (parse_bundle_updown(sc, &member[entity_c], bundle, entity_c)) {
             return -1;
         }
-        if (parse_bundle_args(nd2, bundle, entity, entity_c)) {
+        if (parse_bundle_args(sc, &member[entity_c], bundle)) {
             return -1;
         }
-                
-        entity_c++;
     }
     
     
 
-    if (parse_bundle_types(nd1, bundle)) {
+    if (parse_bundle_types(bundle)) {
+        return -1;
+    }
+    if (bundle_chain_create(bundle)) {
         return -1;
     }
 
@@ -390,7 +306,8 @@ int parse_bundle(xmlNodePtr nd1, int id) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundles(xmlNodeSetPtr nodeset) {
+int parse_bundles(scenario_t *sc) {
+    sc_bundle_t *sc_bundle = SC_LIST(sc, SC_ROOT(sc)->bundles, sc_bundle_t);
     int i;
 
     /* allocate memory for entity list */
@@ -401,7 +318,7 @@ int parse_bundles(xmlNodeSetPtr nodeset) {
  
     /* parse bundles */
     for (i = 0 ; i < bundles.size; i++) {
-        if (parse_bundle(nodeset->nodeTab[i], i)) {
+        if (parse_bundle(sc, &sc_bundle[i], i)) {
             return -1;
         }
     }
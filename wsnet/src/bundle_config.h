@@ -17,8 +17,8 @@ extern bundle_t *dflt_bundle;
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_bundle(xmlNodePtr nd, int id);
-int parse_bundles(xmlNodeSetPtr nodeset);
+int parse_bundle(scenario_t *sc, sc_bundle_t *sc_bundle, int id);
+int parse_bundles(scenario_t *sc);
 
 
 #endif //__bundle_config__
@@ -89,42 +89,553 @@ typedef struct _xmlpathobj {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_simulation(xmlNodeSetPtr nodeset) {
-    xmlAttrPtr attr;
+int parse_simulation(scenario_t *sc) {
+    sc_root_t *root = SC_ROOT(sc);
     uint64_t duration;
-    
-    if (nodeset == NULL) {
-        fprintf(stderr, "config: schema must require one '" XML_E_SIMULATION "' (parse_simulation())\n");
+
+    /* retrieve @nodes / @duration / @x / @y / @z */
+    /* xsd: 1 <= @nodes <= 65535 */
+    nodes.size = strtoll(SC_STRING(sc, root->node_count), NULL, 10);
+    if (root->duration != SCENARIO_NONE) {
+        /* xsd: 0 <= @duration */
+        get_param_time(SC_STRING(sc, root->duration), &duration);
+        scheduler_set_end(duration);
+    }
+    if (root->x != SCENARIO_NONE) {
+        /* xsd: 0 <= @x */
+        get_topology_area()->x = strtod(SC_STRING(sc, root->x), NULL);
+    }
+    if (root->y != SCENARIO_NONE) {
+        /* xsd: 0 <= @y */
+        get_topology_area()->y = strtod(SC_STRING(sc, root->y), NULL);
+    }
+    if (root->z != SCENARIO_NONE) {
+        /* xsd: 0 <= @z */
+        get_topology_area()->z = strtod(SC_STRING(sc, root->z), NULL);
+    }
+
+    print_simulation();
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* Building the scenario from the XML document. The block moves on every
+ * allocation, so records are reached again through their offset after
+ * each one, and lists are filled in locals before being stored. */
+#define SC_AT(sc, offset, type) ((type *) ((sc)->base + (offset)))
+
+static int is_element(xmlNodePtr nd, char *element) {
+    return (nd->type == XML_ELEMENT_NODE) && !strcmp((char *) nd->name, element);
+}
+
+static int is_true(xmlAttrPtr attr) {
+    gchar *v = g_strstrip((gchar *) attr->children->content);
+    return !strcmp(v, "true") || !strcmp(v, "1");
+}
+
+static int32_t build_string(scenario_t *sc, xmlAttrPtr attr) {
+    return scenario_string(sc, (char *) attr->children->content);
+}
+
+static int build_list(scenario_t *sc, sc_list_t *list, int count, int size) {
+    list->count = count;
+    list->offset = 0;
+    if (count && ((list->offset = scenario_alloc(sc, count * size)) == -1)) {
         return -1;
     }
-    
-    /* retrieve @nodes / @duration / @x / @y / @z */
+    return 0;
+}
+
+/* last entity with this name, like get_entity_by_name() */
+static int32_t build_entity_id(scenario_t *sc, char *name) {
+    sc_list_t entities = SC_ROOT(sc)->entities;
+    int i = entities.count;
+
+    while (i--) {
+        if (!strcmp(name, sc->base + SC_AT(sc, entities.offset, sc_entity_t)[i].name)) {
+            break;
+        }
+    }
+    if (i < 0) {
+        fprintf(stderr, "config: wrong entity '%s' has been used (build_scenario())\n", name);
+    }
+    return i;
+}
+
+static int32_t build_bundle_id(scenario_t *sc, char *name) {
+    sc_list_t bundles = SC_ROOT(sc)->bundles;
+    int i = bundles.count;
+
+    while (i--) {
+        if (!strcmp(name, sc->base + SC_AT(sc, bundles.offset, sc_bundle_t)[i].name)) {
+            break;
+        }
+    }
+    if (i < 0) {
+        fprintf(stderr, "config: wrong bundle '%s' has been used (build_scenario())\n", name);
+    }
+    return i;
+}
+
+/* attributes of nd, but attribute skip */
+static int build_params(scenario_t *sc, xmlNodePtr nd, char *skip, sc_list_t *list) {
+    xmlAttrPtr attr;
+    int count = 0;
+
+    for (attr = nd->properties; attr; attr = attr->next) {
+        if ((skip == NULL) || strcmp((char *) attr->name, skip)) {
+            count++;
+        }
+    }
+    if (build_list(sc, list, count, sizeof(sc_param_t))) {
+        return -1;
+    }
+
+    count = 0;
+    for (attr = nd->properties; attr; attr = attr->next) {
+        int32_t key, value;
+
+        if (skip && !strcmp((char *) attr->name, skip)) {
+            continue;
+        }
+        if (((key = scenario_string(sc, (char *) attr->name)) == -1)
+            || ((value = build_string(sc, attr)) == -1)) {
+            return -1;
+        }
+        SC_AT(sc, list->offset, sc_param_t)[count].key = key;
+        SC_AT(sc, list->offset, sc_param_t)[count].value = value;
+        count++;
+    }
+    return 0;
+}
+
+/* attributes of all the children named element of nd1, as one list */
+static int build_children_params(scenario_t *sc, xmlNodePtr nd1, char *element, sc_list_t *list) {
+    xmlNodePtr nd2;
+    xmlAttrPtr attr;
+    int count = 0;
+
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        if (is_element(nd2, element)) {
+            for (attr = nd2->properties; attr; attr = attr->next) {
+                count++;
+            }
+        }
+    }
+    if (build_list(sc, list, count, sizeof(sc_param_t))) {
+        return -1;
+    }
+
+    count = 0;
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        for (attr = is_element(nd2, element) ? nd2->properties : NULL; attr; attr = attr->next) {
+            int32_t key, value;
+
+            if (((key = scenario_string(sc, (char *) attr->name)) == -1)
+                || ((value = build_string(sc, attr)) == -1)) {
+                return -1;
+            }
+            SC_AT(sc, list->offset, sc_param_t)[count].key = key;
+            SC_AT(sc, list->offset, sc_param_t)[count].value = value;
+            count++;
+        }
+    }
+    return 0;
+}
+
+/* one set of parameters per child named element of nd1, for entity, or for
+ * the entity of their 'entity' attribute if entity is SCENARIO_NONE */
+static int build_defaults(scenario_t *sc, xmlNodePtr nd1, char *element, int32_t entity, sc_list_t *list) {
+    xmlNodePtr nd2;
+    xmlAttrPtr attr;
+    int count = 0;
+
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        if (is_element(nd2, element)) {
+            count++;
+        }
+    }
+    if (build_list(sc, list, count, sizeof(sc_default_t))) {
+        return -1;
+    }
+
+    count = 0;
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        sc_list_t params;
+        int32_t id = entity;
+
+        if (!is_element(nd2, element)) {
+            continue;
+        }
+        if (entity == SCENARIO_NONE) {
+            for (attr = nd2->properties; attr; attr = attr->next) {
+                if (!strcmp((char *) attr->name, XML_A_ENTITY)
+                    && ((id = build_entity_id(sc, (char *) attr->children->content)) == -1)) {
+                    return -1;
+                }
+            }
+        }
+        if (build_params(sc, nd2, (entity == SCENARIO_NONE) ? XML_A_ENTITY : NULL, &params)) {
+            return -1;
+        }
+        SC_AT(sc, list->offset, sc_default_t)[count].entity = id;
+        SC_AT(sc, list->offset, sc_default_t)[count].params = params;
+        count++;
+    }
+    return 0;
+}
+
+/* entities named by the attributes (only the first one if first) of the
+ * children named element of nd1 */
+static int build_ids(scenario_t *sc, xmlNodePtr nd1, char *element, int first, sc_list_t *list) {
+    xmlNodePtr nd2;
+    xmlAttrPtr attr;
+    int count = 0;
+
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        for (attr = is_element(nd2, element) ? nd2->properties : NULL; attr; attr = first ? NULL : attr->next) {
+            count++;
+        }
+    }
+    if (build_list(sc, list, count, sizeof(int32_t))) {
+        return -1;
+    }
+
+    count = 0;
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        for (attr = is_element(nd2, element) ? nd2->properties : NULL; attr; attr = first ? NULL : attr->next) {
+            int32_t id = build_entity_id(sc, (char *) attr->children->content);
+            if (id == -1) {
+                return -1;
+            }
+            SC_AT(sc, list->offset, int32_t)[count++] = id;
+        }
+    }
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int build_simulation(scenario_t *sc, xmlNodeSetPtr nodeset) {
+    xmlAttrPtr attr;
+
+    if ((nodeset == NULL) || (nodeset->nodeNr == 0)) {
+        fprintf(stderr, "config: schema must require one '" XML_E_SIMULATION "' (build_simulation())\n");
+        return -1;
+    }
+
     for (attr = nodeset->nodeTab[0]->properties ; attr ; attr = attr->next) {
+        size_t field;
+        int32_t value;
+
         if (! strcmp((char *) attr->name, XML_A_NODES)) {
-            /* xsd: 1 <= @nodes <= 65535 */
-            nodes.size = strtoll((char *) attr->children->content, NULL, 10);
+            field = offsetof(sc_root_t, node_count);
         } else if (! strcmp((char *) attr->name, XML_A_DURATION)) {
-            /* xsd: 0 <= @duration */
-            get_param_time((char *) attr->children->content, &duration);
-            scheduler_set_end(duration);
+            field = offsetof(sc_root_t, duration);
         } else if (! strcmp((char *) attr->name, XML_A_X)) {
-            /* xsd: 0 <= @x */
-            get_topology_area()->x = strtod((char *) attr->children->content, NULL);
+            field = offsetof(sc_root_t, x);
         } else if (! strcmp((char *) attr->name, XML_A_Y)) {
-            /* xsd: 0 <= @y */
-            get_topology_area()->y = strtod((char *) attr->children->content, NULL);
+            field = offsetof(sc_root_t, y);
         } else if (! strcmp((char *) attr->name, XML_A_Z)) {
-            /* xsd: 0 <= @z */
-            get_topology_area()->z = strtod((char *) attr->children->content, NULL);
+            field = offsetof(sc_root_t, z);
+        } else {
+            continue;
+        }
+        if ((value = build_string(sc, attr)) == -1) {
+            return -1;
         }
+        *SC_AT(sc, field, int32_t) = value;
+    }
+    if (SC_ROOT(sc)->node_count == SCENARIO_NONE) {
+        fprintf(stderr, "config: no node count defined (build_simulation())\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int build_entities(scenario_t *sc, xmlNodeSetPtr nodeset) {
+    sc_list_t entities;
+    int i;
+
+    if (build_list(sc, &entities, (nodeset) ? nodeset->nodeNr : 0, sizeof(sc_entity_t))) {
+        return -1;
+    }
+    if (entities.count == 0) {
+        fprintf(stderr, "config: no entity defined (build_entities())\n");
+        return -1;
+    }
+
+    /* names first, entities may refer to each other */
+    for (i = 0; i < entities.count; i++) {
+        xmlAttrPtr attr;
+        int32_t name = SCENARIO_NONE, library = SCENARIO_NONE;
+
+        for (attr = nodeset->nodeTab[i]->properties; attr; attr = attr->next) {
+            if (!strcmp((char *) attr->name, XML_A_LIBRARY)) {
+                library = build_string(sc, attr);
+            } else if (!strcmp((char *) attr->name, XML_A_NAME)) {
+                name = build_string(sc, attr);
+            }
+        }
+        if ((name == SCENARIO_NONE) || (library == SCENARIO_NONE)) {
+            fprintf(stderr, "config: entity %d has no name or no library (build_entities())\n", i);
+            return -1;
+        }
+        SC_AT(sc, entities.offset, sc_entity_t)[i].name = name;
+        SC_AT(sc, entities.offset, sc_entity_t)[i].library = library;
+    }
+    SC_ROOT(sc)->entities = entities;
+
+    for (i = 0; i < entities.count; i++) {
+        sc_list_t list;
+
+        if (build_children_params(sc, nodeset->nodeTab[i], XML_E_INIT, &list)) {
+            return -1;
+        }
+        SC_AT(sc, entities.offset, sc_entity_t)[i].init = list;
+        if (build_defaults(sc, nodeset->nodeTab[i], XML_E_DEFAULT, i, &list)) {
+            return -1;
+        }
+        SC_AT(sc, entities.offset, sc_entity_t)[i].defaults = list;
+    }
+
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int build_environment(scenario_t *sc, xmlNodeSetPtr nodeset) {
+    xmlNodePtr nd1, nd2;
+    xmlAttrPtr attr;
+    sc_list_t list;
+
+    if (((nodeset) ? nodeset->nodeNr : 0) == 0) {
+        fprintf(stderr, "config: no environment defined (build_environment())\n");
+        return -1;
+    }
+    nd1 = nodeset->nodeTab[0];
+
+    if (build_ids(sc, nd1, XML_E_WITH, 1, &list)) {
+        return -1;
+    }
+    SC_ROOT(sc)->with = list;
+    if (build_ids(sc, nd1, XML_E_MODULATION, 1, &list)) {
+        return -1;
+    }
+    SC_ROOT(sc)->modulation = list;
+
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        int32_t *entity = NULL;
+
+        if (is_element(nd2, XML_E_MONITORING)) {
+            entity = &SC_ROOT(sc)->monitoring;
+        } else if (is_element(nd2, XML_E_INTERFERENCES)) {
+            entity = &SC_ROOT(sc)->interferences;
+        } else if (is_element(nd2, XML_E_NOISE)) {
+            entity = &SC_ROOT(sc)->noise;
+        } else if (is_element(nd2, XML_E_PROPAGATION)) {
+            for (attr = nd2->properties; attr; attr = attr->next) {
+                if (!strcmp((char *) attr->name, XML_A_ENTITY)) {
+                    if ((SC_ROOT(sc)->propagation = build_entity_id(sc, (char *) attr->children->content)) == -1) {
+                        return -1;
+                    }
+                } else if (!strcmp((char *) attr->name, XML_A_RANGE)) {
+                    int32_t range = build_string(sc, attr);
+                    if (range == -1) {
+                        return -1;
+                    }
+                    SC_ROOT(sc)->range = range;
+                }
+            }
+        }
+
+        /* entity is the first attribute, lookups do not move the block */
+        if ((entity != NULL) && (nd2->properties != NULL)
+            && ((*entity = build_entity_id(sc, (char *) nd2->properties->children->content)) == -1)) {
+            return -1;
+        }
+    }
+
+    if ((SC_ROOT(sc)->propagation == SCENARIO_NONE) || (SC_ROOT(sc)->interferences == SCENARIO_NONE)) {
+        fprintf(stderr, "config: environment needs a propagation and an interferences entity (build_environment())\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int build_bundle(scenario_t *sc, xmlNodePtr nd1, int32_t offset) {
+    xmlNodePtr nd2;
+    xmlAttrPtr attr;
+    sc_list_t members, list;
+    int count = 0;
+
+    /* @worldsens / @birth / @default, @name is already there */
+    for (attr = nd1->properties; attr; attr = attr->next) {
+        if (!strcmp((char *) attr->name, XML_A_WORLDSENS)) {
+            SC_AT(sc, offset, sc_bundle_t)->worldsens = is_true(attr);
+        } else if (!strcmp((char *) attr->name, XML_A_BIRTH)) {
+            int32_t birth = build_string(sc, attr);
+            if (birth == -1) {
+                return -1;
+            }
+            SC_AT(sc, offset, sc_bundle_t)->birth = birth;
+        } else if (!strcmp((char *) attr->name, XML_A_DEFAULT)) {
+            SC_AT(sc, offset, sc_bundle_t)->dflt = is_true(attr);
+        }
+    }
+
+    /* entities */
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        if (nd2->type == XML_ELEMENT_NODE) {
+            count++;
+        }
+    }
+    if (build_list(sc, &members, count, sizeof(sc_member_t))) {
+        return -1;
+    }
+    SC_AT(sc, offset, sc_bundle_t)->members = members;
+
+    count = 0;
+    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
+        int32_t entity = SCENARIO_NONE;
+
+        if (nd2->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        for (attr = nd2->properties; attr; attr = attr->next) {
+            if (!strcmp((char *) attr->name, XML_A_ENTITY)
+                && ((entity = build_entity_id(sc, (char *) attr->children->content)) == -1)) {
+                return -1;
+            }
+        }
+        if (entity == SCENARIO_NONE) {
+            fprintf(stderr, "config: bundle %s has an element without entity (build_bundle())\n",
+                    sc->base + SC_AT(sc, offset, sc_bundle_t)->name);
+            return -1;
+        }
+        SC_AT(sc, members.offset, sc_member_t)[count].entity = entity;
+
+        if (build_ids(sc, nd2, XML_E_UP, 0, &list)) {
+            return -1;
+        }
+        SC_AT(sc, members.offset, sc_member_t)[count].up = list;
+        if (build_ids(sc, nd2, XML_E_DOWN, 0, &list)) {
+            return -1;
+        }
+        SC_AT(sc, members.offset, sc_member_t)[count].down = list;
+        if (build_defaults(sc, nd2, XML_E_DEFAULT, entity, &list)) {
+            return -1;
+        }
+        SC_AT(sc, members.offset, sc_member_t)[count].defaults = list;
+        count++;
+    }
+
+    return 0;
+}
+
+int build_bundles(scenario_t *sc, xmlNodeSetPtr nodeset) {
+    sc_list_t bundles;
+    int i, dflt = 0;
+
+    if (build_list(sc, &bundles, (nodeset) ? nodeset->nodeNr : 0, sizeof(sc_bundle_t))) {
+        return -1;
+    }
+    if (bundles.count == 0) {
+        fprintf(stderr, "config: no bundle defined (build_bundles())\n");
+        return -1;
+    }
+
+    /* names first, nodes refer to bundles by name */
+    for (i = 0; i < bundles.count; i++) {
+        xmlAttrPtr attr;
+        int32_t name = SCENARIO_NONE;
+
+        for (attr = nodeset->nodeTab[i]->properties; attr; attr = attr->next) {
+            if (!strcmp((char *) attr->name, XML_A_NAME)) {
+                name = build_string(sc, attr);
+            }
+        }
+        if (name == SCENARIO_NONE) {
+            fprintf(stderr, "config: bundle %d has no name (build_bundles())\n", i);
+            return -1;
+        }
+        SC_AT(sc, bundles.offset, sc_bundle_t)[i].name = name;
+        SC_AT(sc, bundles.offset, sc_bundle_t)[i].birth = SCENARIO_NONE;
+    }
+    SC_ROOT(sc)->bundles = bundles;
+
+    for (i = 0; i < bundles.count; i++) {
+        if (build_bundle(sc, nodeset->nodeTab[i], bundles.offset + i * sizeof(sc_bundle_t))) {
+            return -1;
+        }
+        dflt |= SC_AT(sc, bundles.offset, sc_bundle_t)[i].dflt;
+    }
+    if (dflt == 0) {
+        fprintf(stderr, "config: no default bundle defined (build_bundles())\n");
+        return -1;
     }
 
-    print_simulation();
     return 0;
 }
 
 
+/* ************************************************** */
+/* ************************************************** */
+int build_nodes(scenario_t *sc, xmlNodeSetPtr nodeset) {
+    sc_list_t nodes_list;
+    int i, node_cnt = strtoll(SC_STRING(sc, SC_ROOT(sc)->node_count), NULL, 10);
 
+    if (build_list(sc, &nodes_list, (nodeset) ? nodeset->nodeNr : 0, sizeof(sc_node_t))) {
+        return -1;
+    }
+    SC_ROOT(sc)->nodes = nodes_list;
+
+    for (i = 0; i < nodes_list.count; i++) {
+        xmlNodePtr nd1 = nodeset->nodeTab[i];
+        xmlAttrPtr attr;
+        int32_t id = SCENARIO_NONE, bundle = SCENARIO_NONE, birth = SCENARIO_NONE;
+        sc_list_t list;
+
+        for (attr = nd1->properties; attr; attr = attr->next) {
+            if (!strcmp((char *) attr->name, XML_A_ID)) {
+                id = strtoll((char *) attr->children->content, NULL, 10);
+            } else if (!strcmp((char *) attr->name, XML_A_AS)) {
+                if ((bundle = build_bundle_id(sc, (char *) attr->children->content)) == -1) {
+                    return -1;
+                }
+            } else if (!strcmp((char *) attr->name, XML_A_BIRTH)) {
+                if ((birth = build_string(sc, attr)) == -1) {
+                    return -1;
+                }
+            }
+        }
+        if ((id < 0) || (id >= node_cnt)) {
+            fprintf(stderr, "config: node id %d out of range (build_nodes())\n", id);
+            return -1;
+        }
+        if (build_defaults(sc, nd1, XML_E_FOR, SCENARIO_NONE, &list)) {
+            return -1;
+        }
+
+        SC_AT(sc, nodes_list.offset, sc_node_t)[i].id = id;
+        SC_AT(sc, nodes_list.offset, sc_node_t)[i].bundle = bundle;
+        SC_AT(sc, nodes_list.offset, sc_node_t)[i].birth = birth;
+        SC_AT(sc, nodes_list.offset, sc_node_t)[i].fors = list;
+    }
+
+    return 0;
+}
 
 
 /* ************************************************** */
@@ -180,37 +691,83 @@ void *get_entity_params(nodeid_t node, entityid_t entity, bundleid_t bundle) {
 }
 
 
+
+
+void *get_scenario_params(scenario_t *sc, sc_list_t *list) {
+    sc_param_t *sc_param = SC_LIST(sc, *list, sc_param_t);
+    void *params;
+    param_t *param;
+    int i;
+
+    if ((params = das_create()) == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < list->count; i++) {
+        if ((param = (param_t *) malloc(sizeof(param_t))) == NULL) {
+            fprintf(stderr, "config: malloc error (get_scenario_params())\n");
+            return NULL;
+        }
+        param->key = SC_STRING(sc, sc_param[i].key);
+        param->value = SC_STRING(sc, sc_param[i].value);
+        das_insert(params, param);
+    }
+
+    return params;
+}
+
+int add_dflt_params(scenario_t *sc, sc_default_t *dflt, bundleid_t bundle, nodeid_t node) {
+    dflt_param_t *dflt_param;
+
+    if ((dflt_param = (dflt_param_t *) malloc(sizeof(dflt_param_t))) == NULL) {
+        fprintf(stderr, "config: malloc error (add_dflt_params())\n");
+        return -1;
+    }
+    dflt_param->entityid = dflt->entity;
+    dflt_param->bundleid = bundle;
+    dflt_param->nodeid = node;
+    if ((dflt_param->params = get_scenario_params(sc, &dflt->params)) == NULL) {
+        free(dflt_param);
+        return -1;
+    }
+
+    das_insert(dflt_params, dflt_param);
+    return 0;
+}
+
+
 /* ************************************************** */
 /* ************************************************** */
-int do_configuration(void) {
+int config_read_xml(scenario_t *sc) {
     xmlSchemaValidCtxtPtr sv_ctxt = NULL;
     xmlSchemaParserCtxtPtr sp_ctxt = NULL;
     xmlSchemaPtr schema = NULL;
     xmlParserCtxtPtr p_ctxt = NULL;
     xmlDocPtr doc = NULL;
-    xmlXPathContextPtr xp_ctx = NULL; 
+    xmlXPathContextPtr xp_ctx = NULL;
     xmlXPathObjectPtr simul_xobj = NULL;
-    xmlXPathObjectPtr entity_xobj = NULL; 
-    xmlXPathObjectPtr environment_xobj = NULL; 
-    xmlXPathObjectPtr bundle_xobj = NULL; 
-    xmlXPathObjectPtr node_xobj = NULL; 
-    xmlNodeSetPtr nodeset;
-    xmlpathobj_t xpathobj[] = {{&simul_xobj, (xmlChar *) XML_X_SIMULATION}, 
+    xmlXPathObjectPtr entity_xobj = NULL;
+    xmlXPathObjectPtr environment_xobj = NULL;
+    xmlXPathObjectPtr bundle_xobj = NULL;
+    xmlXPathObjectPtr node_xobj = NULL;
+    xmlpathobj_t xpathobj[] = {{&simul_xobj, (xmlChar *) XML_X_SIMULATION},
                                {&entity_xobj, (xmlChar *) XML_X_ENTITY},
                                {&environment_xobj, (xmlChar *) XML_X_ENVIRONMENT},
                                {&bundle_xobj, (xmlChar *) XML_X_BUNDLE},
                                {&node_xobj, (xmlChar *) XML_X_NODE}};
     int ok = 0, i;
 
-    gchar **path;
+    if (scenario_create(sc)) {
+        return -1;
+    }
 
     /* Check XML version */
     LIBXML_TEST_VERSION;
-        
+
     /* Initialise and parse schema */
     sp_ctxt = xmlSchemaNewParserCtxt(schemafile);
     if (sp_ctxt == NULL) {
-        fprintf(stderr, "config: XML schema parser initialisation failure (do_configuration())\n");
+        fprintf(stderr, "config: XML schema parser initialisation failure (config_read_xml())\n");
         ok = -1;
         goto cleanup;
     }
@@ -218,10 +775,10 @@ int do_configuration(void) {
                              (xmlSchemaValidityErrorFunc)   xml_error,
                              (xmlSchemaValidityWarningFunc) xml_warning,
                              NULL);
-    
+
     schema = xmlSchemaParse(sp_ctxt);
     if (schema == NULL) {
-        fprintf(stderr, "config: error in schema %s (do_configuration())\n", schemafile);
+        fprintf(stderr, "config: error in schema %s (config_read_xml())\n", schemafile);
         ok = -1;
         goto cleanup;
     }
@@ -229,96 +786,132 @@ int do_configuration(void) {
                             (xmlSchemaValidityErrorFunc)   xml_error,
                             (xmlSchemaValidityWarningFunc) xml_warning,
                             NULL);
-    
+
     sv_ctxt = xmlSchemaNewValidCtxt(schema);
     if (sv_ctxt == NULL) {
-        fprintf(stderr, "config: XML schema validator initialisation failure (do_configuration())\n");
+        fprintf(stderr, "config: XML schema validator initialisation failure (config_read_xml())\n");
         ok = -1;
         goto cleanup;
     }
-    
+
     /* Initialise and parse document */
     p_ctxt = xmlNewParserCtxt();
     if (p_ctxt == NULL) {
-        fprintf(stderr, "config: XML parser initialisation failure (do_configuration())\n");
+        fprintf(stderr, "config: XML parser initialisation failure (config_read_xml())\n");
         ok = -1;
         goto cleanup;
     }
-    
+
     doc = xmlCtxtReadFile(p_ctxt, configfile, NULL, XML_PARSE_NONET | XML_PARSE_NOBLANKS | XML_PARSE_NSCLEAN);
     if (doc == NULL) {
-        fprintf(stderr, "config: failed to parse %s (do_configuration())\n", configfile);
+        fprintf(stderr, "config: failed to parse %s (config_read_xml())\n", configfile);
         ok = -1;
         goto cleanup;
     }
 
     /* Validate document */
     if (xmlSchemaValidateDoc(sv_ctxt, doc)) {
-        fprintf(stderr, "config: error in configuration file %s (do_configuration())\n", configfile);
+        fprintf(stderr, "config: error in configuration file %s (config_read_xml())\n", configfile);
         ok = -1;
         goto cleanup;
     }
-    
+
     /* Create xpath context */
     xp_ctx = xmlXPathNewContext(doc);
     if (xp_ctx == NULL) {
-        fprintf(stderr, "config: XPath initialisation failure (do_configuration())\n");
+        fprintf(stderr, "config: XPath initialisation failure (config_read_xml())\n");
         ok = -1;
         goto cleanup;
     }
-    xmlXPathRegisterNs(xp_ctx, (xmlChar *) XML_NS_ID, (xmlChar *) XML_NS_URL); 
-    
-    
+    xmlXPathRegisterNs(xp_ctx, (xmlChar *) XML_NS_ID, (xmlChar *) XML_NS_URL);
+
+
     /* Get xpath obj */
     for (i = 0 ; i < (int) (sizeof(xpathobj) / sizeof(xpathobj[0])); i++) {
         *xpathobj[i].ptr = xmlXPathEvalExpression(xpathobj[i].expr, xp_ctx);
         if (*xpathobj[i].ptr == NULL) {
-            fprintf(stderr, "config: unable to evaluate xpath \"%s\" (do_configuration())\n", xpathobj[i].expr);
+            fprintf(stderr, "config: unable to evaluate xpath \"%s\" (config_read_xml())\n", xpathobj[i].expr);
             ok = -1;
             goto cleanup;
-            
+
         }
     }
 
+    /* Build scenario, entities first as everything refers to them */
+    if (build_simulation(sc, simul_xobj->nodesetval)
+        || build_entities(sc, entity_xobj->nodesetval)
+        || build_environment(sc, environment_xobj->nodesetval)
+        || build_bundles(sc, bundle_xobj->nodesetval)
+        || build_nodes(sc, node_xobj->nodesetval)) {
+        ok = -1;
+        goto cleanup;
+    }
+
+ cleanup:
+    for (i = 0 ; i < (int) (sizeof(xpathobj) / sizeof(xpathobj[0])); i++) {
+        xmlXPathFreeObject(*xpathobj[i].ptr);
+    }
+
+    if (xp_ctx) {
+        xmlXPathFreeContext(xp_ctx);
+    }
+
+    if (sp_ctxt) {
+        xmlSchemaFreeParserCtxt(sp_ctxt);
+    }
+
+    if (schema) {
+        xmlSchemaFree(schema);
+    }
+
+    if (sv_ctxt) {
+        xmlSchemaFreeValidCtxt(sv_ctxt);
+    }
+
+    if (doc) {
+        xmlFreeDoc(doc);
+    }
+
+    if (p_ctxt) {
+        xmlFreeParserCtxt(p_ctxt);
+    }
+
+    xmlCleanupParser();
+
+    if (ok) {
+        scenario_clean(sc);
+    }
+    return ok;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int config_apply(scenario_t *sc) {
+    gchar **path;
+    int ok = 0;
+
     /***************/
     /* Counting... */
     /***************/
-    nodeset = entity_xobj->nodesetval;
-    if ((entities.size = (nodeset) ? nodeset->nodeNr : 0) == 0) {
-        fprintf(stderr, "config: no entity defined (do_configuration())\n");
-        ok = -1; 
-        goto cleanup;
-    }
+    entities.size = SC_ROOT(sc)->entities.count;
     fprintf(stderr, "\nFound %d entities...\n", entities.size);
-    nodeset = environment_xobj->nodesetval;
-    if (((nodeset) ? nodeset->nodeNr : 0) == 0) {
-        fprintf(stderr, "config: no environment defined (do_configuration())\n");
-        ok = -1; 
-        goto cleanup;
-    }
     fprintf(stderr, "Found 1 environment...\n");
-    nodeset = bundle_xobj->nodesetval;
-    if ((bundles.size = (nodeset) ? nodeset->nodeNr : 0) == 0) {
-        fprintf(stderr, "config: no bundle defined (do_configuration())\n");
-        ok = -1; 
-        goto cleanup;
-    }
+    bundles.size = SC_ROOT(sc)->bundles.count;
     fprintf(stderr, "Found %d bundles...\n", bundles.size);
-    
+
 
     if ((dflt_params = das_create()) == NULL) {
-        ok = -1; 
-        goto cleanup;
+        return -1;
     }
 
     /**************/
     /* Simulation */
     /**************/
-    if (parse_simulation(simul_xobj->nodesetval)) {
-        ok = -1;
-        goto cleanup;
+    if (parse_simulation(sc)) {
+        return -1;
     }
-                                                          
+
     /**********/
     /* Entity */
     /**********/
@@ -328,7 +921,7 @@ int do_configuration(void) {
     sys_path_list = g_strsplit(sys_modulesdir, ":", 0); /* TOCLEAN */
 
     /* parse */
-    if (parse_entities(entity_xobj->nodesetval)) {
+    if (parse_entities(sc)) {
         ok = -1;
         goto cleanup;
     }
@@ -344,15 +937,15 @@ int do_configuration(void) {
     /***************/
     /* Environment */
     /***************/
-    if (parse_environment(environment_xobj->nodesetval)) {
+    if (parse_environment(sc)) {
         ok = -1;
         goto cleanup;
     }
-    
+
     /***************/
     /* Bundle      */
     /***************/
-    if (parse_bundles(bundle_xobj->nodesetval)) {
+    if (parse_bundles(sc)) {
         ok = -1;
         goto cleanup;
     }
@@ -360,11 +953,12 @@ int do_configuration(void) {
     /***************/
     /* Nodes      */
     /***************/
-    if (parse_nodes(node_xobj->nodesetval)) {
+    if (parse_nodes(sc)) {
         ok = -1;
         goto cleanup;
     }
- 
+
+ cleanup:
     /* edit by Quentin Lampin <quentin.lampin@orange-ftgroup.com> */
     path = NULL;
     for (path = user_path_list ; *path ; path++) {
@@ -376,38 +970,45 @@ int do_configuration(void) {
     }
     /* end of edition */
 
- cleanup:
-    clean_params();
-    
-    for (i = 0 ; i < (int) (sizeof(xpathobj) / sizeof(xpathobj[0])); i++) {
-        xmlXPathFreeObject(*xpathobj[i].ptr);
-    }
+    return ok;
+}
 
-    if (xp_ctx) {
-        xmlXPathFreeContext(xp_ctx);
-    }
 
-    if (sp_ctxt) {
-        xmlSchemaFreeParserCtxt(sp_ctxt);		
-    }
+/* ************************************************** */
+/* ************************************************** */
+int do_configuration(void) {
+    scenario_t sc;
+    int ok;
 
-    if (schema) {
-        xmlSchemaFree(schema);
+    /* a compiled scenario is recognized by its magic, anything else is XML */
+    if ((ok = scenario_map(&sc, configfile)) == 1) {
+        ok = config_read_xml(&sc);
     }
-
-    if (sv_ctxt) {
-        xmlSchemaFreeValidCtxt(sv_ctxt);
+    if (ok) {
+        return -1;
     }
 
-    if (doc) {
-        xmlFreeDoc(doc);
+    /* parameters and bundle births point into the scenario */
+    ok = config_apply(&sc);
+
+    clean_params();
+    scenario_clean(&sc);
+    return ok;
+}
+
+int do_compilation(char *outfile) {
+    scenario_t sc;
+    int ok;
+
+    if (config_read_xml(&sc)) {
+        return -1;
     }
 
-    if (p_ctxt) {
-        xmlFreeParserCtxt(p_ctxt);
+    ok = scenario_write(&sc, outfile);
+    if (ok == 0) {
+        fprintf(stderr, "\nCompiled %s into %s (%d bytes)\n", configfile, outfile, sc.size);
     }
 
-    xmlCleanupParser();
+    scenario_clean(&sc);
     return ok;
 }
-
@@ -111,17 +111,12 @@ void set_entity_private_data(call_t *c, void *data) {
 }
 
 void *get_node_private_data(call_t *c) {
-    node_t *node = get_node_by_id(c->node);
-    entity_t *entity = get_entity_by_id(c->entity);
-
-    return node->private[entity->bundles.elts[node->bundle]];
+    return get_chain_private_data(c);
 }
 
 void set_node_private_data(call_t *c, void *data) {
-    node_t *node = get_node_by_id(c->node);
-    entity_t *entity = get_entity_by_id(c->entity);
-
-    node->private[entity->bundles.elts[node->bundle]] = data;
+    node_chain_t *node_chain = node_chains + c->node;
+    node_chain->private[node_chain->chain[c->entity].slot] = data;
 }
 
 
@@ -5,6 +5,9 @@
  *  \date   2007
  */
 #include "entity_config.h"
+#ifdef WSNET_STATIC
+#include "static_models.h"
+#endif
 
 
 /* ************************************************** */
@@ -33,17 +36,37 @@ void parse_entity_init(int id) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entity_library(xmlNodePtr nd1, entity_t *entity) {
-    xmlAttrPtr attr;
-    for (attr = nd1->properties; attr; attr = attr->next) {
-        if (!strcmp((char *) attr->name, XML_A_LIBRARY)) {
-            entity->library.name = strdup((char *) attr->children->content);
-        } else if (!strcmp((char *) attr->name, XML_A_NAME)) {
-            entity->name = strdup((char *) attr->children->content);
+int parse_entity_library(scenario_t *sc, sc_entity_t *sc_entity, entity_t *entity) {
+    entity->library.name = strdup(SC_STRING(sc, sc_entity->library));
+    entity->name = strdup(SC_STRING(sc, sc_entity->name));
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* models linked in wsnet-static, see static_models.sh */
+int parse_entity_static(entity_t *entity) {
+#ifdef WSNET_STATIC
+    static_model_t **entry;
+
+    for (entry = static_models; *entry; entry++) {
+        if (strcmp((*entry)->name, entity->library.name)) {
+            continue;
         }
+        entity->library.file = g_strdup("static");
+        entity->model = (*entry)->model;
+        entity->methods = (*entry)->methods;
+        entity->init = (*entry)->init;
+        entity->destroy = (*entry)->destroy;
+        entity->bootstrap = (*entry)->bootstrap;
+        entity->setnode = (*entry)->setnode;
+        entity->unsetnode = (*entry)->unsetnode;
+        entity->ioctl = (*entry)->ioctl;
+        return 0;
     }
-
-    return 0;
+#endif
+    return -1;
 }
 
 
@@ -140,38 +163,13 @@ int parse_entity_measures(entity_t *entity) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entity_args(xmlNodePtr nd1, entity_t *entity) {
-    xmlNodePtr nd2;
-    xmlAttrPtr attr;
-    param_t *param;
-    
-    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
-        if ((nd2->type == XML_ELEMENT_NODE) && 
-            (!strcmp((char *) nd2->name, XML_E_DEFAULT))) {
-            dflt_param_t *dflt_param;
-
-            if ((dflt_param = (dflt_param_t *) malloc(sizeof(dflt_param_t))) == NULL) {
-                fprintf(stderr, "config: malloc error (parse_entity())\n");
-                return -1;
-            }
-            dflt_param->entityid = entity->id;
-            dflt_param->bundleid = -1;
-            dflt_param->nodeid = -1;
-            if ((dflt_param->params = das_create()) == NULL) {
-                return -1;
-            }
-            
-            for (attr = nd2->properties; attr; attr = attr->next) {
-                if ((param = (param_t *) malloc(sizeof(param_t))) == NULL) {
-                    fprintf(stderr, "config: malloc error (parse_entity())\n");
-                    return -1;
-                }
-                param->key = (char *) attr->name;
-                param->value = (char *) attr->children->content;
-                das_insert(dflt_param->params, param);
-            }
-
-            das_insert(dflt_params, dflt_param);
+int parse_entity_args(scenario_t *sc, sc_entity_t *sc_entity, entity_t *entity) {
+    sc_default_t *dflt = SC_LIST(sc, sc_entity->defaults, sc_default_t);
+    int i;
+
+    for (i = 0; i < sc_entity->defaults.count; i++) {
+        if (add_dflt_params(sc, &dflt[i], -1, -1)) {
+            return -1;
         }
     }
 
@@ -200,33 +198,16 @@ int parse_entity_bundle(entity_t *entity) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entity_initialize(xmlNodePtr nd1, entity_t *entity) {
+int parse_entity_initialize(scenario_t *sc, sc_entity_t *sc_entity, entity_t *entity) {
     void *params;
     param_t *param;
-    xmlNodePtr nd2;
-    xmlAttrPtr attr;
     int ok;
     call_t c = {entity->id, -1, -1};
     
-    if ((params = das_create()) == NULL) {
+    if ((params = get_scenario_params(sc, &sc_entity->init)) == NULL) {
         return -1;
     }
 
-    for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
-        if ((nd2->type == XML_ELEMENT_NODE) && 
-            (!strcmp((char *) nd2->name, XML_E_INIT))) {
-            for (attr = nd2->properties; attr; attr = attr->next) {
-                if ((param = (param_t *) malloc(sizeof(param_t))) == NULL) {
-                    fprintf(stderr, "config: malloc error (parse_entity())\n");
-                    return -1;
-                }
-                param->key = (char *) attr->name;
-                param->value = (char *) attr->children->content;
-                das_insert(params, param);
-            }
-        }
-    }
-    
     ok = entity->init ? entity->init(&c, params) : 0;
     
     while ((param = (param_t *) das_pop(params)) != NULL) {
@@ -240,22 +221,20 @@ int parse_entity_initialize(xmlNodePtr nd1, entity_t *entity) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entity(xmlNodePtr nd1, entityid_t id) {
+int parse_entity(scenario_t *sc, sc_entity_t *sc_entity, entityid_t id) {
     entity_t *entity = get_entity_by_id(id);
     
-    if (parse_entity_library(nd1, entity)) {
-        return -1;
-    }
-    if (parse_entity_module(entity)) {
+    if (parse_entity_library(sc, sc_entity, entity)) {
         return -1;
     }
-    if (parse_entity_symbols(entity)) {
+    if (parse_entity_static(entity)
+        && (parse_entity_module(entity) || parse_entity_symbols(entity))) {
         return -1;
     }
     if (parse_entity_measures(entity)) {
         return -1;
     }
-    if (parse_entity_args(nd1, entity)) {
+    if (parse_entity_args(sc, sc_entity, entity)) {
         return -1;
     }
     if (parse_entity_bundle(entity)) {
@@ -264,7 +243,7 @@ int parse_entity(xmlNodePtr nd1, entityid_t id) {
 
     print_entity(entity);
     
-    if (parse_entity_initialize(nd1, entity)) {
+    if (parse_entity_initialize(sc, sc_entity, entity)) {
         return -1;
     }
 
@@ -274,7 +253,8 @@ int parse_entity(xmlNodePtr nd1, entityid_t id) {
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entities(xmlNodeSetPtr nodeset) {
+int parse_entities(scenario_t *sc) {
+    sc_entity_t *sc_entity = SC_LIST(sc, SC_ROOT(sc)->entities, sc_entity_t);
     int i;
 
     if ((entities.elts = (entity_t *) malloc(sizeof(entity_t) * entities.size)) == NULL) {
@@ -287,7 +267,7 @@ int parse_entities(xmlNodeSetPtr nodeset) {
     }
        
     for (i = 0 ; i < entities.size ; i++) {
-        if (parse_entity(nodeset->nodeTab[i], i)) {
+        if (parse_entity(sc, &sc_entity[i], i)) {
             return -1;
         }
     }
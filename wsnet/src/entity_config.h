@@ -12,8 +12,8 @@
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_entity(xmlNodePtr nd1, int id);
-int parse_entities(xmlNodeSetPtr nodeset);
+int parse_entity(scenario_t *sc, sc_entity_t *sc_entity, int id);
+int parse_entities(scenario_t *sc);
 
 
 #endif //__entity_config__
@@ -9,58 +9,30 @@
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_environment(xmlNodeSetPtr nodeset) {
-    xmlNodePtr nd2;
-    xmlNodePtr nd1;
-    xmlAttrPtr attr;
-    
-    nd1 = nodeset->nodeTab[0];
+int parse_environment(scenario_t *sc) {
+    sc_root_t *root = SC_ROOT(sc);
+    int32_t *id;
+    int i;
     
     /* parse elements */
     with_entities = das_create();
     modulation_entities = das_create();
-    for (nd2 = nd1->children; nd2; nd2 = nd2->next ) {
-        if (!strcmp((gchar *) nd2->name, XML_E_WITH)) {
-            entity_t *entity;
-            attr = nd2->properties;
-            
-            entity = get_entity_by_name((char *) attr->children->content);
-            das_insert(with_entities, entity);
-        } else if (!strcmp((gchar *) nd2->name, XML_E_MODULATION)) {
-            entity_t *entity;
-            attr = nd2->properties;
-            
-            entity = get_entity_by_name((char *) attr->children->content);
-            das_insert(modulation_entities, entity);
-        } else if (!strcmp((gchar *) nd2->name, XML_E_MONITORING)) {
-            entity_t *entity;
-            attr = nd2->properties;
-            
-            entity = get_entity_by_name((char *) attr->children->content);
-            monitor_entity = entity;
-        } else if (!strcmp((gchar *) nd2->name, XML_E_PROPAGATION)) {
-            for (attr = nd2->properties; attr; attr = attr->next) {
-                if (! strcmp((gchar *) attr->name, XML_A_ENTITY)) {
-                    entity_t *entity = get_entity_by_name((char *) attr->children->content);
-                    
-                    propagation_entity = entity;
-                } else if (! strcmp((gchar *) attr->name, XML_A_RANGE)) {
-                    propagation_range = strtod((char *) attr->children->content, NULL);
-                }
-            }
-        } else if (!strcmp((gchar *) nd2->name, XML_E_INTERFERENCES)) {
-            entity_t *entity;
-            attr = nd2->properties;
-            
-            entity = get_entity_by_name((char *) attr->children->content);
-            interference_entity = entity;
-        } else if (!strcmp((gchar *) nd2->name, XML_E_NOISE)) {
-            entity_t *entity;
-            attr = nd2->properties;
-            
-            entity = get_entity_by_name((char *) attr->children->content);
-            noise_entity = entity;
-        }            
+    for (id = SC_LIST(sc, root->with, int32_t), i = 0; i < root->with.count; i++) {
+        das_insert(with_entities, get_entity_by_id(id[i]));
+    }
+    for (id = SC_LIST(sc, root->modulation, int32_t), i = 0; i < root->modulation.count; i++) {
+        das_insert(modulation_entities, get_entity_by_id(id[i]));
+    }
+    if (root->monitoring != SCENARIO_NONE) {
+        monitor_entity = get_entity_by_id(root->monitoring);
+    }
+    propagation_entity = get_entity_by_id(root->propagation);
+    if (root->range != SCENARIO_NONE) {
+        propagation_range = strtod(SC_STRING(sc, root->range), NULL);
+    }
+    interference_entity = get_entity_by_id(root->interferences);
+    if (root->noise != SCENARIO_NONE) {
+        noise_entity = get_entity_by_id(root->noise);
     }
     
     print_environment();
@@ -12,7 +12,7 @@
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_environment(xmlNodeSetPtr nodeset);
+int parse_environment(scenario_t *sc);
 void print_environment(void);
 
 
@@ -64,4 +64,10 @@ void worldsens_tx_kill(nodeid_t id);
 int  worldsens_nodes_rx(call_t *c, packet_t *packet);
 
 
+/* ************************************************** */
+/* ************************************************** */
+int do_table_compilation(char *name, char *path, char *outfile);
+int do_table_check(char *name, char *path, char *tablefile);
+
+
 #endif //__internals__
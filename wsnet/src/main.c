@@ -4,6 +4,8 @@
  *  \author Guillaume Chelius & Elyes Ben Hamida
  *  \date   2007
  **/
+#include <getopt.h>
+
 #include "version.h"
 #include "internals.h"
 #include "xmlparser.h"
@@ -17,6 +19,9 @@ int do_bootstrap(void);
 void do_end(void);
 void do_clean(void);
 
+/* exit status, set when --compile fails */
+static int status = 0;
+
 
 /* ************************************************** */
 /* ************************************************** */
@@ -33,7 +38,7 @@ int main(int argc, char *argv[]) {
 
  end:
     do_clean();                  /* clean           */
-    return 0;
+    return status;
 }
 
 
@@ -42,6 +47,9 @@ int main(int argc, char *argv[]) {
 void usage(void) {    
     fprintf(stderr, "\nWSNet: an event driven simulator for wireless networks - version %s.%s\n", WSNET_VERSION_YEAR, WSNET_VERSION_MONTH);
     fprintf(stderr, "Usage: wsnet [-c configfile] [-S rng-seed] [-R rng-type] [-h] [-V]\n");
+    fprintf(stderr, "       wsnet --compile configfile [-o scenariofile]\n");
+    fprintf(stderr, "       wsnet --compile-table routes|positions|links textfile tablefile\n");
+    fprintf(stderr, "       wsnet --check-table routes|positions|links textfile tablefile\n");
     return;
 }
 
@@ -52,9 +60,16 @@ void version(void) {
 
 
 int do_parse(int argc, char *argv[]) {
+    struct option options[] = {{"compile", required_argument, NULL, 'C'},
+                               {"compile-table", required_argument, NULL, 'T'},
+                               {"check-table", required_argument, NULL, 'K'},
+                               {NULL, 0, NULL, 0}};
+    char *outfile = DEFAULT_SCENARIOFILE;
+    char *table = NULL;
+    int compile = 0, check = 0;
     char c;
 
-    while((c = getopt(argc, argv, "c:D:s:R:m:S:h:V")) != -1) {
+    while((c = getopt_long(argc, argv, "c:C:o:D:s:R:m:S:h:V", options, NULL)) != -1) {
 
         switch (c) {
         case 'S':
@@ -66,6 +81,20 @@ int do_parse(int argc, char *argv[]) {
         case 'c':
              config_set_configfile(optarg);
             break;
+        case 'C':
+             config_set_configfile(optarg);
+             compile = 1;
+            break;
+        case 'T':
+             table = optarg;
+            break;
+        case 'K':
+             table = optarg;
+             check = 1;
+            break;
+        case 'o':
+             outfile = optarg;
+            break;
         case 's':
              config_set_schemafile(optarg);
             break;
@@ -87,6 +116,27 @@ int do_parse(int argc, char *argv[]) {
         }
     }
 
+    /* compile or check a table of the filestatic models and stop there */
+    if (table != NULL) {
+        if (argc - optind != 2) {
+            usage();
+            return -1;
+        }
+        if (check ? do_table_check(table, argv[optind], argv[optind + 1])
+            : do_table_compilation(table, argv[optind], argv[optind + 1])) {
+            status = 1;
+        }
+        return -1;
+    }
+
+    /* compile the configuration file and stop there */
+    if (compile) {
+        if (do_compilation(outfile)) {
+            status = 1;
+        }
+        return -1;
+    }
+
     return 0;
 }
 
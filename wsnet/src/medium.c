@@ -91,10 +91,37 @@ double MEDIA_GET_NOISE(call_t *c, int channel) {
 }
 
 
+/* schedules the reception of packet by every antenna of rx_node */
+static void medium_tx_to(node_t *node, node_t *rx_node, packet_t *packet) {
+    double dist = distance(&(node->position), &(rx_node->position));
+    double derive = dist / 0.3;
+    bundle_t *bundle = get_bundle_by_id(rx_node->bundle);
+    uint64_t clock;
+    int i;
+
+    if (rx_node->state == NODE_DEAD) {
+        return;
+    }
+
+    if ((propagation_range) && (dist > propagation_range)) {
+        return;
+    }
+
+    for (i = 0; i < bundle->antenna.size; i++) {
+        entity_t *entity = get_entity_by_id(bundle->antenna.elts[i]);
+        call_t c0 = {entity->id, rx_node->id, -1};
+        packet_t *packet_rx = packet_rxclone(packet);
+
+        clock = packet->clock0 + ((uint64_t) derive);
+        packet_rx->clock0 = clock;
+        packet_rx->clock1 = clock + packet->duration;
+        scheduler_add_rx_begin(clock, &c0, packet_rx);
+    }
+}
+
 void MEDIA_TX(call_t *c, packet_t *packet) {
     int i = get_node_count();
     node_t *node = get_node_by_id(c->node);
-    uint64_t clock;
     
     /* check wether node is active */
     if (node->state != NODE_ACTIVE) {
@@ -123,7 +150,29 @@ void MEDIA_TX(call_t *c, packet_t *packet) {
     }
     /* end of edition */
     
-    /* scheduler rx_begin event */
+    /* scheduler rx_begin event, only for the receivers the propagation
+     * model lists if it does, in decreasing id order like the loops below */
+    if (propagation_entity->methods->propagation.receivers != NULL) {
+        call_t c0 = {propagation_entity->id, c->node, c->from};
+        nodeid_t *rx_ids;
+        int k = propagation_entity->methods->propagation.receivers(&c0, c->node, &rx_ids);
+        int self = 0;
+
+        while (k--) {
+            if (!self && (rx_ids[k] <= c->node)) {
+                medium_tx_to(node, node, packet);
+                self = 1;
+            }
+            if (rx_ids[k] != c->node) {
+                medium_tx_to(node, get_node_by_id(rx_ids[k]), packet);
+            }
+        }
+        if (!self) {
+            medium_tx_to(node, node, packet);
+        }
+        return;
+    }
+
 #ifdef N_DAS_O
     if (propagation_range) {
         void *rx_nodes;
@@ -131,75 +180,17 @@ void MEDIA_TX(call_t *c, packet_t *packet) {
 
         rx_nodes = spadas_rangesearch(location, NULL, &(node->position), propagation_range);
         while ((rx_node = (node_t *) das_pop(rx_nodes)) != NULL) {
-            double derive = distance(&(node->position), &(rx_node->position)) / 0.3; 
-            bundle_t *bundle = get_bundle_by_id(rx_node->bundle);
-            int i;
-    
-            if (rx_node->state == NODE_DEAD) {
-                continue;
-            }
-
-            for (i = 0; i < bundle->antenna.size; i++) {
-                entity_t *entity = get_entity_by_id(bundle->antenna.elts[i]);
-                call_t c0 = {entity->id, rx_node->id, -1}; 
-                packet_t *packet_rx = packet_rxclone(packet);
-                
-                clock = packet->clock0 + ((uint64_t) derive);
-                packet_rx->clock0 = clock;
-                packet_rx->clock1 = clock + packet->duration;
-                scheduler_add_rx_begin(clock, &c0, packet_rx);
-            }
+            medium_tx_to(node, rx_node, packet);
         }
         das_destroy(rx_nodes);
     } else {
         while (i--) {
-            node_t *rx_node = get_node_by_id(i);
-            double derive = distance(&(node->position), &(rx_node->position)) / 0.3; 
-            bundle_t *bundle = get_bundle_by_id(rx_node->bundle);
-            int i;
-            
-            if (rx_node->state == NODE_DEAD) {
-                continue;
-            }
-            
-            for (i = 0; i < bundle->antenna.size; i++) {
-                entity_t *entity = get_entity_by_id(bundle->antenna.elts[i]);
-                call_t c0 = {entity->id, rx_node->id, -1}; 
-                packet_t *packet_rx = packet_rxclone(packet);
-
-                clock = packet->clock0 + ((uint64_t) derive);
-                packet_rx->clock0 = clock;
-                packet_rx->clock1 = clock + packet->duration;
-                scheduler_add_rx_begin(clock, &c0, packet_rx);
-            }
+            medium_tx_to(node, get_node_by_id(i), packet);
         }
     }   
 #else /* N_DAS_O */
     while (i--) {
-        node_t *rx_node = get_node_by_id(i);
-        double dist = distance(&(node->position), &(rx_node->position));
-        double derive = dist / 0.3; 
-        bundle_t *bundle = get_bundle_by_id(rx_node->bundle);
-        int i;
-
-        if (rx_node->state == NODE_DEAD) {
-            continue;
-        }
-        
-        if ((propagation_range) && (dist > propagation_range)) {
-            continue;
-        }
-        
-        for (i = 0; i < bundle->antenna.size; i++) {
-            entity_t *entity = get_entity_by_id(bundle->antenna.elts[i]);
-            call_t c0 = {entity->id, rx_node->id, -1}; 
-            packet_t *packet_rx = packet_rxclone(packet);
-            
-            clock = packet->clock0 + ((uint64_t) derive);
-            packet_rx->clock0 = clock;
-            packet_rx->clock1 = clock + packet->duration;
-            scheduler_add_rx_begin(clock, &c0, packet_rx);
-        }
+        medium_tx_to(node, get_node_by_id(i), packet);
     }
 #endif /* N_DAS_O */
 
@@ -7,6 +7,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "internals.h"
 
@@ -62,3 +65,579 @@ void SET_BUFFER(call_t *call, void *new_buffer)
     return;
 }
 /* end of edition */
+
+
+/* ************************************************** */
+/* ************************************************** */
+#define BUFFER_INDEX_BITS 4
+
+struct _buffer_index_node {
+    buffer_entry_t *entry;
+    struct _buffer_index_node *next;
+};
+
+struct _buffer_index {
+    struct _buffer_index_node **buckets;
+    struct _buffer_index_node *cursor;  /* node of the last entry found */
+    int bits;
+    int count;
+};
+
+int SET_BUFFER_KEY(call_t *call, call_t *call_up, buffer_key_t key) {
+    entity_t *entity = get_entity_by_id(call->entity);
+    if (entity->methods->mac.set_buffer_key == NULL) {
+        return -1;
+    }
+    entity->methods->mac.set_buffer_key(call, call_up, key);
+    return 0;
+}
+
+buffer_entry_t *FIND_IN_BUFFER(call_t *call, uint64_t key,
+    buffer_entry_t *after) {
+    entity_t *entity = get_entity_by_id(call->entity);
+    if (entity->methods->mac.find_in_buffer == NULL) {
+        return NULL;
+    }
+    return (buffer_entry_t *) entity->methods->mac.find_in_buffer(call, key,
+        after);
+}
+
+int DELETE_FROM_BUFFER(call_t *call, buffer_entry_t *entry) {
+    entity_t *entity = get_entity_by_id(call->entity);
+    if (entity->methods->mac.delete_from_buffer == NULL) {
+        return -1;
+    }
+    entity->methods->mac.delete_from_buffer(call, entry);
+    return 0;
+}
+
+static inline int buffer_index_hash(buffer_index_t *index, uint64_t key) {
+    return (int) ((key * 0x9E3779B97F4A7C15ULL) >> (64 - index->bits));
+}
+
+/* appends to the bucket's chain, so chains keep insertion order */
+static void buffer_index_append(buffer_index_t *index,
+    struct _buffer_index_node *node) {
+    struct _buffer_index_node **link =
+        &index->buckets[buffer_index_hash(index, node->entry->key)];
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    node->next = NULL;
+    *link = node;
+}
+
+static int buffer_index_grow(buffer_index_t *index) {
+    struct _buffer_index_node **old = index->buckets, *node, *next;
+    int i, size = 1 << index->bits;
+
+    if ((index->buckets = calloc(size * 2, sizeof(*old))) == NULL) {
+        index->buckets = old;
+        return -1;
+    }
+    index->bits++;
+    index->cursor = NULL;
+    for (i = 0; i < size; i++) {
+        for (node = old[i]; node != NULL; node = next) {
+            next = node->next;
+            buffer_index_append(index, node);
+        }
+    }
+    free(old);
+    return 0;
+}
+
+buffer_index_t *buffer_index_create(void) {
+    buffer_index_t *index = malloc(sizeof(buffer_index_t));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->bits = BUFFER_INDEX_BITS;
+    index->count = 0;
+    index->cursor = NULL;
+    if ((index->buckets = calloc(1 << index->bits,
+        sizeof(struct _buffer_index_node *))) == NULL) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void buffer_index_destroy(buffer_index_t *index) {
+    if (index == NULL) {
+        return;
+    }
+    buffer_index_clear(index);
+    free(index->buckets);
+    free(index);
+}
+
+void buffer_index_clear(buffer_index_t *index) {
+    struct _buffer_index_node *node, *next;
+    int i;
+
+    for (i = 0; i < (1 << index->bits); i++) {
+        for (node = index->buckets[i]; node != NULL; node = next) {
+            next = node->next;
+            free(node);
+        }
+        index->buckets[i] = NULL;
+    }
+    index->count = 0;
+    index->cursor = NULL;
+}
+
+/* entries are found newest first, like a das_traverse of the buffer */
+void buffer_index_insert(buffer_index_t *index, buffer_entry_t *entry) {
+    struct _buffer_index_node *node = malloc(sizeof(struct _buffer_index_node));
+    int hash;
+
+    if (node == NULL) {
+        fprintf(stderr, "[ERR] Couldn't allocate buffer index node\n");
+        return;
+    }
+    if (index->count >= 2 << index->bits) {
+        buffer_index_grow(index);
+    }
+    hash = buffer_index_hash(index, entry->key);
+    node->entry = entry;
+    node->next = index->buckets[hash];
+    index->buckets[hash] = node;
+    index->count++;
+}
+
+void buffer_index_remove(buffer_index_t *index, buffer_entry_t *entry) {
+    struct _buffer_index_node **link =
+        &index->buckets[buffer_index_hash(index, entry->key)], *node;
+
+    for (; (node = *link) != NULL; link = &node->next) {
+        if (node->entry == entry) {
+            if (index->cursor == node) {
+                index->cursor = NULL;
+            }
+            *link = node->next;
+            free(node);
+            index->count--;
+            return;
+        }
+    }
+}
+
+/* re-indexes a buffer handed back through set_buffer, in traversal order */
+void buffer_index_rebuild(buffer_index_t *index, void *buffer) {
+    struct _buffer_index_node *node;
+    buffer_entry_t *entry;
+
+    buffer_index_clear(index);
+    das_init_traverse(buffer);
+    while ((entry = (buffer_entry_t *) das_traverse(buffer)) != NULL) {
+        if ((node = malloc(sizeof(struct _buffer_index_node))) == NULL) {
+            fprintf(stderr, "[ERR] Couldn't allocate buffer index node\n");
+            return;
+        }
+        if (index->count >= 2 << index->bits) {
+            buffer_index_grow(index);
+        }
+        node->entry = entry;
+        buffer_index_append(index, node);
+        index->count++;
+    }
+}
+
+buffer_entry_t *buffer_index_find(buffer_index_t *index, uint64_t key,
+    buffer_entry_t *after) {
+    struct _buffer_index_node *node =
+        index->buckets[buffer_index_hash(index, key)];
+
+    /* a caller looping on its last result resumes from the cursor, so going
+     * through all the entries with a key costs one walk of the bucket */
+    if (after != NULL) {
+        if (index->cursor != NULL && index->cursor->entry == after) {
+            node = index->cursor;
+        } else {
+            for (; node != NULL && node->entry != after; node = node->next);
+            if (node == NULL) {
+                return NULL;
+            }
+        }
+        node = node->next;
+    }
+    for (; node != NULL; node = node->next) {
+        if (node->entry->key == key) {
+            index->cursor = node;
+            return node->entry;
+        }
+    }
+    return NULL;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int table_map(char *path, char *magic, int record_size, table_t *table) {
+    table_header_t *header;
+    struct stat st;
+    int fd;
+
+    table->map = NULL;
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size < (off_t) sizeof(table_header_t)) {
+        close(fd);
+        return 1;
+    }
+
+    table->length = st.st_size;
+    table->map = mmap(NULL, table->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (table->map == MAP_FAILED) {
+        table->map = NULL;
+        return -1;
+    }
+
+    header = (table_header_t *) table->map;
+    if (memcmp(header->magic, magic, TABLE_MAGIC_SIZE)) {
+        table_unmap(table);
+        return 1;
+    }
+    if ((header->record_size != record_size) || (header->count < 0)
+        || (sizeof(table_header_t) + (size_t) header->count * record_size
+            > table->length)) {
+        fprintf(stderr, "[ERR] Truncated or incompatible table %s\n", path);
+        table_unmap(table);
+        return -1;
+    }
+
+    table->records = (char *) table->map + sizeof(table_header_t);
+    table->count = header->count;
+    return 0;
+}
+
+void table_unmap(table_t *table) {
+    if (table->map == NULL) {
+        return;
+    }
+    if (table->length == 0) {
+        free(table->map);
+    } else {
+        munmap(table->map, table->length);
+    }
+    table->map = NULL;
+}
+
+int table_write(char *path, char *magic, int record_size, void *records,
+    int count) {
+    table_header_t header;
+    FILE *file;
+    int ok;
+
+    if ((file = fopen(path, "wb")) == NULL) {
+        return -1;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, TABLE_MAGIC_SIZE);
+    header.record_size = record_size;
+    header.count = count;
+    ok = (fwrite(&header, sizeof(header), 1, file) == 1)
+        && ((count == 0) || (fwrite(records, record_size, count, file)
+            == (size_t) count));
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    return ok ? 0 : -1;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static int node_valid(nodeid_t id, int node_cnt) {
+    return (id >= 0) && ((node_cnt < 0) || (id < node_cnt));
+}
+
+/* parse a text line into a record: 0 on success, 1 to skip the line, -1 on
+ * error */
+static int route_parse(char *line, void *record, int node_cnt) {
+    route_record_t *route = (route_record_t *) record;
+
+    if (sscanf(line, "%d %d %d\n", &route->node, &route->dst, &route->n_hop) != 3) {
+        return -1;
+    }
+    return 0;
+}
+
+static int position_parse(char *line, void *record, int node_cnt) {
+    position_record_t *position = (position_record_t *) record;
+
+    if (sscanf(line, "%d %lf %lf %lf\n", &position->id, &position->position.x,
+               &position->position.y, &position->position.z) != 4) {
+        return 1;
+    }
+    return node_valid(position->id, node_cnt) ? 0 : 1;
+}
+
+static int link_parse(char *line, void *record, int node_cnt) {
+    link_record_t *link = (link_record_t *) record;
+
+    if (sscanf(line, "%d %d %lf\n", &link->src, &link->dst, &link->success) != 3) {
+        return 1;
+    }
+    return (node_valid(link->src, node_cnt) && node_valid(link->dst, node_cnt)) ? 0 : 1;
+}
+
+static gint route_compare(gconstpointer l, gconstpointer r, gpointer data) {
+    route_record_t *a = (route_record_t *) l, *b = (route_record_t *) r;
+
+    if (a->node != b->node) {
+        return (a->node < b->node) ? -1 : 1;
+    }
+    if (a->dst != b->dst) {
+        return (a->dst < b->dst) ? -1 : 1;
+    }
+    return 0;
+}
+
+static gint position_compare(gconstpointer l, gconstpointer r, gpointer data) {
+    position_record_t *a = (position_record_t *) l, *b = (position_record_t *) r;
+
+    if (a->id != b->id) {
+        return (a->id < b->id) ? -1 : 1;
+    }
+    return 0;
+}
+
+static gint link_compare(gconstpointer l, gconstpointer r, gpointer data) {
+    link_record_t *a = (link_record_t *) l, *b = (link_record_t *) r;
+
+    if (a->src != b->src) {
+        return (a->src < b->src) ? -1 : 1;
+    }
+    if (a->dst != b->dst) {
+        return (a->dst < b->dst) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int route_equal(void *l, void *r) {
+    route_record_t *a = (route_record_t *) l, *b = (route_record_t *) r;
+    return (a->node == b->node) && (a->dst == b->dst) && (a->n_hop == b->n_hop);
+}
+
+static int position_equal(void *l, void *r) {
+    position_record_t *a = (position_record_t *) l, *b = (position_record_t *) r;
+    return (a->id == b->id) && (a->position.x == b->position.x)
+        && (a->position.y == b->position.y) && (a->position.z == b->position.z);
+}
+
+static int link_equal(void *l, void *r) {
+    link_record_t *a = (link_record_t *) l, *b = (link_record_t *) r;
+    return (a->src == b->src) && (a->dst == b->dst) && (a->success == b->success);
+}
+
+typedef struct _table_kind {
+    char *name;
+    char *magic;
+    int record_size;
+    int first_wins;     /* of duplicate text lines, the first one wins */
+    int (*parse)(char *line, void *record, int node_cnt);
+    GCompareDataFunc compare;
+    int (*equal)(void *l, void *r);
+} table_kind_t;
+
+static table_kind_t table_kinds[] = {
+    {"routes", ROUTE_TABLE_MAGIC, sizeof(route_record_t), 0,
+     route_parse, route_compare, route_equal},
+    {"positions", POSITION_TABLE_MAGIC, sizeof(position_record_t), 1,
+     position_parse, position_compare, position_equal},
+    {"links", LINK_TABLE_MAGIC, sizeof(link_record_t), 0,
+     link_parse, link_compare, link_equal}
+};
+
+/* parses the text form once, sorting the records and keeping the winner of
+ * the duplicates */
+static int table_read(char *path, table_kind_t *kind, int node_cnt, table_t *table) {
+    char *records = NULL, *tmp, *record, *last;
+    int count = 0, size = 0, line = 0, kept = 0, i, ok;
+    char str[128];
+    FILE *file;
+
+    if ((file = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "[ERR] Can not open table %s\n", path);
+        return -1;
+    }
+    while (fgets(str, 128, file) != NULL) {
+        line++;
+        if (count == size) {
+            size = size ? 2 * size : 1024;
+            if ((tmp = realloc(records, (size_t) size * kind->record_size)) == NULL) {
+                fprintf(stderr, "[ERR] Can not allocate table %s\n", path);
+                goto error;
+            }
+            records = tmp;
+        }
+        /* zeroed, so that padding is written as zeros by table_write */
+        record = records + (size_t) count * kind->record_size;
+        memset(record, 0, kind->record_size);
+        if ((ok = kind->parse(str, record, node_cnt)) < 0) {
+            fprintf(stderr, "[ERR] Unable to read line %d of table %s\n", line, path);
+            goto error;
+        }
+        if (ok == 0) {
+            count++;
+        }
+    }
+    fclose(file);
+    file = NULL;
+
+    if ((records == NULL) && ((records = malloc(kind->record_size)) == NULL)) {
+        fprintf(stderr, "[ERR] Can not allocate table %s\n", path);
+        goto error;
+    }
+
+    /* stable, duplicates stay in file order */
+    g_qsort_with_data(records, count, kind->record_size, kind->compare, NULL);
+    for (i = 0; i < count; i++) {
+        record = records + (size_t) i * kind->record_size;
+        if (kept > 0) {
+            last = records + (size_t) (kept - 1) * kind->record_size;
+            if (!kind->compare(last, record, NULL)) {
+                if (!kind->first_wins) {
+                    memcpy(last, record, kind->record_size);
+                }
+                continue;
+            }
+        }
+        if (kept != i) {
+            memcpy(records + (size_t) kept * kind->record_size, record, kind->record_size);
+        }
+        kept++;
+    }
+
+    table->records = records;
+    table->count = kept;
+    table->map = records;
+    table->length = 0;
+    return 0;
+
+ error:
+    if (file != NULL) {
+        fclose(file);
+    }
+    free(records);
+    return -1;
+}
+
+static int table_kind_load(char *path, table_kind_t *kind, int node_cnt, table_t *table) {
+    char *records;
+    int i;
+
+    switch (table_map(path, kind->magic, kind->record_size, table)) {
+    case 0:
+        break;
+    case 1:
+        return table_read(path, kind, node_cnt, table);
+    default:
+        fprintf(stderr, "[ERR] Can not open table %s\n", path);
+        return -1;
+    }
+
+    /* the binary form must already be sorted without duplicates */
+    records = (char *) table->records;
+    for (i = 1; i < table->count; i++) {
+        if (kind->compare(records + (size_t) (i - 1) * kind->record_size,
+                          records + (size_t) i * kind->record_size, NULL) >= 0) {
+            fprintf(stderr, "[ERR] %s of table %s are not sorted\n", kind->name, path);
+            table_unmap(table);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int table_load(char *path, int kind, int node_cnt, table_t *table) {
+    return table_kind_load(path, &table_kinds[kind], node_cnt, table);
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static table_kind_t *table_kind_get(char *name) {
+    int i;
+
+    for (i = 0; i < (int) (sizeof(table_kinds) / sizeof(table_kind_t)); i++) {
+        if (!strcmp(table_kinds[i].name, name)) {
+            return &table_kinds[i];
+        }
+    }
+    fprintf(stderr, "[ERR] Unknown table kind %s (routes, positions or links)\n", name);
+    return NULL;
+}
+
+int do_table_compilation(char *name, char *path, char *outfile) {
+    table_kind_t *kind;
+    table_t table;
+    int ok;
+
+    if ((kind = table_kind_get(name)) == NULL) {
+        return -1;
+    }
+    if (table_kind_load(path, kind, -1, &table)) {
+        return -1;
+    }
+
+    ok = table_write(outfile, kind->magic, kind->record_size, table.records, table.count);
+    if (ok) {
+        fprintf(stderr, "[ERR] Unable to write table %s\n", outfile);
+    } else {
+        fprintf(stderr, "\nCompiled %s into %s (%d %s)\n", path, outfile, table.count, kind->name);
+    }
+
+    table_unmap(&table);
+    return ok;
+}
+
+int do_table_check(char *name, char *path, char *tablefile) {
+    table_kind_t *kind;
+    table_t text, binary;
+    int ok = 0, i;
+
+    if ((kind = table_kind_get(name)) == NULL) {
+        return -1;
+    }
+    if (table_kind_load(path, kind, -1, &text)) {
+        return -1;
+    }
+    if (table_kind_load(tablefile, kind, -1, &binary)) {
+        table_unmap(&text);
+        return -1;
+    }
+
+    if (binary.length == 0) {
+        fprintf(stderr, "[ERR] %s is not a binary table of %s\n", tablefile, kind->name);
+        ok = -1;
+    } else if (text.count != binary.count) {
+        fprintf(stderr, "[ERR] %s has %d %s, %s has %d\n", path, text.count, kind->name,
+                tablefile, binary.count);
+        ok = -1;
+    } else {
+        for (i = 0; i < text.count; i++) {
+            if (!kind->equal((char *) text.records + (size_t) i * kind->record_size,
+                             (char *) binary.records + (size_t) i * kind->record_size)) {
+                fprintf(stderr, "[ERR] %s and %s differ at record %d\n", path, tablefile, i);
+                ok = -1;
+                break;
+            }
+        }
+    }
+    if (ok == 0) {
+        fprintf(stderr, "\n%s and %s hold the same %d %s\n", path, tablefile, text.count, kind->name);
+    }
+
+    table_unmap(&text);
+    table_unmap(&binary);
+    return ok;
+}
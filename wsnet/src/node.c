@@ -10,6 +10,8 @@
 /* ************************************************** */
 /* ************************************************** */
 node_array_t nodes = {0, NULL};
+node_chain_t *node_chains = NULL;
+static uint64_t topology_version = 0;
 #ifdef N_DAS_O
 void *location = NULL;
 #endif /* N_DAS_O */
@@ -45,6 +47,7 @@ void node_clean(void) {
         }
         
         free(nodes.elts);
+        free(node_chains);
     }
 
 #ifdef N_DAS_O
@@ -112,6 +115,7 @@ int nodes_create(void) {
     location = spadas_create(get_topology_area(), get_topology_range());
 #endif /*N_DAS_O*/
     nodes.elts = (node_t *) malloc(sizeof(node_t) * nodes.size);
+    node_chains = (node_chain_t *) malloc(sizeof(node_chain_t) * nodes.size);
     
     while (i--) {
         node_t *node = get_node_by_id(i);
@@ -149,6 +153,7 @@ void node_birth(nodeid_t id) {
     
     /* set node active */
     node->state = NODE_ACTIVE;
+    topology_version++;
 #ifdef N_DAS_O
     spadas_insert(location, node, &(node->position));
 #endif /* N_DAS_O */
@@ -163,6 +168,7 @@ void node_kill(nodeid_t id) {
     }
     
     node->state = NODE_DEAD;
+    topology_version++;
 #ifdef N_DAS_O
     spadas_delete(location, node, &(node->position));
 #endif /* N_DAS_O */
@@ -212,23 +218,23 @@ void nodes_update_mobility(void) {
         bundle_t *bundle = get_bundle_by_id(node->bundle);
         entity_t *entity = get_entity_by_id(bundle->mobility);
         call_t call = {entity->id, node->id, -1};
-
-#ifdef N_DAS_O 
         position_t o_position;
-#endif /* N_DAS_0 */
         
         if ((node->state == NODE_DEAD) || (node->state == NODE_UNDEF)) {
             continue;
         }
         
-#ifdef N_DAS_O 
         o_position.x = node->position.x;
         o_position.y = node->position.y;
         o_position.z = node->position.z;
-#endif /* N_DAS_0 */
         
         entity->methods->mobility.update_position(&call);
         
+        if ((node->position.x != o_position.x) || (node->position.y != o_position.y) 
+            || (node->position.z != o_position.z)) {
+            topology_version++;
+        }
+        
 #ifdef N_DAS_O 
         spadas_update(location, node, &node->position, &o_position);
 #endif /* N_DAS_0 */
@@ -257,3 +263,7 @@ double distance(position_t *position0, position_t *position1) {
 int get_node_count(void) {
     return nodes.size;
 }
+
+uint64_t get_topology_version(void) {
+    return topology_version;
+}
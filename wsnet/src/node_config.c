@@ -10,14 +10,11 @@
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_nodes(xmlNodeSetPtr nodeset) {
+int parse_nodes(scenario_t *sc) {
     int i, j;
     int worldsens = 0;
-    int count = (nodeset) ? nodeset->nodeNr : 0;
-    xmlAttrPtr attr;
-    xmlNodePtr nd1;
-    xmlNodePtr nd2;
-    param_t *param;
+    int count = SC_ROOT(sc)->nodes.count;
+    sc_node_t *sc_node = SC_LIST(sc, SC_ROOT(sc)->nodes, sc_node_t);
     int birth_spcfd[nodes.size];
     
     /* create nodes */
@@ -38,63 +35,21 @@ int parse_nodes(xmlNodeSetPtr nodeset) {
 
     /* for all node definitions, eventually overide bundle */
     for (i = 0; i < count; i++) {
-        char *as = NULL;
-        nodeid_t nodeid = -1;
+        node_t *node = get_node_by_id(sc_node[i].id);
+        sc_default_t *dflt = SC_LIST(sc, sc_node[i].fors, sc_default_t);
 
-        nd1 = nodeset->nodeTab[i];
-        for (attr = nd1->properties; attr; attr = attr->next) {
-            if (!strcmp((char *) attr->name, XML_A_ID)) {
-                nodeid = strtoll((char *) attr->children->content, NULL, 10);
-            } else if (!strcmp((char *) attr->name, XML_A_AS)) {
-                as = (char *) attr->children->content;
-            } else if (!strcmp((char *) attr->name, XML_A_BIRTH)) {
-                node_t *node = get_node_by_id(nodeid);
-                birth_spcfd[nodeid] = 1;
-                get_param_time((char *) attr->children->content, &(node->birth));
-            }
-            
-            if ((as != NULL) && (nodeid != -1)) {
-                node_t *node = get_node_by_id(nodeid);
-                bundle_t *bundle = get_bundle_by_name(as);
-                node->bundle = bundle->id;
-            }
+        if (sc_node[i].bundle != SCENARIO_NONE) {
+            node->bundle = sc_node[i].bundle;
+        }
+        if (sc_node[i].birth != SCENARIO_NONE) {
+            birth_spcfd[node->id] = 1;
+            get_param_time(SC_STRING(sc, sc_node[i].birth), &(node->birth));
         }
 
         /* get entity parameters */
-        for (nd2 = nd1->children; nd2; nd2 = nd2->next) {
-            node_t *node = get_node_by_id(nodeid);
-
-            if ((nd2->type == XML_ELEMENT_NODE) &&
-                (!strcmp((char *)nd2->name, XML_E_FOR))) {
-                dflt_param_t *dflt_param;
-                
-                if ((dflt_param = (dflt_param_t *) malloc(sizeof(dflt_param_t))) == NULL) {
-                    fprintf(stderr, "config: malloc error (parse_nodes())\n");
-                    return -1;
-                }
-                dflt_param->entityid = -1;
-                dflt_param->bundleid = node->bundle;
-                dflt_param->nodeid = node->id;
-                if ((dflt_param->params = das_create()) == NULL) {
-                    return -1;
-                }
-                
-                /* retrieve entity */
-                for (attr = nd2->properties ; attr ; attr = attr->next) {
-                    if (!strcmp((gchar *) attr->name, XML_A_ENTITY)) {
-                        entity_t *entity = get_entity_by_name((char *) attr->children->content);
-                        dflt_param->entityid = entity->id;
-                    } else {
-                        if ((param = (param_t *) malloc(sizeof(param_t))) == NULL) {
-                            fprintf(stderr, "config: malloc error (parse_nodes())\n");
-                            return -1;
-                        }
-                        param->key = (char *) attr->name;
-                        param->value = (char *) attr->children->content;
-                        das_insert(dflt_param->params, param);
-                    }
-                }
-                das_insert(dflt_params, dflt_param);
+        for (j = 0; j < sc_node[i].fors.count; j++) {
+            if (add_dflt_params(sc, &dflt[j], node->bundle, node->id)) {
+                return -1;
             }
         }
     }
@@ -110,6 +65,8 @@ int parse_nodes(xmlNodeSetPtr nodeset) {
             fprintf(stderr, "config: malloc error (parse_nodes())\n");
             return -1;
         }
+        node_chains[i].chain = bundle->chain;
+        node_chains[i].private = node->private;
 
         /* for all entities, call setnode */
         for (j  = 0; j < bundle->entity.size; j++) {
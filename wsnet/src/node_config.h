@@ -12,7 +12,7 @@
 
 /* ************************************************** */
 /* ************************************************** */
-int parse_nodes(xmlNodeSetPtr nodeset);
+int parse_nodes(scenario_t *sc);
 
 
 #endif //__node_config__
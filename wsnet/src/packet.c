@@ -9,6 +9,13 @@
 
 /* ************************************************** */
 /* ************************************************** */
+/* packets whose data fits a size class are allocated together with their
+ * data, which sits right after the packet_t; larger ones take a packet_t
+ * from mem_packet and a separate data buffer */
+#define PACKET_SLABS 3
+static const int slab_size[PACKET_SLABS] = {64, 128, 256};
+static void *mem_slab[PACKET_SLABS];
+
 static void *mem_packet = NULL;
 #if (SNR_STEP > 0)
 static void *mem_snr = NULL;
@@ -19,9 +26,16 @@ static packetid_t id = 0;
 /* ************************************************** */
 /* ************************************************** */
 int packet_init(void) {
+    int i;
+
     if ((mem_packet = mem_fs_slice_declare(sizeof(packet_t))) == NULL) {
         return -1;
     }
+    for (i = 0; i < PACKET_SLABS; i++) {
+        if ((mem_slab[i] = mem_fs_slice_declare(sizeof(packet_t) + slab_size[i])) == NULL) {
+            return -1;
+        }
+    }
 #if (SNR_STEP > 0)
     if ((mem_snr = mem_fs_slice_declare(sizeof(double) * SNR_STEP)) == NULL) {
         return -1;
@@ -41,13 +55,38 @@ void packet_clean(void) {
 
 /* ************************************************** */
 /* ************************************************** */
+static packet_t *packet_new(int size) {
+    packet_t *packet;
+    int slab = 0;
+
+    while ((slab < PACKET_SLABS) && (size > slab_size[slab])) {
+        slab++;
+    }
+
+    if (slab < PACKET_SLABS) {
+        packet = (packet_t *) mem_fs_alloc(mem_slab[slab]);
+        packet->data = (char *) (packet + 1);
+        packet->slab = slab;
+    } else {
+        packet = (packet_t *) mem_fs_alloc(mem_packet);
+        packet->data = (char *) malloc(size);
+        packet->slab = -1;
+    }
+    return packet;
+}
+
+static void packet_free(packet_t *packet) {
+    if (packet->data != (char *) (packet + 1)) {
+        free(packet->data);
+    }
+    mem_fs_dealloc((packet->slab < 0) ? mem_packet : mem_slab[packet->slab], packet);
+}
 
 /* edit by Quentin Lampin <quentin.lampin@orange-ftgroup.com> */
 packet_t *packet_create(call_t *c, int size, int real_size) {
     packet_t *packet;
  
-    packet = (packet_t *) mem_fs_alloc(mem_packet);
-    packet->data = (char *) malloc(size);
+    packet = packet_new(size);
     memset(packet->data, 0, size);
     packet->noise_mW = NULL;
     packet->ber = NULL;   
@@ -79,20 +118,54 @@ void packet_dealloc(packet_t *packet) {
         free(packet->ber);
 #endif /*SNR_STEP*/
     }
-    free(packet->data);
-    mem_fs_dealloc(mem_packet, packet);
+    packet_free(packet);
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int packet_resize(packet_t *packet, int size) {
+    int inline_data = (packet->data == (char *) (packet + 1));
+    char *data;
+
+    /* still fits the inline buffer */
+    if (inline_data && (size <= slab_size[packet->slab])) {
+        packet->size = size;
+        return 0;
+    }
+
+    if (inline_data) {
+        if ((data = (char *) malloc(size)) == NULL) {
+            return -1;
+        }
+        memcpy(data, packet->data, (size < packet->size) ? size : packet->size);
+    } else if ((data = (char *) realloc(packet->data, size)) == NULL) {
+        return -1;
+    }
+    packet->data = data;
+    packet->size = size;
+    return 0;
 }
 
 
 /* ************************************************** */
 /* ************************************************** */
+/* copy packet into packet0, keeping the allocation of packet0 */
+static void packet_copy(packet_t *packet0, packet_t *packet) {
+    char *data = packet0->data;
+    int slab = packet0->slab;
+
+    memcpy(packet0, packet, sizeof(packet_t));
+    packet0->data = data;
+    packet0->slab = slab;
+    memcpy(packet0->data, packet->data, packet->size);
+}
+
 packet_t *packet_clone(packet_t *packet) {
     packet_t *packet0;
 
-    packet0 = (packet_t *) mem_fs_alloc(mem_packet);
-    memcpy(packet0, packet, sizeof(packet_t));
-    packet0->data = malloc(packet->size);
-    memcpy(packet0->data, packet->data, packet->size);    
+    packet0 = packet_new(packet->size);
+    packet_copy(packet0, packet);
     packet0->noise_mW = NULL;
     packet0->ber = NULL;
     
@@ -103,10 +176,8 @@ packet_t *packet_clone(packet_t *packet) {
 packet_t *packet_rxclone(packet_t *packet) {
     packet_t *packet0;
 
-    packet0 = (packet_t *) mem_fs_alloc(mem_packet);
-    memcpy(packet0, packet, sizeof(packet_t));
-    packet0->data = malloc(packet->size);
-    memcpy(packet0->data, packet->data, packet->size);    
+    packet0 = packet_new(packet->size);
+    packet_copy(packet0, packet);
 #if (SNR_STEP > 0)
     packet0->noise_mW = (double *) mem_fs_alloc(mem_snr);
     packet0->ber = (double *) mem_fs_alloc(mem_snr);
@@ -33,6 +33,9 @@ int rng_equal(void *key0, void *key1) {
 int default_rng_type = DEFAULT_RNG;
 unsigned long int default_rng_seed = 0;
 
+/* seed of the default RNG, also the seed of the streams */
+static uint64_t stream_seed = 0;
+
 int rng_retry_attempts = -1;
 
 /**
@@ -139,6 +142,7 @@ int rng_init(void) {
     }
     rngs = hadas_create(rng_hash, rng_equal);
     create_rng(default_rng_type, default_rng_seed);
+    stream_seed = ((rng_t *) hadas_get(rngs, (void *) DEFAULT_RNG))->seed;
     return 0;
 }
 
@@ -218,6 +222,221 @@ void destroy_rng(void *rng_id) {
     gsl_rng_free(rng->r);
     hadas_delete(rngs, rng_id);
 }
+/******************************************************************************/
+/******************************************************************************/
+
+/**
+ * Philox4x32-10, from "Parallel random numbers: as easy as 1, 2, 3",
+ * Salmon et al., SC'11: ten rounds of two 32x32->64 multiplications that
+ * turn (key, counter) into 128 random bits.
+ **/
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+static void philox4x32_10(uint32_t key[2], uint32_t counter[4], uint32_t out[4]) {
+    uint32_t k0 = key[0], k1 = key[1];
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+void rng_stream_init(rng_stream_t *stream, call_t *c, uint32_t purpose) {
+    rng_stream_init_with(stream, stream_seed, c->node, c->entity, purpose);
+}
+
+void rng_stream_init_with(rng_stream_t *stream, uint64_t seed, nodeid_t node, entityid_t entity, uint32_t purpose) {
+    stream->key[0] = (uint32_t) seed;
+    stream->key[1] = (uint32_t) (seed >> 32);
+    stream->counter[0] = 0;
+    stream->counter[1] = (uint32_t) node;
+    stream->counter[2] = (uint32_t) entity;
+    stream->counter[3] = purpose;
+    stream->used = 4;
+}
+
+void rng_stream_seek(rng_stream_t *stream, uint64_t index) {
+    stream->counter[0] = (uint32_t) (index / 4);
+    stream->used = 4;
+    if (index % 4) {
+        philox4x32_10(stream->key, stream->counter, stream->block);
+        stream->counter[0]++;
+        stream->used = (int) (index % 4);
+    }
+}
+
+uint32_t rng_stream_uint32(rng_stream_t *stream) {
+    if (stream->used == 4) {
+        philox4x32_10(stream->key, stream->counter, stream->block);
+        stream->counter[0]++;
+        stream->used = 0;
+    }
+    return stream->block[stream->used++];
+}
+
+double rng_stream_double(rng_stream_t *stream) {
+    /* 53 bits */
+    uint64_t a = rng_stream_uint32(stream) >> 5;
+    uint64_t b = rng_stream_uint32(stream) >> 6;
+    return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+}
+
+double rng_stream_double_range(rng_stream_t *stream, double min, double max) {
+    return min + (max - min) * rng_stream_double(stream);
+}
+
+int rng_stream_integer_range(rng_stream_t *stream, int min, int max) {
+    uint32_t range = (uint32_t) ((int64_t) max - min) + 1;
+    uint32_t threshold;
+    uint64_t m;
+
+    if (range == 0) {
+        /* [INT_MIN,INT_MAX] */
+        return (int) rng_stream_uint32(stream);
+    }
+
+    /* multiply and shift, rejecting the low values that would bias it */
+    threshold = (uint32_t) (-range) % range;
+    do {
+        m = (uint64_t) rng_stream_uint32(stream) * range;
+    } while ((uint32_t) m < threshold);
+
+    return (int) ((int64_t) min + (int64_t) (m >> 32));
+}
+
+uint64_t rng_stream_time_range(rng_stream_t *stream, uint64_t min, uint64_t max) {
+    uint64_t result = min + (uint64_t) (rng_stream_double(stream) * (double) (max - min + 1));
+    return (result > max) ? max : result;
+}
+
+/* uniforms of a batch, drawn before the transforms */
+#define RNG_BATCH 64
+
+void rng_stream_normals(rng_stream_t *stream, double *out, int k) {
+    double u0[RNG_BATCH], u1[RNG_BATCH], r[RNG_BATCH], t[RNG_BATCH];
+    int i, n;
+
+    while (k > 0) {
+        n = (k + 1) / 2;
+        if (n > RNG_BATCH) {
+            n = RNG_BATCH;
+        }
+
+        /* u0 in ]0,1] for the log */
+        for (i = 0; i < n; i++) {
+            u0[i] = 1.0 - rng_stream_double(stream);
+            u1[i] = rng_stream_double(stream);
+        }
+        for (i = 0; i < n; i++) {
+            r[i] = sqrt(-2.0 * log(u0[i]));
+            t[i] = 2.0 * M_PI * u1[i];
+        }
+
+        for (i = 0; (i < n) && (2 * i + 1 < k); i++) {
+            out[2 * i]     = r[i] * cos(t[i]);
+            out[2 * i + 1] = r[i] * sin(t[i]);
+        }
+        if (i < n) {
+            /* k odd, last pair */
+            out[2 * i] = r[i] * cos(t[i]);
+            return;
+        }
+
+        out += 2 * n;
+        k -= 2 * n;
+    }
+}
+
+void rng_stream_exponentials(rng_stream_t *stream, double *out, int k) {
+    int i;
+
+    /* u in ]0,1] for the log */
+    for (i = 0; i < k; i++) {
+        out[i] = 1.0 - rng_stream_double(stream);
+    }
+    for (i = 0; i < k; i++) {
+        out[i] = -log(out[i]);
+    }
+}
+
+void rng_sampler_init(rng_sampler_t *sampler, call_t *c, uint32_t purpose) {
+    rng_stream_init(&sampler->stream, c, purpose);
+    sampler->normals = 0;
+    sampler->exponentials = 0;
+}
+
+rng_sampler_t *rng_node_samplers_create(call_t *c, uint32_t purpose) {
+    int i, count = get_node_count();
+    rng_sampler_t *samplers;
+
+    if ((samplers = (rng_sampler_t *) malloc(sizeof(rng_sampler_t) * (count > 0 ? count : 1))) == NULL) {
+        fprintf(stderr, "rng: malloc error (rng_node_samplers_create())\n");
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        call_t c0 = {c->entity, i, -1};
+        rng_sampler_init(samplers + i, &c0, purpose);
+    }
+    return samplers;
+}
+
+double rng_sampler_normal(rng_sampler_t *sampler) {
+    if (sampler->normals == 0) {
+        rng_stream_normals(&sampler->stream, sampler->normal, RNG_SAMPLER_SIZE);
+        sampler->normals = RNG_SAMPLER_SIZE;
+    }
+    return sampler->normal[RNG_SAMPLER_SIZE - sampler->normals--];
+}
+
+double rng_sampler_exponential(rng_sampler_t *sampler) {
+    if (sampler->exponentials == 0) {
+        rng_stream_exponentials(&sampler->stream, sampler->exponential, RNG_SAMPLER_SIZE);
+        sampler->exponentials = RNG_SAMPLER_SIZE;
+    }
+    return sampler->exponential[RNG_SAMPLER_SIZE - sampler->exponentials--];
+}
+
+/* buffered values first, then whole batches straight into out */
+void rng_sampler_normals(rng_sampler_t *sampler, double *out, int k) {
+    int n = (k < sampler->normals) ? k : sampler->normals;
+
+    memcpy(out, sampler->normal + RNG_SAMPLER_SIZE - sampler->normals, n * sizeof(double));
+    sampler->normals -= n;
+    if (k > n) {
+        rng_stream_normals(&sampler->stream, out + n, k - n);
+    }
+}
+
+void rng_sampler_exponentials(rng_sampler_t *sampler, double *out, int k) {
+    int n = (k < sampler->exponentials) ? k : sampler->exponentials;
+
+    memcpy(out, sampler->exponential + RNG_SAMPLER_SIZE - sampler->exponentials, n * sizeof(double));
+    sampler->exponentials -= n;
+    if (k > n) {
+        rng_stream_exponentials(&sampler->stream, out + n, k - n);
+    }
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
 /**
  * get a random distance following the specified distribution and parameters
  **/
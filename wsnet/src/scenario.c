@@ -0,0 +1,259 @@
+/**
+ *  \file   scenario.c
+ *  \brief  Compiled scenario module
+ *  \date   2026
+ **/
+#include "internals.h"
+#include "scenario.h"
+
+
+/* ************************************************** */
+/* ************************************************** */
+#define SCENARIO_ALIGN(size) (((size) + 7) & ~7)
+
+
+/* ************************************************** */
+/* ************************************************** */
+int scenario_create(scenario_t *sc) {
+    sc->base = NULL;
+    sc->size = 0;
+    sc->capacity = 0;
+    sc->table.map = NULL;
+
+    if (scenario_alloc(sc, sizeof(sc_root_t)) != 0) {
+        return -1;
+    }
+
+    SC_ROOT(sc)->node_count = SCENARIO_NONE;
+    SC_ROOT(sc)->duration = SCENARIO_NONE;
+    SC_ROOT(sc)->x = SCENARIO_NONE;
+    SC_ROOT(sc)->y = SCENARIO_NONE;
+    SC_ROOT(sc)->z = SCENARIO_NONE;
+    SC_ROOT(sc)->monitoring = SCENARIO_NONE;
+    SC_ROOT(sc)->propagation = SCENARIO_NONE;
+    SC_ROOT(sc)->range = SCENARIO_NONE;
+    SC_ROOT(sc)->interferences = SCENARIO_NONE;
+    SC_ROOT(sc)->noise = SCENARIO_NONE;
+    return 0;
+}
+
+int32_t scenario_alloc(scenario_t *sc, int size) {
+    int32_t offset = sc->size;
+    int needed = sc->size + SCENARIO_ALIGN(size);
+
+    if (needed > sc->capacity) {
+        int capacity = sc->capacity ? sc->capacity : 4096;
+        char *base;
+
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        if ((base = (char *) realloc(sc->base, capacity)) == NULL) {
+            fprintf(stderr, "scenario: malloc error (scenario_alloc())\n");
+            return -1;
+        }
+        sc->base = base;
+        sc->capacity = capacity;
+    }
+
+    memset(sc->base + offset, 0, needed - offset);
+    sc->size = needed;
+    return offset;
+}
+
+int32_t scenario_string(scenario_t *sc, char *str) {
+    int32_t offset;
+
+    if ((offset = scenario_alloc(sc, strlen(str) + 1)) == -1) {
+        return -1;
+    }
+    strcpy(sc->base + offset, str);
+    return offset;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+static int check_string(scenario_t *sc, int32_t offset) {
+    return (offset == SCENARIO_NONE)
+        || ((offset >= (int32_t) sizeof(sc_root_t)) && (offset < sc->size));
+}
+
+static int check_list(scenario_t *sc, sc_list_t *list, int size) {
+    return (list->count == 0)
+        || ((list->count > 0) && (list->offset >= (int32_t) sizeof(sc_root_t))
+            && (list->offset % 8 == 0)
+            && ((int64_t) list->offset + (int64_t) list->count * size <= sc->size));
+}
+
+static int check_id(int32_t id, int32_t count) {
+    return (id == SCENARIO_NONE) || ((id >= 0) && (id < count));
+}
+
+static int check_ids(scenario_t *sc, sc_list_t *list, int32_t count) {
+    int32_t *ids = SC_LIST(sc, *list, int32_t);
+    int i;
+
+    if (!check_list(sc, list, sizeof(int32_t))) {
+        return 0;
+    }
+    for (i = 0; i < list->count; i++) {
+        if ((ids[i] < 0) || (ids[i] >= count)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_params(scenario_t *sc, sc_list_t *list) {
+    sc_param_t *params = SC_LIST(sc, *list, sc_param_t);
+    int i;
+
+    if (!check_list(sc, list, sizeof(sc_param_t))) {
+        return 0;
+    }
+    for (i = 0; i < list->count; i++) {
+        if ((params[i].key == SCENARIO_NONE) || !check_string(sc, params[i].key)
+            || (params[i].value == SCENARIO_NONE) || !check_string(sc, params[i].value)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_defaults(scenario_t *sc, sc_list_t *list, int32_t entity_cnt) {
+    sc_default_t *defaults = SC_LIST(sc, *list, sc_default_t);
+    int i;
+
+    if (!check_list(sc, list, sizeof(sc_default_t))) {
+        return 0;
+    }
+    for (i = 0; i < list->count; i++) {
+        if (!check_id(defaults[i].entity, entity_cnt)
+            || !check_params(sc, &defaults[i].params)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* a mapped scenario is only trusted once every offset and id it holds has
+ * been checked */
+static int scenario_check(scenario_t *sc) {
+    sc_root_t *root = SC_ROOT(sc);
+    sc_entity_t *entity;
+    sc_bundle_t *bundle;
+    sc_member_t *member;
+    sc_node_t *node;
+    int32_t entity_cnt, bundle_cnt, node_cnt;
+    int i, j;
+
+    if ((sc->size < (int) sizeof(sc_root_t)) || (sc->base[sc->size - 1] != '\0')) {
+        return -1;
+    }
+
+    /* simulation & environment */
+    if ((root->node_count == SCENARIO_NONE) || !check_string(sc, root->node_count)
+        || !check_string(sc, root->duration) || !check_string(sc, root->x)
+        || !check_string(sc, root->y) || !check_string(sc, root->z)
+        || !check_string(sc, root->range)
+        || !check_list(sc, &root->entities, sizeof(sc_entity_t))
+        || !check_list(sc, &root->bundles, sizeof(sc_bundle_t))
+        || !check_list(sc, &root->nodes, sizeof(sc_node_t))) {
+        return -1;
+    }
+    entity_cnt = root->entities.count;
+    bundle_cnt = root->bundles.count;
+    node_cnt = strtoll(SC_STRING(sc, root->node_count), NULL, 10);
+    if (!check_ids(sc, &root->with, entity_cnt)
+        || !check_ids(sc, &root->modulation, entity_cnt)
+        || !check_id(root->monitoring, entity_cnt)
+        || !check_id(root->propagation, entity_cnt)
+        || !check_id(root->interferences, entity_cnt)
+        || !check_id(root->noise, entity_cnt)) {
+        return -1;
+    }
+
+    /* entities */
+    entity = SC_LIST(sc, root->entities, sc_entity_t);
+    for (i = 0; i < entity_cnt; i++) {
+        if ((entity[i].name == SCENARIO_NONE) || !check_string(sc, entity[i].name)
+            || (entity[i].library == SCENARIO_NONE) || !check_string(sc, entity[i].library)
+            || !check_params(sc, &entity[i].init)
+            || !check_defaults(sc, &entity[i].defaults, entity_cnt)) {
+            return -1;
+        }
+    }
+
+    /* bundles */
+    bundle = SC_LIST(sc, root->bundles, sc_bundle_t);
+    for (i = 0; i < bundle_cnt; i++) {
+        if ((bundle[i].name == SCENARIO_NONE) || !check_string(sc, bundle[i].name)
+            || !check_string(sc, bundle[i].birth)
+            || !check_list(sc, &bundle[i].members, sizeof(sc_member_t))) {
+            return -1;
+        }
+        member = SC_LIST(sc, bundle[i].members, sc_member_t);
+        for (j = 0; j < bundle[i].members.count; j++) {
+            if ((member[j].entity < 0) || (member[j].entity >= entity_cnt)
+                || !check_ids(sc, &member[j].up, entity_cnt)
+                || !check_ids(sc, &member[j].down, entity_cnt)
+                || !check_defaults(sc, &member[j].defaults, entity_cnt)) {
+                return -1;
+            }
+        }
+    }
+
+    /* nodes */
+    node = SC_LIST(sc, root->nodes, sc_node_t);
+    for (i = 0; i < root->nodes.count; i++) {
+        if ((node[i].id < 0) || (node[i].id >= node_cnt)
+            || !check_id(node[i].bundle, bundle_cnt)
+            || !check_string(sc, node[i].birth)
+            || !check_defaults(sc, &node[i].fors, entity_cnt)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/* ************************************************** */
+/* ************************************************** */
+int scenario_map(scenario_t *sc, char *file) {
+    int ok;
+
+    sc->capacity = 0;
+    if ((ok = table_map(file, SCENARIO_MAGIC, 1, &sc->table)) != 0) {
+        return ok;
+    }
+    sc->base = (char *) sc->table.records;
+    sc->size = sc->table.count;
+
+    if (scenario_check(sc)) {
+        fprintf(stderr, "scenario: %s is corrupted (scenario_map())\n", file);
+        table_unmap(&sc->table);
+        return -1;
+    }
+    return 0;
+}
+
+int scenario_write(scenario_t *sc, char *file) {
+    if (table_write(file, SCENARIO_MAGIC, 1, sc->base, sc->size)) {
+        fprintf(stderr, "scenario: unable to write %s (scenario_write())\n", file);
+        return -1;
+    }
+    return 0;
+}
+
+void scenario_clean(scenario_t *sc) {
+    if (sc->capacity) {
+        free(sc->base);
+    } else {
+        table_unmap(&sc->table);
+    }
+    sc->base = NULL;
+    sc->size = 0;
+    sc->capacity = 0;
+}
@@ -0,0 +1,146 @@
+/**
+ *  \file   scenario.h
+ *  \brief  Compiled scenario declarations
+ *  \date   2026
+ **/
+#ifndef __scenario__
+#define __scenario__
+
+#include <include/modelutils.h>
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* A scenario is what the configuration file describes (simulation,
+ * entities, environment, bundles and nodes), with entity and bundle names
+ * already resolved to ids. It is one position independent block: strings
+ * and lists are offsets from the start of the block, so the block built
+ * from the XML file can be written as is and mapped back by a later run
+ * (wsnet --compile), without libxml2, schema validation or XPath. */
+#define SCENARIO_MAGIC  "WSNETSC1"
+#define SCENARIO_NONE   -1       /* no string, no entity, no bundle */
+
+
+/* ************************************************** */
+/* ************************************************** */
+typedef struct _sc_list {
+    int32_t count;
+    int32_t offset;              /* of the first of count records */
+} sc_list_t;
+
+typedef struct _sc_param {
+    int32_t key;                 /* strings */
+    int32_t value;
+} sc_param_t;
+
+/* parameters of an entity, for a bundle and/or a node */
+typedef struct _sc_default {
+    int32_t entity;
+    sc_list_t params;            /* sc_param_t */
+} sc_default_t;
+
+typedef struct _sc_entity {
+    int32_t name;
+    int32_t library;
+    sc_list_t init;              /* sc_param_t */
+    sc_list_t defaults;          /* sc_default_t */
+} sc_entity_t;
+
+typedef struct _sc_member {
+    int32_t entity;
+    sc_list_t up;                /* int32_t entity ids */
+    sc_list_t down;              /* int32_t entity ids */
+    sc_list_t defaults;          /* sc_default_t */
+} sc_member_t;
+
+typedef struct _sc_bundle {
+    int32_t name;
+    int32_t birth;
+    int32_t worldsens;
+    int32_t dflt;
+    sc_list_t members;           /* sc_member_t */
+} sc_bundle_t;
+
+typedef struct _sc_node {
+    int32_t id;
+    int32_t bundle;              /* bundle given with 'as', if any */
+    int32_t birth;
+    sc_list_t fors;              /* sc_default_t */
+} sc_node_t;
+
+typedef struct _sc_root {
+    /* simulation, attribute strings */
+    int32_t node_count;
+    int32_t duration;
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    /* environment, entity ids */
+    sc_list_t with;              /* int32_t */
+    sc_list_t modulation;        /* int32_t */
+    int32_t monitoring;
+    int32_t propagation;
+    int32_t range;               /* string */
+    int32_t interferences;
+    int32_t noise;
+    /* entities, bundles, nodes */
+    sc_list_t entities;          /* sc_entity_t */
+    sc_list_t bundles;           /* sc_bundle_t */
+    sc_list_t nodes;             /* sc_node_t */
+} sc_root_t;
+
+
+/* ************************************************** */
+/* ************************************************** */
+typedef struct _scenario {
+    char *base;                  /* sc_root_t, then records and strings */
+    int size;
+    int capacity;                /* 0 if base is mapped */
+    table_t table;
+} scenario_t;
+
+#define SC_ROOT(sc)          ((sc_root_t *) (sc)->base)
+#define SC_STRING(sc, off)   ((sc)->base + (off))     /* off is not SCENARIO_NONE */
+#define SC_LIST(sc, list, type) ((type *) ((sc)->base + (list).offset))
+
+
+/* ************************************************** */
+/* ************************************************** */
+/**
+ * \brief Start an empty scenario.
+ * \return 0 on success, -1 on error.
+ **/
+int scenario_create(scenario_t *sc);
+
+/**
+ * \brief Reserve size bytes in the scenario, 8 bytes aligned and zeroed. The
+ * block may move, offsets stay valid.
+ * \return the offset of the reserved bytes, -1 on error.
+ **/
+int32_t scenario_alloc(scenario_t *sc, int size);
+
+/**
+ * \brief Copy a string in the scenario.
+ * \return its offset, -1 on error.
+ **/
+int32_t scenario_string(scenario_t *sc, char *str);
+
+/**
+ * \brief Map a compiled scenario and check its consistency.
+ * \return 0 on success, 1 if file is not a compiled scenario, -1 on error.
+ **/
+int scenario_map(scenario_t *sc, char *file);
+
+/**
+ * \brief Write a scenario as a compiled scenario.
+ * \return 0 on success, -1 on error.
+ **/
+int scenario_write(scenario_t *sc, char *file);
+
+/**
+ * \brief Release a scenario, built or mapped.
+ **/
+void scenario_clean(scenario_t *sc);
+
+
+#endif //__scenario__
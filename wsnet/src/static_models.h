@@ -0,0 +1,34 @@
+/**
+ *  \file   static_models.h
+ *  \brief  Statically linked models declarations
+ *  \date   2026
+ **/
+#ifndef __static_models__
+#define __static_models__
+
+#include "entity.h"
+
+
+/* ************************************************** */
+/* ************************************************** */
+/* Models linked in wsnet-static are registered here instead of being
+ * loaded with g_module_open(). Their global symbols are prefixed by their
+ * library name (see static_models.sh), so that several models defining
+ * init, rx, tx, ... can live in one binary. */
+typedef struct _static_model {
+    char *name;                  /* library name, as in the configuration */
+    model_t *model;
+    methods_t *methods;
+    int (*init) (call_t *c, void *params);
+    int (*destroy) (call_t *c);
+    int (*bootstrap) (call_t *c);
+    int (*setnode) (call_t *c, void *params);
+    int (*unsetnode) (call_t *c);
+    int (*ioctl) (call_t *c, int option, void *in, void **out);
+} static_model_t;
+
+/* NULL terminated, generated by static_models.sh */
+extern static_model_t *static_models[];
+
+
+#endif //__static_models__
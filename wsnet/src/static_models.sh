@@ -0,0 +1,102 @@
+#!/bin/sh
+#
+# Builds the models linked in wsnet-static and their registration table.
+#
+# Every model defines init, model, methods, rx, tx, ... so each one is
+# compiled once to list its global symbols, then recompiled with all of
+# them prefixed by its library name and followed by a static_model_t
+# entry. static_models.c lists the entries.
+#
+# Example : static_models.sh static "gcc -O2 -flto -I.." mac_idealmac:idealmac.c
+#
+
+usage()
+{
+    echo "Script usage: "
+    echo "    "$1" output-directory compile-command library:source..."
+    echo ""
+    exit 1
+}
+
+if [ $# -lt 3 ]
+then
+    usage $0
+fi
+
+OUT=$1
+COMPILE=$2
+shift 2
+NM=${NM:-nm}
+ENTRY_POINTS="init destroy bootstrap setnode unsetnode ioctl"
+
+mkdir -p $OUT || exit 1
+TABLE=$OUT/static_models.c
+echo "/* generated by static_models.sh */"  > $TABLE.tmp
+echo "#include \"static_models.h\""        >> $TABLE.tmp
+echo ""                                    >> $TABLE.tmp
+
+for MODEL in "$@"
+do
+    LIB=${MODEL%%:*}
+    SRC=${MODEL#*:}
+    case $SRC in
+        /*) ;;
+        *) SRC=`pwd`/$SRC ;;
+    esac
+
+    # global symbols of the model
+    $COMPILE -fno-lto -c $SRC -o $OUT/$LIB.sym.o || exit 1
+    SYMBOLS=`$NM -P -g $OUT/$LIB.sym.o | awk '$2 != "U" && $2 != "w" && $2 != "v" { print $1 }'`
+    rm -f $OUT/$LIB.sym.o
+    case " "`echo $SYMBOLS`" " in
+        *" model "*) ;;
+        *) echo "static_models.sh: $SRC has no 'model' symbol"; exit 1 ;;
+    esac
+
+    # the model, renamed, and its entry
+    WRAPPER=$OUT/$LIB.c
+    echo "/* generated by static_models.sh from $SRC */" > $WRAPPER
+    for SYMBOL in $SYMBOLS
+    do
+        echo "#define $SYMBOL ${LIB}_$SYMBOL"       >> $WRAPPER
+    done
+    echo "#include \"$SRC\""                         >> $WRAPPER
+    for SYMBOL in $SYMBOLS
+    do
+        echo "#undef $SYMBOL"                        >> $WRAPPER
+    done
+    echo ""                                          >> $WRAPPER
+    echo "#include \"static_models.h\""              >> $WRAPPER
+    echo ""                                          >> $WRAPPER
+    echo "static_model_t ${LIB}_entry = {"           >> $WRAPPER
+    echo "    \"$LIB\","                             >> $WRAPPER
+    echo "    &${LIB}_model,"                        >> $WRAPPER
+    case " "`echo $SYMBOLS`" " in
+        *" methods "*) echo "    (methods_t *) &${LIB}_methods," >> $WRAPPER ;;
+        *) echo "    NULL,"                          >> $WRAPPER ;;
+    esac
+    for SYMBOL in $ENTRY_POINTS
+    do
+        case " "`echo $SYMBOLS`" " in
+            *" $SYMBOL "*) echo "    ${LIB}_$SYMBOL," >> $WRAPPER ;;
+            *) echo "    NULL,"                      >> $WRAPPER ;;
+        esac
+    done
+    echo "};"                                        >> $WRAPPER
+
+    $COMPILE -c $WRAPPER -o $OUT/$LIB.o || exit 1
+    echo "extern static_model_t ${LIB}_entry;"      >> $TABLE.tmp
+done
+
+echo ""                                          >> $TABLE.tmp
+echo "static_model_t *static_models[] = {"       >> $TABLE.tmp
+for MODEL in "$@"
+do
+    echo "    &${MODEL%%:*}_entry,"              >> $TABLE.tmp
+done
+echo "    NULL"                                  >> $TABLE.tmp
+echo "};"                                        >> $TABLE.tmp
+mv $TABLE.tmp $TABLE
+
+$COMPILE -c $TABLE -o $OUT/static_models.o || exit 1
+exit 0
@@ -23,11 +23,13 @@
 #include <libxml/xmlschemas.h>
 
 #include "internals.h"
+#include "scenario.h"
 
 
 /* ************************************************** */
 /* ************************************************** */
-#define DEFAULT_STRING     "0"
+#define DEFAULT_STRING       "0"
+#define DEFAULT_SCENARIOFILE "config.wsb"
 
 
 /* ************************************************** */
@@ -95,6 +97,7 @@ void config_set_configfile(char *c);
 void config_set_schemafile(char *s);
 void config_set_sys_modulesdir(char *c);
 int do_configuration(void);
+int do_compilation(char *outfile);
 
 
 /* ************************************************** */
@@ -109,6 +112,8 @@ typedef struct _dflt_param {
 extern void *dflt_params;
 
 void *get_entity_params(nodeid_t node, entityid_t entity, bundleid_t bundle);
+void *get_scenario_params(scenario_t *sc, sc_list_t *list);
+int add_dflt_params(scenario_t *sc, sc_default_t *dflt, bundleid_t bundle, nodeid_t node);
 
 
 /* ************************************************** */